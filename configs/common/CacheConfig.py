@@ -76,7 +76,9 @@ def config_cache(options, system):
         system.l2 = l2_cache_class(clk_domain=system.cpu_clk_domain,
                                    size=options.l2_size,
                                    assoc=options.l2_assoc,
-                                   is_dcache=True)
+                                   is_dcache=True,
+                                   share_block_data=options.share_block_data,
+                                   no_data=options.cache_no_data)
 
         system.tol2bus = L2XBar(clk_domain = system.cpu_clk_domain)
         system.l2.cpu_side = system.tol2bus.master
@@ -89,10 +91,14 @@ def config_cache(options, system):
         if options.caches:
             icache = icache_class(size=options.l1i_size,
                                   assoc=options.l1i_assoc,
-                                  is_dcache=False)
+                                  is_dcache=False,
+                                  share_block_data=options.share_block_data,
+                                  no_data=options.cache_no_data)
             dcache = dcache_class(size=options.l1d_size,
                                   assoc=options.l1d_assoc,
-                                  is_dcache=True)
+                                  is_dcache=True,
+                                  share_block_data=options.share_block_data,
+                                  no_data=options.cache_no_data)
 
             if options.memchecker:
                 dcache_mon = MemCheckerMonitor(warn_only=True)
@@ -85,6 +85,41 @@ def addCommonOptions(parser):
                       action="store_true",
                       help="Cache configuration for Cazorla's method")
 
+    parser.add_option("--mshr-partition",
+                      action="store_true",
+                      help="Reserve MSHRs per SMT thread and let the "
+                      "QoS controller resize the reservations")
+
+    parser.add_option("--pf-throttle",
+                      action="store_true",
+                      help="Attach stride prefetchers throttled per SMT "
+                      "thread and let the QoS controller cap the LPT")
+
+    parser.add_option("--fetch-policy", type="choice", default=None,
+                      choices=["RoundRobin", "Programmable", "ICount",
+                               "Stall", "Flush", "DCRA"],
+                      help="Override the SMT fetch policy of the O3 CPUs")
+
+    parser.add_option("--backend-partition",
+                      action="store_true",
+                      help="Give SMT threads quotas of physical registers, "
+                      "issue and commit width for the QoS controller to "
+                      "resize")
+
+    parser.add_option("--lpt-flush",
+                      action="store_true",
+                      help="Flush the LPT behind its loads missing in L2 "
+                      "and refetch after the miss returns")
+
+    parser.add_option("--runahead",
+                      action="store_true",
+                      help="Let the HPT run ahead during its L2 load misses")
+
+    parser.add_option("--dram-partition",
+                      action="store_true",
+                      help="Give each SMT thread its own DRAM banks "
+                      "by page coloring")
+
     parser.add_option("--checker", action="store_true");
     parser.add_option("-n", "--num-cpus", type="int", default=1)
     parser.add_option("--sys-voltage", action="store", type="string",
@@ -142,6 +177,12 @@ def addCommonOptions(parser):
     parser.add_option("--l2_assoc", type="int", default=8)
     parser.add_option("--l3_assoc", type="int", default=16)
     parser.add_option("--cacheline_size", type="int", default=64)
+    parser.add_option("--share-block-data", action="store_true",
+                      help="share block data between caches and packets "
+                      "copy-on-write instead of copying it at every level")
+    parser.add_option("--cache-no-data", action="store_true",
+                      help="timing-only caches without data arrays, "
+                      "accesses are satisfied from the backing store")
 
     # Enable Ruby
     parser.add_option("--ruby", action="store_true")
@@ -52,6 +52,9 @@ parser.add_option("--maxloads", metavar="N", default=100,
                   help="Stop after N loads")
 parser.add_option("-f", "--wakeup_freq", metavar="N", default=10,
                   help="Wakeup every N cycles")
+parser.add_option("--keep-cache-sizes", action="store_true",
+                  help="use the cache sizes given on the command line "
+                  "instead of tiny caches that provoke races")
 
 #
 # Add the ruby specific and protocol specific options
@@ -66,14 +69,15 @@ execfile(os.path.join(config_root, "common", "Options.py"))
 # Set the default cache size and associativity to be very small to encourage
 # races between requests and writebacks.
 #
-options.l1d_size="256B"
-options.l1i_size="256B"
-options.l2_size="512B"
-options.l3_size="1kB"
-options.l1d_assoc=2
-options.l1i_assoc=2
-options.l2_assoc=2
-options.l3_assoc=2
+if not options.keep_cache_sizes:
+    options.l1d_size="256B"
+    options.l1i_size="256B"
+    options.l2_size="512B"
+    options.l3_size="1kB"
+    options.l1d_assoc=2
+    options.l1i_assoc=2
+    options.l2_assoc=2
+    options.l3_assoc=2
 
 if args:
      print "Error: script doesn't take any positional arguments"
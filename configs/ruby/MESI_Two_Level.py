@@ -45,9 +45,13 @@ class L1Cache(RubyCache):
 #
 class L2Cache(RubyCache):
     latency = 15
+    cache_level = 2
 
 def define_options(parser):
-    return
+    parser.add_option("--ruby-way-partition", action="store_true",
+          help="partition the ways of each cache between two SMT threads")
+    parser.add_option("--ruby-shadow-tag-assoc", type="int", default=0,
+          help="assoc of the thread 0 shadow tags, 0 to disable")
 
 def create_system(options, full_system, system, dma_ports, ruby_system):
 
@@ -80,11 +84,17 @@ def create_system(options, full_system, system, dma_ports, ruby_system):
         l1i_cache = L1Cache(size = options.l1i_size,
                             assoc = options.l1i_assoc,
                             start_index_bit = block_size_bits,
-                            is_icache = True)
+                            is_icache = True,
+                            way_partition = options.ruby_way_partition,
+                            shadow_tag_assoc = options.ruby_shadow_tag_assoc,
+                            core_id = i)
         l1d_cache = L1Cache(size = options.l1d_size,
                             assoc = options.l1d_assoc,
                             start_index_bit = block_size_bits,
-                            is_icache = False)
+                            is_icache = False,
+                            way_partition = options.ruby_way_partition,
+                            shadow_tag_assoc = options.ruby_shadow_tag_assoc,
+                            core_id = i)
 
         prefetcher = RubyPrefetcher.Prefetcher()
 
@@ -129,7 +139,9 @@ def create_system(options, full_system, system, dma_ports, ruby_system):
         #
         l2_cache = L2Cache(size = options.l2_size,
                            assoc = options.l2_assoc,
-                           start_index_bit = l2_index_start)
+                           start_index_bit = l2_index_start,
+                           way_partition = options.ruby_way_partition,
+                           shadow_tag_assoc = options.ruby_shadow_tag_assoc)
 
         l2_cntrl = L2Cache_Controller(version = i,
                                       L2cache = l2_cache,
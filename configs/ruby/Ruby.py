@@ -58,6 +58,11 @@ def define_options(parser):
 
     parser.add_option("--access-backing-store", action="store_true", default=False,
                       help="Should ruby maintain a second copy of memory")
+    parser.add_option("--ruby-trace-warmup", action="store_true",
+                      default=False,
+                      help="Warm the caches on checkpoint restore by " \
+                           "replaying the cache trace instead of " \
+                           "installing the cache snapshot")
 
     # Options related to cache structure
     parser.add_option("--ports", action="store", type="int", default=4,
@@ -232,6 +237,7 @@ def create_system(options, full_system, system, piobus = None, dma_ports = []):
     ruby._cpu_ports = cpu_sequencers
     ruby.num_of_sequencers = len(cpu_sequencers)
     ruby.random_seed    = options.random_seed
+    ruby.direct_warmup  = not options.ruby_trace_warmup
 
     # Create a backing copy of physical memory in case required
     if options.access_backing_store:
@@ -4,7 +4,6 @@ def common_config(cpu, little_core):
     cpu.dumpWindowSize = 4*(10**6)
     cpu.policyWindowSize = (10**3)*20
     cpu.max_insts_hpt_thread = 200*(10**6)
-    cpu.PTAVQ = False
 
     if little_core:
         cpu.fetchWidth = 6
@@ -120,3 +119,63 @@ def cache_config_2(system, options):
         system.l2.tags.thread_0_assoc = 4 * dup
         system.l2.shadow_tag_assoc = 8
 
+    if options.mshr_partition:
+        mshr_partition_config(system)
+
+    if options.pf_throttle:
+        prefetch_throttle_config(system)
+
+    if options.dram_partition:
+        dram_partition_config(system)
+
+    if options.fetch_policy:
+        for cpu in system.cpu:
+            cpu.smtFetchPolicy = options.fetch_policy
+
+    if options.backend_partition:
+        for cpu in system.cpu:
+            cpu.smtRegPolicy = 'Programmable'
+            cpu.smtIssueWidthPolicy = 'Programmable'
+            cpu.smtCommitWidthPolicy = 'Programmable'
+
+    if options.lpt_flush:
+        for cpu in system.cpu:
+            cpu.lptLLFlush = True
+
+    if options.runahead:
+        for cpu in system.cpu:
+            cpu.runahead = True
+
+def prefetch_throttle_config(system):
+    for cpu in system.cpu:
+        cpu.dcache.prefetcher = StridePrefetcher(throttle = True)
+        cpu.dynPrefetch = True
+
+    system.l2.prefetcher = StridePrefetcher(throttle = True)
+
+def mshr_partition_config(system):
+    # Reserve half of the entries, split evenly with the HPT getting the
+    # odd one. The other half stays shared so that prefetches and bursts
+    # of either thread still find entries.
+    def even_split(n):
+        n = int(n) // 2
+        return [n - n // 2, n // 2]
+
+    for cpu in system.cpu:
+        cpu.icache.mshr_thread_reserve = even_split(cpu.icache.mshrs)
+        cpu.dcache.mshr_thread_reserve = even_split(cpu.dcache.mshrs)
+        cpu.dcache.write_buffer_thread_reserve = \
+            even_split(cpu.dcache.write_buffers)
+        cpu.dynMSHR = True
+
+    system.l2.mshr_thread_reserve = even_split(system.l2.mshrs)
+
+def dram_partition_config(system):
+    # one bank partition per hardware thread, the DRAM controllers
+    # export their bank/rank bits as page colors
+    workloads = system.cpu[0].workload
+    if not isinstance(workloads, list):
+        workloads = [workloads]
+    system.dram_partitions = len(workloads)
+    for i, process in enumerate(workloads):
+        process.dram_partition = i
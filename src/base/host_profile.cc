@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <vector>
+
+#include "base/callback.hh"
+#include "base/host_profile.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
+
+using namespace std;
+
+namespace HostProfile {
+
+bool enabled = false;
+
+namespace {
+
+vector<Timer *> &
+timers()
+{
+    static vector<Timer *> list;
+    return list;
+}
+
+Tick cyclePeriod = 0;
+
+/** Host timestamps and wall clock when profiling was enabled. */
+uint64_t startStamp;
+chrono::steady_clock::time_point startTime;
+
+string reportFile;
+
+class ReportCallback : public Callback
+{
+  public:
+    void
+    process()
+    {
+        ostream *os = simout.find(reportFile);
+        if (!os)
+            os = simout.create(reportFile);
+        report(*os);
+        os->flush();
+    }
+};
+
+} // anonymous namespace
+
+Timer::Timer(const char *_name)
+    : name(_name), elapsed(0), calls(0)
+{
+    timers().push_back(this);
+}
+
+void
+enable(const string &filename)
+{
+    if (enabled)
+        fatal("Host profiling is already enabled\n");
+
+    enabled = true;
+    startStamp = now();
+    startTime = chrono::steady_clock::now();
+
+    if (!filename.empty()) {
+        reportFile = filename;
+        registerExitCallback(new ReportCallback);
+    }
+}
+
+void
+setCyclePeriod(Tick period)
+{
+    if (!cyclePeriod)
+        cyclePeriod = period;
+}
+
+void
+report(ostream &os)
+{
+    chrono::duration<double, nano> wall =
+        chrono::steady_clock::now() - startTime;
+    uint64_t stamps = now() - startStamp;
+    double ns_per_stamp = stamps ? wall.count() / stamps : 0.0;
+    double cycles = cyclePeriod ? double(curTick()) / cyclePeriod : 0.0;
+
+    // Timers of template instances and inlined functions share names.
+    map<string, pair<uint64_t, uint64_t> > totals;
+    for (auto timer : timers()) {
+        pair<uint64_t, uint64_t> &total = totals[timer->name];
+        total.first += timer->elapsed;
+        total.second += timer->calls;
+    }
+
+    vector<pair<uint64_t, string> > order;
+    for (auto &total : totals)
+        order.push_back(make_pair(total.second.first, total.first));
+    sort(order.rbegin(), order.rend());
+
+    ios::fmtflags flags(os.flags());
+    os << fixed;
+    os << "# host time " << setprecision(3) << wall.count() / 1e9
+       << " s, " << setprecision(0) << cycles << " simulated cycles\n";
+    os << "# times include nested timers\n";
+    os << left << setw(24) << "# timer" << right
+       << setw(14) << "calls"
+       << setw(14) << "host_ms"
+       << setw(14) << "ns/call"
+       << setw(12) << "ns/cycle"
+       << setw(8) << "%host" << "\n";
+
+    for (auto &entry : order) {
+        uint64_t calls = totals[entry.second].second;
+        double ns = entry.first * ns_per_stamp;
+        os << left << setw(24) << entry.second << right
+           << setw(14) << calls
+           << setw(14) << setprecision(3) << ns / 1e6
+           << setw(14) << setprecision(1) << (calls ? ns / calls : 0.0)
+           << setw(12) << setprecision(3) << (cycles ? ns / cycles : 0.0)
+           << setw(8) << setprecision(2)
+           << (wall.count() ? 100.0 * ns / wall.count() : 0.0) << "\n";
+    }
+    os.flags(flags);
+}
+
+} // namespace HostProfile
@@ -0,0 +1,103 @@
+/**
+ * @file
+ * Host-side profiling of simulator hot paths.
+ *
+ * A HOST_PROFILE("name") statement at the top of a block charges the
+ * host time spent in the rest of the block to the timer of that name.
+ * Timers are read with rdtsc on x86 hosts and with the monotonic clock
+ * elsewhere, and cost a single test of a global flag while profiling
+ * is disabled. Times are inclusive, so a timer around the CPU tick
+ * also counts the stage timers nested inside it.
+ *
+ * When enabled with a file name (--host-profile), a report is written
+ * there at exit giving, per timer, the number of calls, the host time
+ * and the host nanoseconds per simulated cycle, with cycles taken from
+ * the clock passed to setCyclePeriod().
+ */
+
+#ifndef __BASE_HOST_PROFILE_HH__
+#define __BASE_HOST_PROFILE_HH__
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "base/types.hh"
+
+namespace HostProfile {
+
+/** Set while profiling; tested by every timed scope. */
+extern bool enabled;
+
+/** Host timestamp: TSC cycles on x86, nanoseconds otherwise. */
+inline uint64_t
+now()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/** Host time accumulated by one simulator component. */
+class Timer
+{
+  public:
+    const char *name;
+    uint64_t elapsed;
+    uint64_t calls;
+
+    /** Registers the timer; name must outlive the simulation. */
+    Timer(const char *name);
+};
+
+/** Charges the host time until it goes out of scope to a Timer. */
+class Scope
+{
+  private:
+    Timer &timer;
+    uint64_t start;
+
+  public:
+    Scope(Timer &_timer)
+        : timer(_timer), start(enabled ? now() : 0)
+    {}
+
+    ~Scope()
+    {
+        if (enabled && start) {
+            timer.elapsed += now() - start;
+            ++timer.calls;
+        }
+    }
+};
+
+/**
+ * Start profiling and write the report to the given file in the
+ * output directory at exit.
+ */
+void enable(const std::string &filename);
+
+/** Set the clock used to count simulated cycles; the first call wins. */
+void setCyclePeriod(Tick period);
+
+/** Write the report for the run so far. */
+void report(std::ostream &os);
+
+} // namespace HostProfile
+
+#define HOST_PROFILE_CONCAT2(a, b) a ## b
+#define HOST_PROFILE_CONCAT(a, b) HOST_PROFILE_CONCAT2(a, b)
+
+#define HOST_PROFILE(name)                                              \
+    static HostProfile::Timer HOST_PROFILE_CONCAT(_hpTimer, __LINE__)(name); \
+    HostProfile::Scope HOST_PROFILE_CONCAT(_hpScope, __LINE__)(          \
+        HOST_PROFILE_CONCAT(_hpTimer, __LINE__))
+
+#endif // __BASE_HOST_PROFILE_HH__
@@ -28,8 +28,13 @@
  * Authors: Nathan Binkert
  */
 
+#include <sys/resource.h>
 #include <unistd.h>
 
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
 #ifdef __APPLE__
 #include <mach/mach_init.h>
 #include <mach/shared_region.h>
@@ -118,3 +123,33 @@ memUsage()
     return procInfo("/proc/self/status", "VmSize:");
 #endif
 }
+
+uint64_t
+peakMemUsage()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    // Darwin reports bytes rather than kilobytes
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+uint64_t
+heapUsage()
+{
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#elif defined(__GLIBC__)
+    // The counters of the older interface wrap at 4GB.
+    struct mallinfo info = mallinfo();
+    return (unsigned)info.uordblks + (unsigned)info.hblkhd;
+#else
+    return 0;
+#endif
+}
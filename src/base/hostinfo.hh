@@ -48,4 +48,18 @@ uint64_t procInfo(const char *filename, const char *target);
  */
 uint64_t memUsage();
 
+/**
+ * Determine the peak resident set size of the simulator process.
+ *
+ * @return peak resident memory in kilobytes
+ */
+uint64_t peakMemUsage();
+
+/**
+ * Determine the bytes currently allocated from the C heap.
+ *
+ * @return heap bytes in use, or 0 if the host cannot tell
+ */
+uint64_t heapUsage();
+
 #endif // __HOSTINFO_HH__
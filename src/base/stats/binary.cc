@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "base/stats/binary.hh"
+#include "base/stats/info.hh"
+#include "base/misc.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
+
+using namespace std;
+
+namespace Stats {
+
+namespace {
+
+const char binaryMagic[8] = { 'g', 'e', 'm', '5', 's', 't', 'b', '\0' };
+const uint32_t binaryVersion = 1;
+
+/** Largest magnitude stored as an integral delta rather than a double. */
+const Result maxIntegral = 4503599627370496.0; // 2^52
+
+template <class T>
+void
+putLE(string &buf, T v, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+        buf.push_back(char((v >> (8 * i)) & 0xff));
+}
+
+string
+subname(const vector<string> &subnames, size_type i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    return to_string(i);
+}
+
+} // anonymous namespace
+
+Binary::Binary()
+    : stream(NULL), pos(0), schemaDirty(false)
+{
+}
+
+void
+Binary::open(std::ostream &_stream)
+{
+    if (stream)
+        panic("stream already set!");
+
+    stream = &_stream;
+    if (!valid())
+        fatal("Unable to open output stream for writing\n");
+
+    string header(binaryMagic, sizeof(binaryMagic));
+    putLE(header, binaryVersion, 4);
+    stream->write(header.data(), header.size());
+}
+
+bool
+Binary::valid() const
+{
+    return stream != NULL && stream->good();
+}
+
+void
+Binary::begin()
+{
+    pos = 0;
+    values.clear();
+}
+
+void
+Binary::end()
+{
+    if (pos != ids.size()) {
+        ids.resize(pos);
+        columnNames.resize(pos);
+        schemaDirty = true;
+    }
+
+    if (schemaDirty) {
+        writeSchema();
+        lastValues.assign(values.size(), 0.0);
+        schemaDirty = false;
+    }
+
+    writeDump();
+    lastValues.swap(values);
+    stream->flush();
+}
+
+bool
+Binary::noOutput(const Info &info)
+{
+    // Prerequisites are ignored so that the column set stays fixed
+    // across dumps; a zero prereq simply shows up as zero-valued
+    // columns.
+    return !info.flags.isSet(display);
+}
+
+bool
+Binary::needNames(const Info &info, size_type count) const
+{
+    return pos >= ids.size() || ids[pos] != info.id ||
+        columnNames[pos].size() != count;
+}
+
+void
+Binary::add(const Info &info, const vector<Result> &vals,
+            vector<string> *names)
+{
+    if (names) {
+        if (pos >= ids.size()) {
+            ids.resize(pos + 1);
+            columnNames.resize(pos + 1);
+        }
+        ids[pos] = info.id;
+        columnNames[pos].swap(*names);
+        schemaDirty = true;
+    }
+
+    values.insert(values.end(), vals.begin(), vals.end());
+    ++pos;
+}
+
+void
+Binary::addDist(const string &base, const DistData &data,
+                vector<Result> &vals, vector<string> *names)
+{
+    vals.push_back(data.samples);
+    vals.push_back(data.sum);
+    vals.push_back(data.squares);
+    if (names) {
+        names->push_back(base + "samples");
+        names->push_back(base + "sum");
+        names->push_back(base + "squares");
+    }
+
+    if (data.type == Deviation)
+        return;
+
+    vals.push_back(data.min_val);
+    vals.push_back(data.max_val);
+    vals.push_back(data.underflow);
+    vals.push_back(data.overflow);
+    if (names) {
+        names->push_back(base + "min_value");
+        names->push_back(base + "max_value");
+        names->push_back(base + "underflows");
+        names->push_back(base + "overflows");
+    }
+
+    for (size_type i = 0; i < data.cvec.size(); ++i) {
+        vals.push_back(data.cvec[i]);
+        if (names) {
+            Counter low = i * data.bucket_size + data.min;
+            Counter high = std::min(low + data.bucket_size - 1.0, data.max);
+            ostringstream name;
+            name << base << low;
+            if (low < high)
+                name << "-" << high;
+            names->push_back(name.str());
+        }
+    }
+}
+
+void
+Binary::visit(const ScalarInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    vector<Result> vals(1, info.result());
+    if (needNames(info, 1)) {
+        vector<string> names(1, info.name);
+        add(info, vals, &names);
+    } else {
+        add(info, vals, NULL);
+    }
+}
+
+void
+Binary::visit(const VectorInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    const VResult &vals = info.result();
+    if (needNames(info, vals.size())) {
+        vector<string> names;
+        for (size_type i = 0; i < vals.size(); ++i)
+            names.push_back(info.name + "::" + subname(info.subnames, i));
+        add(info, vals, &names);
+    } else {
+        add(info, vals, NULL);
+    }
+}
+
+void
+Binary::visit(const Vector2dInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    vector<Result> vals(info.cvec.begin(), info.cvec.end());
+    if (needNames(info, vals.size())) {
+        vector<string> names;
+        for (size_type x = 0; x < info.x; ++x) {
+            for (size_type y = 0; y < info.y; ++y) {
+                names.push_back(info.name + "::" +
+                                subname(info.subnames, x) + "::" +
+                                subname(info.y_subnames, y));
+            }
+        }
+        add(info, vals, &names);
+    } else {
+        add(info, vals, NULL);
+    }
+}
+
+void
+Binary::visit(const DistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    vector<Result> vals;
+    vector<string> names;
+    addDist("", info.data, vals, NULL);
+    if (needNames(info, vals.size())) {
+        vals.clear();
+        addDist(info.name + "::", info.data, vals, &names);
+        add(info, vals, &names);
+    } else {
+        add(info, vals, NULL);
+    }
+}
+
+void
+Binary::visit(const VectorDistInfo &info)
+{
+    if (noOutput(info))
+        return;
+
+    vector<Result> vals;
+    for (size_type i = 0; i < info.data.size(); ++i)
+        addDist("", info.data[i], vals, NULL);
+
+    if (needNames(info, vals.size())) {
+        vector<string> names;
+        vals.clear();
+        for (size_type i = 0; i < info.data.size(); ++i) {
+            addDist(info.name + "::" + subname(info.subnames, i) + "::",
+                    info.data[i], vals, &names);
+        }
+        add(info, vals, &names);
+    } else {
+        add(info, vals, NULL);
+    }
+}
+
+void
+Binary::visit(const FormulaInfo &info)
+{
+    visit((const VectorInfo &)info);
+}
+
+void
+Binary::visit(const SparseHistInfo &info)
+{
+    // Sparse histograms have no fixed set of buckets, so only the
+    // sample count is kept as a column.
+    if (noOutput(info))
+        return;
+
+    vector<Result> vals(1, info.data.samples);
+    if (needNames(info, 1)) {
+        vector<string> names(1, info.name + "::samples");
+        add(info, vals, &names);
+    } else {
+        add(info, vals, NULL);
+    }
+}
+
+void
+Binary::putVarint(uint64_t v)
+{
+    while (v >= 0x80) {
+        record.push_back(char((v & 0x7f) | 0x80));
+        v >>= 7;
+    }
+    record.push_back(char(v));
+}
+
+void
+Binary::writeRecord(char type)
+{
+    string header;
+    header.push_back(type);
+    putLE(header, uint64_t(curTick()), 8);
+    putLE(header, uint32_t(record.size()), 4);
+
+    stream->write(header.data(), header.size());
+    stream->write(record.data(), record.size());
+    record.clear();
+}
+
+void
+Binary::writeSchema()
+{
+    size_type count = 0;
+    for (size_type i = 0; i < columnNames.size(); ++i)
+        count += columnNames[i].size();
+
+    putVarint(count);
+    for (size_type i = 0; i < columnNames.size(); ++i) {
+        const vector<string> &names = columnNames[i];
+        for (size_type j = 0; j < names.size(); ++j) {
+            putVarint(names[j].size());
+            record.append(names[j]);
+        }
+    }
+
+    writeRecord('S');
+}
+
+void
+Binary::writeDump()
+{
+    assert(values.size() == lastValues.size());
+
+    uint64_t unchanged = 0;
+    for (size_type i = 0; i < values.size(); ++i) {
+        Result v = values[i];
+        Result last = lastValues[i];
+
+        if (v == last) {
+            ++unchanged;
+            continue;
+        }
+
+        if (unchanged) {
+            putVarint(((unchanged - 1) << 2) | 1);
+            unchanged = 0;
+        }
+
+        if (v == std::floor(v) && std::fabs(v) < maxIntegral &&
+            last == std::floor(last) && std::fabs(last) < maxIntegral) {
+            int64_t delta = int64_t(v) - int64_t(last);
+            uint64_t zigzag = (uint64_t(delta) << 1) ^ uint64_t(delta >> 63);
+            putVarint(zigzag << 2);
+        } else {
+            uint64_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            putVarint(2);
+            putLE(record, bits, 8);
+        }
+    }
+
+    if (unchanged)
+        putVarint(((unchanged - 1) << 2) | 1);
+
+    writeRecord('D');
+}
+
+Output *
+initBinary(const string &filename)
+{
+    static Binary binary;
+    static bool connected = false;
+
+    if (!connected) {
+        ostream *os = simout.find(filename);
+        if (!os)
+            os = simout.create(filename, true);
+
+        binary.open(*os);
+        connected = true;
+    }
+
+    return &binary;
+}
+
+} // namespace Stats
@@ -0,0 +1,107 @@
+/**
+ * @file
+ * Columnar binary statistics output.
+ *
+ * Every displayed stat is flattened into one or more columns of
+ * doubles. A schema record names the columns once, and each dump is
+ * then written as a single record holding all columns, delta-encoded
+ * against the previous dump. See util/stats_binary.py for a loader.
+ *
+ * File   := magic[8] version:u32 Record*
+ * Record := type:u8 tick:u64 length:u32 payload[length]
+ *
+ * A schema record ('S') holds varint(columns) followed by
+ * varint(length) name[length] per column. A dump record ('D') holds the
+ * columns in schema order, each starting with a varint v:
+ *   v & 3 == 0: integral value, zigzag(value - previous) == v >> 2
+ *   v & 3 == 1: (v >> 2) + 1 columns unchanged from the previous dump
+ *   v & 3 == 2: the value follows as a raw little-endian double
+ * The previous values are all zero after a schema record.
+ */
+
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+class Info;
+struct DistData;
+
+class Binary : public Output
+{
+  protected:
+    std::ostream *stream;
+
+    /** Values of the current dump, in column order. */
+    std::vector<Result> values;
+
+    /** Values of the previous dump. */
+    std::vector<Result> lastValues;
+
+    /** Id of the stat at each visit position of the last schema. */
+    std::vector<int> ids;
+
+    /** Column names of the stat at each visit position. */
+    std::vector<std::vector<std::string> > columnNames;
+
+    /** Visit position within the current dump. */
+    size_type pos;
+
+    /** Set when the columns differ from the last written schema. */
+    bool schemaDirty;
+
+    /** Encoded record being built. */
+    std::string record;
+
+  protected:
+    bool noOutput(const Info &info);
+
+    bool needNames(const Info &info, size_type count) const;
+
+    void add(const Info &info, const std::vector<Result> &vals,
+             std::vector<std::string> *names);
+
+    void addDist(const std::string &base, const DistData &data,
+                 std::vector<Result> &vals,
+                 std::vector<std::string> *names);
+
+    void putVarint(uint64_t v);
+
+    void writeRecord(char type);
+
+    void writeSchema();
+
+    void writeDump();
+
+  public:
+    Binary();
+
+    void open(std::ostream &stream);
+
+    // Implement Visit
+    virtual void visit(const ScalarInfo &info);
+    virtual void visit(const VectorInfo &info);
+    virtual void visit(const DistInfo &info);
+    virtual void visit(const VectorDistInfo &info);
+    virtual void visit(const Vector2dInfo &info);
+    virtual void visit(const FormulaInfo &info);
+    virtual void visit(const SparseHistInfo &info);
+
+    // Implement Output
+    virtual bool valid() const;
+    virtual void begin();
+    virtual void end();
+};
+
+Output *initBinary(const std::string &filename);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_BINARY_HH__
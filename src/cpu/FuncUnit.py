@@ -63,4 +63,6 @@ class FUDesc(SimObject):
     type = 'FUDesc'
     cxx_header = "cpu/func_unit.hh"
     count = Param.Int("number of these FU's available")
+    hptReserved = Param.Unsigned(0, "number of these FU's only the high "
+                                 "priority thread (thread 0) may use")
     opList = VectorParam.OpDesc("operation classes for this FU type")
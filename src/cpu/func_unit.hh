@@ -64,9 +64,11 @@ class FUDesc : public SimObject
   public:
     std::vector<OpDesc *> opDescList;
     unsigned         number;
+    unsigned         hptReserved;
 
     FUDesc(const FUDescParams *p)
-        : SimObject(p), opDescList(p->opList), number(p->count) {};
+        : SimObject(p), opDescList(p->opList), number(p->count),
+          hptReserved(p->hptReserved) {};
 };
 
 typedef std::vector<OpDesc *>::const_iterator OPDDiterator;
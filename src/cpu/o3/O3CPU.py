@@ -124,11 +124,20 @@ class DerivO3CPU(BaseCPU):
         _defaultNumPhysCCRegs = Self.numPhysIntRegs * 5
     numPhysCCRegs = Param.Unsigned(_defaultNumPhysCCRegs,
                                    "Number of physical cc registers")
+    smtRegPolicy = Param.String('Dynamic', "SMT integer and floating point "
+                                "register sharing policy")
+    bitmapFreeList = Param.Bool(False, "Keep free physical registers in a "
+                                "bitmap and hand out the lowest one first")
+    renameCheckpoints = Param.Unsigned(0, "Rename map checkpoints per "
+        "thread, taken at control instructions to undo squashes at once "
+        "(0 disables)")
 
     smtNumFetchingThreads = Param.Unsigned(1, "SMT Number of Fetching Threads")
 
     smtFetchPolicy = Param.String('Programmable', "SMT Fetch policy")
     #smtFetchPolicy = Param.String('RoundRobin', "SMT Fetch policy")
+    icountWeights = VectorParam.Unsigned([], "Per-thread weights of the "
+        "ICOUNT fetch key, larger fetches less (empty means all 1)")
 
     LQEntries = Param.Unsigned(32, "Number of load queue entries")
     SQEntries = Param.Unsigned(32, "Number of store queue entries")
@@ -137,6 +146,8 @@ class DerivO3CPU(BaseCPU):
     smtSQThreshold = Param.Int(0, "SMT LSQ Threshold Sharing Parameter")
 
     smtIssuePolicy  = Param.String('Nodiscrimination', "SMT Issue Policy")
+    smtIssueWidthPolicy = Param.String('Dynamic', "SMT issue width sharing "
+                                       "policy")
 
     numIQEntries = Param.Unsigned(64, "Number of instruction queue entries")
     smtIQPolicy    = Param.String('Dynamic', "SMT IQ Sharing Policy")
@@ -153,8 +164,15 @@ class DerivO3CPU(BaseCPU):
     hptIQPrivProp = Param.Float(0, "Initial dispatch width of HPT")
     hptLQPrivProp = Param.Float(0, "Initial dispatch width of HPT")
     hptSQPrivProp = Param.Float(0, "Initial dispatch width of HPT")
+    hptRegPrivProp = Param.Float(0.5, "Initial share of renamable "
+                                 "registers of HPT")
+    hptIssuePrivProp = Param.Float(0.5, "Initial share of issue width of HPT")
 
     smtCommitPolicy = Param.String('RoundRobin', "SMT Commit Policy")
+    smtCommitWidthPolicy = Param.String('Dynamic', "SMT commit width "
+                                        "sharing policy")
+    hptCommitPrivProp = Param.Float(0.5, "Initial share of commit width "
+                                    "of HPT")
 
     dumpWindowSize = Param.Int(100000, "stat dump cycle interval")
 
@@ -180,10 +198,17 @@ class DerivO3CPU(BaseCPU):
     l2Lat = Param.Int(20 + 20, "L2 cache hit + response latency")
 
     sampleLen = Param.Int(32, 'store Sample len')
-    PTAVQ = Param.Bool(True, "VQ strategy use PTA's or ours")
     considerHeadStatus = Param.Bool(False, "Consider status of head inst when judge miss/wait")
 
     dynCache = Param.Bool(False, "Whether control cache for QoS")
+    dynMSHR = Param.Bool(False, "Whether control MSHR reservations for QoS")
+    dynPrefetch = Param.Bool(False, "Whether throttle LPT prefetches for QoS")
+    lptLLFlush = Param.Bool(False, "Whether flush the LPT behind its loads "
+        "missing in L2 and refetch after the miss returns")
+    runahead = Param.Bool(False, "Whether the HPT runs ahead during its "
+        "L2 load misses")
+    runaheadMaxCycles = Param.Unsigned(2000, "Longest runahead episode "
+        "in cycles")
 
     numResourceToReserve = Param.Int(4, "number of resources to reserve at each end of policy window")
     numResourceToRelease = Param.Int(8, "number of resources to release at each end of policy window")
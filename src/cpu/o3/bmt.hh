@@ -7,6 +7,7 @@
 #include <cpu/inst_seq.hh>
 
 #include "config/the_isa.hh"
+#include "mem/cache/miss_table.hh"
 
 struct DerivO3CPUParams;
 
@@ -89,6 +90,13 @@ class BMT {
 
     bool isDep(DynInstPtr &inst);
 
+    // sequence number of the oldest unsquashed load of tid missing in
+    // the L2, 0 if there is none
+    InstSeqNum oldestLLLoad(ThreadID tid);
+
+    // whether unsquashed load seq of tid is still missing in the L2
+    bool isLLLoad(ThreadID tid, InstSeqNum seq);
+
     private:
 
     InstSeqNum start, end;
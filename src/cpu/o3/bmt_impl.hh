@@ -2,6 +2,7 @@
 #define __CPU_O3_BMT_IMPL_HH__
 
 
+#include "base/host_profile.hh"
 #include "cpu/o3/comm.hh"
 #include "debug/BMT.hh"
 #include "debug/LLM.hh"
@@ -34,6 +35,8 @@ void BMT<Impl>::addLL(DynInstPtr &inst)
     template<class Impl>
 bool BMT<Impl>::addInst(DynInstPtr &inst)
 {
+    HOST_PROFILE("o3.bmt");
+
     ThreadID tid = inst->threadNumber;
     auto &&it = table[tid].begin();
 
@@ -95,6 +98,8 @@ uint64_t BMT<Impl>::getDestRegs(DynInstPtr &inst)
     template<class Impl>
 bool BMT<Impl>::isDep(DynInstPtr &inst)
 {
+    HOST_PROFILE("o3.bmt");
+
     ThreadID tid = inst->threadNumber;
     auto &&it = table[tid].begin();
 
@@ -113,5 +118,17 @@ bool BMT<Impl>::isDep(DynInstPtr &inst)
     return false;
 }
 
+    template<class Impl>
+InstSeqNum BMT<Impl>::oldestLLLoad(ThreadID tid)
+{
+    return missTables.oldestLLLoad(tid);
+}
+
+    template<class Impl>
+bool BMT<Impl>::isLLLoad(ThreadID tid, InstSeqNum seq)
+{
+    const auto &loads = missTables.llLoads;
+    return tid >= 0 && tid < loads.size() && loads[tid].count(seq);
+}
 
 #endif  // __CPU_O3_BMT_IMPL_HH__
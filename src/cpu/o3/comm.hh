@@ -119,8 +119,6 @@ struct DefaultRenameDefaultIEW {
     float storeRate;
 
     std::array<SlotsUse, Impl::MaxWidth> slotPass;
-
-    bool incVROB[Impl::MaxThreads];
 };
 
 /** Struct that defines the information passed from IEW to commit. */
@@ -292,8 +290,6 @@ struct TimeBufStruct {
         unsigned busyROBEntries;
 
         DynInstPtr ROBHead;
-
-        float numVROB;
     };
 
     commitComm commitInfo[Impl::MaxThreads];
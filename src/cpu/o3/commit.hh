@@ -143,7 +143,8 @@ class DefaultCommit
     enum CommitPolicy {
         Aggressive,
         RoundRobin,
-        OldestReady
+        OldestReady,
+        HPTFirst
     };
 
   private:
@@ -299,6 +300,16 @@ class DefaultCommit
      */
     void squashAfter(ThreadID tid, DynInstPtr &head_inst);
 
+    /** Enters runahead mode when the head of the HPT is a load missing in
+     * the L2, and squashes back to that load once the miss returns.
+     */
+    void checkRunahead(ThreadID tid);
+
+    /** Squashes everything after the last committed instruction and
+     * refetches from the load runahead mode was entered at.
+     */
+    void squashFromRunahead(ThreadID tid);
+
     /** Handles processing an interrupt. */
     void handleInterrupt();
 
@@ -328,6 +339,28 @@ class DefaultCommit
     /** Returns the thread ID to use based on an oldest instruction policy. */
     ThreadID oldestReady();
 
+    /** Returns the HPT if its head is ready, the oldest ready thread
+     * otherwise. */
+    ThreadID hptFirst();
+
+    /** Whether the thread may commit more this cycle and has a ready
+     * head. */
+    bool canCommit(ThreadID tid);
+
+    /** Set the commit width of each thread from its share. */
+    void updateCommitWidths();
+
+  public:
+    /** Reassign the share of the commit width of each thread. */
+    void reassignCommitPortion(int newPortionVec[], int lenNewPortionVec,
+                               int newPortionDenominator);
+
+    int getHPTCommitPortion() const;
+
+    /** Commit slots each thread lost with a ready head, since the QoS
+     * controller last looked. */
+    std::array<uint64_t, Impl::MaxThreads> recentCommitStalls;
+
   public:
     /** Reads the PC of a specific thread. */
     TheISA::PCState pcState(ThreadID tid) { return pc[tid]; }
@@ -466,6 +499,22 @@ class DefaultCommit
     /** The sequence number of the last commited instruction. */
     InstSeqNum lastCommitedSeqNum[Impl::MaxThreads];
 
+    /** Whether the HPT runs ahead during its L2 load misses. */
+    bool runaheadEnabled;
+
+    /** Longest a runahead episode may last, in cycles. */
+    unsigned runaheadMaxCycles;
+
+    /** Whether each thread is in runahead mode. */
+    bool runahead[Impl::MaxThreads];
+
+    /** The load runahead mode was entered at, and where to refetch it. */
+    InstSeqNum runaheadLoadSeq[Impl::MaxThreads];
+    TheISA::PCState runaheadPC[Impl::MaxThreads];
+
+    /** Cycles spent in the current runahead episode. */
+    unsigned runaheadAge[Impl::MaxThreads];
+
     /** Records if there is a trap currently in flight. */
     bool trapInFlight[Impl::MaxThreads];
 
@@ -560,6 +609,13 @@ class DefaultCommit
 
     Stats::Vector noReadyCycles;
 
+    /** Stat for the number of times runahead mode was entered. */
+    Stats::Vector runaheadEpisodes;
+    /** Stat for the cycles spent in runahead mode. */
+    Stats::Vector runaheadCycles;
+    /** Stat for instructions pseudo-retired in runahead mode. */
+    Stats::Vector runaheadRetiredInsts;
+
   private:
     /** Set changedROBNumEntries[tid] to true, do global set if
      * rob->isDynamicPolicy() */
@@ -589,6 +645,11 @@ class DefaultCommit
         return rob->isProgrammablePolicy();
     }
 
+    bool isCommitPolicyProgrammable() const
+    {
+        return commitWidthPartitioned;
+    }
+
     void setFmt(Fmt *_fmt)
     {
         fmt = _fmt;
@@ -604,6 +665,24 @@ class DefaultCommit
     int numCompLoads;
 
     std::array<bool, Impl::MaxThreads> skipThisCycle;
+
+    /** Whether the commit width is split by commitPortion. */
+    bool commitWidthPartitioned;
+
+    /** Share of the commit width of each thread. */
+    int commitPortion[Impl::MaxThreads];
+
+    int commitDenominator;
+
+    /** Commit width of each thread. */
+    std::array<unsigned, Impl::MaxThreads> threadCommitWidths;
+
+    /** Instructions each thread committed this cycle. */
+    std::array<unsigned, Impl::MaxThreads> threadCommitted;
+
+    /** Stat for the commit slots a thread with a ready head lost to
+     * the commit width or its share of it. */
+    Stats::Vector commitStallSlots;
 };
 
 #endif // __CPU_O3_COMMIT_HH__
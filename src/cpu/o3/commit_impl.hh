@@ -51,6 +51,7 @@
 #include "arch/utility.hh"
 #include "base/loader/symtab.hh"
 #include "base/cp_annotate.hh"
+#include "base/host_profile.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
 #include "cpu/o3/commit.hh"
@@ -67,6 +68,7 @@
 #include "debug/BMT.hh"
 #include "debug/ExecFaulting.hh"
 #include "debug/O3PipeView.hh"
+#include "debug/ResourceAllocation.hh"
 #include "debug/ZTrace.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/faults.hh"
@@ -144,9 +146,43 @@ DefaultCommit<Impl>::DefaultCommit(O3CPU *_cpu, DerivO3CPUParams *params)
         commitPolicy = OldestReady;
 
         DPRINTF(Commit,"Commit Policy set to Oldest Ready.");
+    } else if (policy == "hptfirst"){
+        commitPolicy = HPTFirst;
+
+        DPRINTF(Commit,"Commit Policy set to HPT First.\n");
     } else {
         assert(0 && "Invalid SMT Commit Policy. Options Are: {Aggressive,"
-               "RoundRobin,OldestReady}");
+               "RoundRobin,OldestReady,HPTFirst}");
+    }
+
+    policy = params->smtCommitWidthPolicy;
+    std::transform(policy.begin(), policy.end(), policy.begin(),
+                   (int(*)(int)) tolower);
+
+    commitDenominator = 1024;
+    threadCommitWidths.fill(commitWidth);
+    threadCommitted.fill(0);
+    recentCommitStalls.fill(0);
+    if (policy == "dynamic") {
+        commitWidthPartitioned = false;
+        for (ThreadID tid = 0; tid < numThreads; tid++) {
+            commitPortion[tid] = commitDenominator / numThreads;
+        }
+    } else if (policy == "programmable") {
+        commitWidthPartitioned = true;
+        commitPortion[HPT] = numThreads > 1 ?
+            int(params->hptCommitPrivProp * commitDenominator) :
+            commitDenominator;
+        for (ThreadID tid = 0; tid < numThreads; tid++) {
+            if (tid != HPT) {
+                commitPortion[tid] = (commitDenominator - commitPortion[HPT]) /
+                    std::max(numThreads - 1, 1);
+            }
+        }
+        updateCommitWidths();
+    } else {
+        fatal("Invalid SMT commit width policy %s, options are: "
+              "Dynamic, Programmable\n", params->smtCommitWidthPolicy);
     }
 
     for (ThreadID tid = 0; tid < numThreads; tid++) {
@@ -160,8 +196,14 @@ DefaultCommit<Impl>::DefaultCommit(O3CPU *_cpu, DerivO3CPUParams *params)
         pc[tid].set(0);
         lastCommitedSeqNum[tid] = 0;
         squashAfterInst[tid] = NULL;
+        runahead[tid] = false;
+        runaheadLoadSeq[tid] = 0;
+        runaheadAge[tid] = 0;
     }
     interrupt = NoFault;
+
+    runaheadEnabled = params->runahead;
+    runaheadMaxCycles = params->runaheadMaxCycles;
 }
 
 template <class Impl>
@@ -195,6 +237,24 @@ DefaultCommit<Impl>::regStats()
               "communicate backwards")
         .prereq(commitNonSpecStalls);
 
+    runaheadEpisodes
+        .init(cpu->numThreads)
+        .name(name() + ".runaheadEpisodes")
+        .desc("The number of times runahead mode was entered")
+        ;
+
+    runaheadCycles
+        .init(cpu->numThreads)
+        .name(name() + ".runaheadCycles")
+        .desc("The number of cycles spent in runahead mode")
+        ;
+
+    runaheadRetiredInsts
+        .init(cpu->numThreads)
+        .name(name() + ".runaheadRetiredInsts")
+        .desc("The number of instructions pseudo-retired in runahead mode")
+        ;
+
     branchMispredicts
         .init(cpu->numThreads)
         .name(name() + ".branchMispredicts")
@@ -379,6 +439,13 @@ DefaultCommit<Impl>::regStats()
         .desc("Number of weighted cycles none of threads have ready head.")
         ;
 
+    commitStallSlots
+        .init(cpu->numThreads)
+        .name(name() + ".commitStallSlots")
+        .desc("Number of commit slots lost by threads with a ready head")
+        .flags(total)
+        ;
+
 }
 
 template <class Impl>
@@ -745,10 +812,97 @@ DefaultCommit<Impl>::squashAfter(ThreadID tid, DynInstPtr &head_inst)
     squashAfterInst[tid] = head_inst;
 }
 
+template <class Impl>
+void
+DefaultCommit<Impl>::checkRunahead(ThreadID tid)
+{
+    if (runahead[tid]) {
+        ++runaheadCycles[tid];
+
+        if (!bmt->isLLLoad(tid, runaheadLoadSeq[tid]) ||
+            ++runaheadAge[tid] > runaheadMaxCycles) {
+            squashFromRunahead(tid);
+            return;
+        }
+
+        // Loads missing in the L2 during runahead do not hold it up.
+        if (commitStatus[tid] == Running && !rob->isEmpty(tid)) {
+            DynInstPtr head_inst = rob->readHeadInst(tid);
+            if (!head_inst->readyToCommit() && head_inst->isLoad() &&
+                bmt->isLLLoad(tid, head_inst->seqNum)) {
+                iewStage->runaheadInvalidate(head_inst);
+            }
+        }
+        return;
+    }
+
+    if (commitStatus[tid] != Running || rob->isEmpty(tid) ||
+        drainPending || interrupt != NoFault) {
+        return;
+    }
+
+    DynInstPtr head_inst = rob->readHeadInst(tid);
+
+    if (head_inst->readyToCommit() || !head_inst->isLoad() ||
+        head_inst->isMicroop() || !bmt->isLLLoad(tid, head_inst->seqNum)) {
+        return;
+    }
+
+    DPRINTF(Commit, "[tid:%i]: Entering runahead at L2 miss [sn:%lli] "
+            "PC %s\n", tid, head_inst->seqNum, head_inst->pcState());
+
+    // Nothing commits until the miss returns, so the committed rename map
+    // and the registers it maps stay intact; the rename history buffer
+    // restores the speculative map on the squash back to the load.
+    runahead[tid] = true;
+    runaheadLoadSeq[tid] = head_inst->seqNum;
+    runaheadPC[tid] = head_inst->pcState();
+    runaheadAge[tid] = 0;
+    ++runaheadEpisodes[tid];
+
+    iewStage->enterRunahead(tid);
+    iewStage->runaheadInvalidate(head_inst);
+}
+
+template <class Impl>
+void
+DefaultCommit<Impl>::squashFromRunahead(ThreadID tid)
+{
+    DPRINTF(Commit, "[tid:%i]: Exiting runahead, restarting at PC %s\n",
+            tid, runaheadPC[tid]);
+
+    InstSeqNum squashed_inst = runaheadLoadSeq[tid] - 1;
+
+    youngestSeqNum[tid] = squashed_inst;
+
+    rob->squash(squashed_inst, tid);
+    markROBNumEntriesChanged(tid);
+
+    toIEW->commitInfo[tid].doneSeqNum = squashed_inst;
+    toIEW->commitInfo[tid].squash = true;
+    toIEW->commitInfo[tid].robSquashing = true;
+    toIEW->commitInfo[tid].mispredictInst = NULL;
+    toIEW->commitInfo[tid].squashInst = NULL;
+
+    pc[tid] = runaheadPC[tid];
+    toIEW->commitInfo[tid].pc = pc[tid];
+
+    commitStatus[tid] = ROBSquashing;
+    cpu->activityThisCycle();
+
+    runahead[tid] = false;
+    iewStage->exitRunahead(tid);
+
+    // Slots spent after the load were spent on thrown away work.
+    fmt->squashAfter(tid, runaheadLoadSeq[tid]);
+}
+
 template <class Impl>
 void
 DefaultCommit<Impl>::tick()
 {
+    HOST_PROFILE("o3.commit");
+
     wroteToTimeBuffer = false;
     _nextStatus = Inactive;
 
@@ -937,10 +1091,6 @@ DefaultCommit<Impl>::commit()
 
     while (threads != end) {
         ThreadID tid = *threads++;
-        if (fromRename->incVROB[tid]) {
-            changedROBNumEntries[tid] = true;
-            rob->incVROB(tid, renameWidth);
-        }
 
         // Not sure which one takes priority.  I think if we have
         // both, that's a bad sign.
@@ -1021,6 +1171,10 @@ DefaultCommit<Impl>::commit()
             toIEW->commitInfo[tid].pc = fromIEW->pc[tid];
         }
 
+        if (runaheadEnabled && tid == HPT) {
+            checkRunahead(tid);
+        }
+
         if (commitStatus[tid] == ROBSquashing) {
             num_squashing_threads++;
         }
@@ -1053,7 +1207,6 @@ DefaultCommit<Impl>::commit()
             toIEW->commitInfo[tid].busyROBEntries = rob->numBusyEntries(tid);
 
             toIEW->commitInfo[tid].ROBHead = rob->readHeadInst(tid);
-            toIEW->commitInfo[tid].numVROB = rob->VROB[tid];
 
             wroteToTimeBuffer = true;
             changedROBNumEntries[tid] = false;
@@ -1099,6 +1252,7 @@ DefaultCommit<Impl>::commitInsts()
     DPRINTF(Commit, "Trying to commit instructions in the ROB.\n");
 
     unsigned num_committed = 0;
+    threadCommitted.fill(0);
 
     DynInstPtr head_inst;
 
@@ -1137,6 +1291,30 @@ DefaultCommit<Impl>::commitInsts()
         DPRINTF(Commit, "Trying to commit head instruction, [sn:%i] [tid:%i]\n",
                 head_inst->seqNum, tid);
 
+        if (runahead[tid]) {
+            // Runahead results are thrown away on exit, so the head only
+            // leaves the ROB. Non-speculative instructions wait for the
+            // miss to return.
+            if (!head_inst->isSquashed() && !head_inst->isExecuted()) {
+                break;
+            }
+
+            if (!head_inst->isSquashed() && head_inst->getFault() != NoFault) {
+                iewStage->runaheadInvalidate(head_inst);
+            }
+
+            DPRINTF(Commit, "Pseudo-retiring [sn:%i] in runahead.\n",
+                    head_inst->seqNum);
+
+            rob->retireHead(commit_thread);
+            ++num_committed;
+            ++threadCommitted[tid];
+            ++runaheadRetiredInsts[tid];
+            markROBNumEntriesChanged(tid);
+
+            continue;
+        }
+
         // If the head instruction is squashed, it is ready to retire
         // (be removed from the ROB) at any time.
         if (head_inst->isSquashed()) {
@@ -1176,6 +1354,7 @@ DefaultCommit<Impl>::commitInsts()
                 }
 
                 ++num_committed;
+                ++threadCommitted[tid];
                 statCommittedInstType[tid][head_inst->opClass()]++;
                 ppCommit->notify(head_inst);
                 markROBNumEntriesChanged(tid);
@@ -1271,6 +1450,24 @@ DefaultCommit<Impl>::commitInsts()
     DPRINTF(CommitRate, "%i\n", num_committed);
     numCommittedDist.sample(num_committed);
 
+    if (numThreads > 1) {
+        // A thread whose head is still ready could have committed up to
+        // the full width running alone.
+        for (ThreadID tid = 0; tid < numThreads; tid++) {
+            if (commitStatus[tid] != Running &&
+                commitStatus[tid] != Idle &&
+                commitStatus[tid] != FetchTrapPending) {
+                continue;
+            }
+            if (skipThisCycle[tid] || !rob->isHeadReady(tid)) {
+                continue;
+            }
+            unsigned lost = commitWidth - threadCommitted[tid];
+            commitStallSlots[tid] += lost;
+            recentCommitStalls[tid] += lost;
+        }
+    }
+
     if (num_committed == commitWidth) {
         commitEligibleSamples++;
     }
@@ -1649,6 +1846,9 @@ DefaultCommit<Impl>::getCommittingThread()
           case OldestReady:
             return oldestReady();
 
+          case HPTFirst:
+            return hptFirst();
+
           default:
             return InvalidThreadID;
         }
@@ -1680,7 +1880,7 @@ DefaultCommit<Impl>::roundRobin()
             commitStatus[tid] == Idle ||
             commitStatus[tid] == FetchTrapPending) {
 
-            if (rob->isHeadReady(tid) && !skipThisCycle[tid]) {
+            if (canCommit(tid)) {
                 priority_list.erase(pri_iter);
                 priority_list.push_back(tid);
 
@@ -1712,7 +1912,8 @@ DefaultCommit<Impl>::oldestReady()
              commitStatus[tid] == Idle ||
              commitStatus[tid] == FetchTrapPending)) {
 
-            if (rob->isHeadReady(tid)) {
+            if (rob->isHeadReady(tid) &&
+                threadCommitted[tid] < threadCommitWidths[tid]) {
 
                 DynInstPtr head_inst = rob->readHeadInst(tid);
 
@@ -1733,5 +1934,83 @@ DefaultCommit<Impl>::oldestReady()
     }
 }
 
+template<class Impl>
+ThreadID
+DefaultCommit<Impl>::hptFirst()
+{
+    if (!rob->isEmpty(HPT) &&
+        (commitStatus[HPT] == Running ||
+         commitStatus[HPT] == Idle ||
+         commitStatus[HPT] == FetchTrapPending) &&
+        canCommit(HPT)) {
+        return HPT;
+    }
+
+    list<ThreadID>::iterator threads = activeThreads->begin();
+    list<ThreadID>::iterator end = activeThreads->end();
+
+    while (threads != end) {
+        ThreadID tid = *threads++;
+
+        if (tid != HPT && !rob->isEmpty(tid) &&
+            (commitStatus[tid] == Running ||
+             commitStatus[tid] == Idle ||
+             commitStatus[tid] == FetchTrapPending) &&
+            canCommit(tid)) {
+            return tid;
+        }
+    }
+
+    return InvalidThreadID;
+}
+
+template<class Impl>
+bool
+DefaultCommit<Impl>::canCommit(ThreadID tid)
+{
+    return rob->isHeadReady(tid) && !skipThisCycle[tid] &&
+        threadCommitted[tid] < threadCommitWidths[tid];
+}
+
+template <class Impl>
+void
+DefaultCommit<Impl>::reassignCommitPortion(int newPortionVec[],
+        int lenNewPortionVec, int newPortionDenominator)
+{
+    if (!commitWidthPartitioned) {
+        return;
+    }
+
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        DPRINTF(ResourceAllocation, "Thread [%i] commit width portion: %i\n",
+                tid, newPortionVec[tid]);
+        commitPortion[tid] = newPortionVec[tid];
+    }
+    commitDenominator = newPortionDenominator;
+
+    updateCommitWidths();
+}
+
+template <class Impl>
+int
+DefaultCommit<Impl>::getHPTCommitPortion() const
+{
+    return commitPortion[HPT];
+}
+
+template <class Impl>
+void
+DefaultCommit<Impl>::updateCommitWidths()
+{
+    // Every thread keeps at least one slot so that it cannot be starved
+    // of commit altogether.
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        threadCommitWidths[tid] = std::max(
+            commitWidth * commitPortion[tid] / commitDenominator, 1u);
+        DPRINTF(Commit, "Thread [%i] commit width: %i\n", tid,
+                threadCommitWidths[tid]);
+    }
+}
+
 
 #endif//__CPU_O3_COMMIT_IMPL_HH__
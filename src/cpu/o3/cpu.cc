@@ -45,6 +45,7 @@
  */
 
 #include "arch/kernel_stats.hh"
+#include "base/host_profile.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
 #include "cpu/checker/thread_context.hh"
@@ -73,6 +74,7 @@
 #include "sim/system.hh"
 #include "sim/async.hh"
 #include "sim/eventq.hh"
+#include "mem/cache/miss_table.hh"
 #include "mem/cache/tags/control_panel.hh"
 
 #if THE_ISA == ALPHA_ISA
@@ -184,12 +186,13 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
 
       fmt(this, params),
       bmt(this, params),
+      soloWindow(this, params),
 
       regFile(params->numPhysIntRegs,
               params->numPhysFloatRegs,
               params->numPhysCCRegs),
 
-      freeList(name() + ".freelist", &regFile),
+      freeList(name() + ".freelist", &regFile, params->bitmapFreeList),
 
       rob(this, params),
 
@@ -230,6 +233,8 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
       numResourceToReserve(params->numResourceToReserve),
       numResourceToRelease(params->numResourceToRelease),
       dynCache(params->dynCache),
+      dynMSHR(params->dynMSHR),
+      dynPrefetch(params->dynPrefetch),
       cazorlaPhase(CazorlaPhase::NotStarted),
       subTuningPhaseNumber(0),
       numPreSampleCycles(50000),
@@ -307,10 +312,16 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
     iew.setFmt(&fmt);
     commit.setFmt(&fmt);
 
+    HostProfile::setCyclePeriod(clockPeriod());
+
+    fetch.setBmt(&bmt);
     rename.setBmt(&bmt);
     iew.setBmt(&bmt);
     commit.setBmt(&bmt);
 
+    rename.setSoloWindow(&soloWindow);
+    iew.setSoloWindow(&soloWindow);
+
     ThreadID active_threads;
     if (FullSystem) {
         active_threads = 1;
@@ -357,11 +368,6 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
             // Note that we can't use the rename() method because we don't
             // want special treatment for the zero register at this point
             PhysRegIndex phys_reg = freeList.getIntReg();
-            // FIXME Ugly exposure. Due to the assignment, the free reg
-            // counter per thread has to be substracted to keep the
-            // consistency.
-            rename.nrFreeRegs[tid]--;
-
             renameMap[tid].setIntEntry(ridx, phys_reg);
             commitRenameMap[tid].setIntEntry(ridx, phys_reg);
         }
@@ -579,6 +585,7 @@ FullO3CPU<Impl>::regStats()
     this->commit.regStats();
     this->rob.regStats();
     this->fmt.regStats();
+    this->soloWindow.regStats();
 
     intRegfileReads
         .name(name() + ".int_regfile_reads")
@@ -655,6 +662,8 @@ FullO3CPU<Impl>::tick()
     assert(!switchedOut());
     assert(getDrainState() != Drainable::Drained);
 
+    HOST_PROFILE("o3.tick");
+
     DPRINTFR(FMT,"Tick-----------------------------------\n");
     ++numCycles;
     ++localCycles;
@@ -1343,6 +1352,7 @@ FullO3CPU<Impl>::takeOverFrom(BaseCPU *oldCPU)
     rename.takeOverFrom();
     iew.takeOverFrom();
     commit.takeOverFrom();
+    soloWindow.reset();
 
     assert(!tickEvent.scheduled());
 
@@ -1988,6 +1998,54 @@ FullO3CPU<Impl>::allocSQ(bool incHPT)
     }
 }
 
+template <class Impl>
+void
+FullO3CPU<Impl>::allocRegs(bool incHPT)
+{
+    int vec[2];
+    int delta = incHPT ? grain : -grain;
+    vec[HPT] = rename.getHPTRegPortion() + delta;
+    portionRangeCheck;
+
+    if (vec[HPT] != rename.getHPTRegPortion()) {
+        DPRINTF(QoSCtrl, "%s [Reg], vec[0]: %d, vec[1]: %d\n",
+                incHPT ? "Reserving":"Releasing", vec[0], vec[1]);
+        rename.reassignRegPortion(vec, 2, 1024);
+    }
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::allocIssue(bool incHPT)
+{
+    int vec[2];
+    int delta = incHPT ? grain : -grain;
+    vec[HPT] = iew.instQueue.getHPTIssuePortion() + delta;
+    portionRangeCheck;
+
+    if (vec[HPT] != iew.instQueue.getHPTIssuePortion()) {
+        DPRINTF(QoSCtrl, "%s [Issue], vec[0]: %d, vec[1]: %d\n",
+                incHPT ? "Reserving":"Releasing", vec[0], vec[1]);
+        iew.instQueue.reassignIssuePortion(vec, 2, 1024);
+    }
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::allocCommit(bool incHPT)
+{
+    int vec[2];
+    int delta = incHPT ? grain : -grain;
+    vec[HPT] = commit.getHPTCommitPortion() + delta;
+    portionRangeCheck;
+
+    if (vec[HPT] != commit.getHPTCommitPortion()) {
+        DPRINTF(QoSCtrl, "%s [Commit], vec[0]: %d, vec[1]: %d\n",
+                incHPT ? "Reserving":"Releasing", vec[0], vec[1]);
+        commit.reassignCommitPortion(vec, 2, 1024);
+    }
+}
+
 #undef portionRangeCheck
 
 template <class Impl>
@@ -2015,11 +2073,71 @@ FullO3CPU<Impl>::allocCache(int cacheLevel, bool DCache, bool incHPT)
     int newHPTAssoc = min(max(HPTAssoc + delta, 1), wayRationConfig->assoc - 1);
     if (newHPTAssoc != HPTAssoc) {
         wayRationConfig->updatedByCore = true;
+        wayRationConfig->version++;
         wayRationConfig->threadWayRations[HPT] = newHPTAssoc;
         wayRationConfig->threadWayRations[LPT] = wayRationConfig->assoc - newHPTAssoc;
     }
 }
 
+template <class Impl>
+void
+FullO3CPU<Impl>::allocMSHR(int cacheLevel, bool DCache, bool incHPT)
+{
+    MSHRRationConfig *mshrRationConfig = nullptr;
+    if (cacheLevel == 2) {
+        mshrRationConfig = &controlPanel.l2MSHRConfig;
+    } else if (cacheLevel == 1) {
+        if (DCache) {
+            mshrRationConfig = &controlPanel.l1DMSHRConfig;
+        } else {
+            mshrRationConfig = &controlPanel.l1IMSHRConfig;
+        }
+    } else {
+        panic("Unknown cache level: %i\n", cacheLevel);
+    }
+
+    using namespace std;
+
+    // Cache not present
+    if (mshrRationConfig->numEntries < 2) {
+        return;
+    }
+
+    int delta = incHPT ? 1 : -1;
+    int HPTReserve = mshrRationConfig->threadReserves[HPT];
+    if (HPTReserve + mshrRationConfig->threadReserves[LPT] == 0) {
+        // Start from an even split if the cache was not partitioned
+        HPTReserve = mshrRationConfig->numEntries / 2;
+    }
+    int newHPTReserve = min(max(HPTReserve + delta, 1),
+                            mshrRationConfig->numEntries - 1);
+    if (newHPTReserve != HPTReserve) {
+        DPRINTF(QoSCtrl, "%s [L%i MSHR], HPT: %d, LPT: %d\n",
+                incHPT ? "Reserving":"Releasing", cacheLevel, newHPTReserve,
+                mshrRationConfig->numEntries - newHPTReserve);
+        reConfigOneMSHR(*mshrRationConfig, newHPTReserve);
+    }
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::allocPrefetch(bool incHPT)
+{
+    // Only the LPT is throttled, the HPT keeps its full prefetch quota
+    PrefetchThrottleConfig &config = controlPanel.prefetchConfig;
+    int delta = incHPT ? -grain : grain;
+    int LPTQuota = std::min(std::max(config.threadQuotas[LPT] + delta, 0),
+                            1024);
+
+    if (LPTQuota != config.threadQuotas[LPT]) {
+        DPRINTF(QoSCtrl, "%s [Prefetch], LPT quota: %d\n",
+                incHPT ? "Reserving":"Releasing", LPTQuota);
+        config.threadQuotas[HPT] = 1024;
+        config.threadQuotas[LPT] = LPTQuota;
+        config.version++;
+    }
+}
+
 template <class Impl>
 void
 FullO3CPU<Impl>::sortContention() {
@@ -2036,11 +2154,28 @@ FullO3CPU<Impl>::sortContention() {
     contNums[Contention::IQCont] = iew.recentSlots[SlotsUse::IQWait];
     contNums[Contention::LQCont] = iew.recentSlots[SlotsUse::LQWait];
     contNums[Contention::SQCont] = iew.recentSlots[SlotsUse::SQWait];
-
-    contNums[Contention::L1DCacheCont] = iew.recentSlots[SlotsUse::L1DCacheInterference];
-    contNums[Contention::L1ICacheCont] = iew.recentSlots[SlotsUse::L1ICacheInterference];
+    contNums[Contention::RegCont] = iew.recentSlots[SlotsUse::RegWait];
+    contNums[Contention::IssueCont] = iew.recentSlots[SlotsUse::IssueWait];
+    contNums[Contention::CommitCont] = commit.recentCommitStalls[HPT];
+
+    // Ruby caches report interference through their shadow tags
+    contNums[Contention::L1DCacheCont] = iew.recentSlots[SlotsUse::L1DCacheInterference]
+                                         + controlPanel.l1DCacheWayConfig.recentShadowHits;
+    contNums[Contention::L1ICacheCont] = iew.recentSlots[SlotsUse::L1ICacheInterference]
+                                         + controlPanel.l1ICacheWayConfig.recentShadowHits;
     contNums[Contention::L2CacheCont] = iew.recentSlots[SlotsUse::L2DCacheInterference]
-                                        + iew.recentSlots[SlotsUse::L2ICacheInterference];
+                                        + iew.recentSlots[SlotsUse::L2ICacheInterference]
+                                        + controlPanel.l2CacheWayConfig.recentShadowHits;
+
+    // A cycle in which the HPT had a memory reference rejected costs it
+    // the whole dispatch width
+    contNums[Contention::MSHRCont] =
+        missTables.recentMSHRRejects[HPT] * iew.dispatchWidth;
+
+    // Useless LPT prefetches pollute the caches and take bandwidth, each
+    // one is weighed like a cycle of rejected HPT memory references
+    contNums[Contention::PrefetchCont] =
+        controlPanel.prefetchConfig.recentUseless[LPT] * iew.dispatchWidth;
     //</editor-fold>
 
     std::sort(contIndices.begin(), contIndices.end(),
@@ -2051,6 +2186,14 @@ FullO3CPU<Impl>::sortContention() {
     }
 
     iew.clearRecent();
+    std::fill(missTables.recentMSHRRejects.begin(),
+              missTables.recentMSHRRejects.end(), 0);
+    commit.recentCommitStalls.fill(0);
+    controlPanel.l1ICacheWayConfig.recentShadowHits = 0;
+    controlPanel.l1DCacheWayConfig.recentShadowHits = 0;
+    controlPanel.l2CacheWayConfig.recentShadowHits = 0;
+    std::fill(std::begin(controlPanel.prefetchConfig.recentUseless),
+              std::end(controlPanel.prefetchConfig.recentUseless), 0);
 }
 
 template <class Impl>
@@ -2131,6 +2274,31 @@ FullO3CPU<Impl>::adjustRoute(Contention contention, bool incHPT)
             if (controlPolicy == ControlPolicy::FrontEnd) return 0;
             allocSQ(incHPT);
             break;
+        case Contention::RegCont:
+            if (controlPolicy == ControlPolicy::FrontEnd) return 0;
+            if (!rename.isRegPolicyProgrammable()) return 0;
+            allocRegs(incHPT);
+            break;
+        case Contention::IssueCont:
+            if (controlPolicy == ControlPolicy::FrontEnd) return 0;
+            if (!iew.instQueue.isIssuePolicyProgrammable()) return 0;
+            allocIssue(incHPT);
+            break;
+        case Contention::CommitCont:
+            if (controlPolicy == ControlPolicy::FrontEnd) return 0;
+            if (!commit.isCommitPolicyProgrammable()) return 0;
+            allocCommit(incHPT);
+            break;
+        case Contention::MSHRCont:
+            if (!dynMSHR) return 0;
+            allocMSHR(1, true, incHPT);
+            allocMSHR(1, false, incHPT);
+            allocMSHR(2, true, incHPT);
+            break;
+        case Contention::PrefetchCont:
+            if (!dynPrefetch) return 0;
+            allocPrefetch(incHPT);
+            break;
         default:
             panic("Unexpected type of contention!\n");
 
@@ -2298,6 +2466,36 @@ FullO3CPU<Impl>::assignSQ(int quota)
     iew.ldstQueue.reassignSQPortion(cazorlaVec, 2, 1024);
 }
 
+template <class Impl>
+void
+FullO3CPU<Impl>::assignRegs(int quota)
+{
+    DPRINTF(Cazorla, "Allocate %d registers to HPT\n", quota);
+    cazorlaVec[0] = quota;
+    cazorlaVec[1] = 1024 - quota;
+    rename.reassignRegPortion(cazorlaVec, 2, 1024);
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::assignIssue(int quota)
+{
+    DPRINTF(Cazorla, "Allocate %d issue width to HPT\n", quota);
+    cazorlaVec[0] = quota;
+    cazorlaVec[1] = 1024 - quota;
+    iew.instQueue.reassignIssuePortion(cazorlaVec, 2, 1024);
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::assignCommit(int quota)
+{
+    DPRINTF(Cazorla, "Allocate %d commit width to HPT\n", quota);
+    cazorlaVec[0] = quota;
+    cazorlaVec[1] = 1024 - quota;
+    commit.reassignCommitPortion(cazorlaVec, 2, 1024);
+}
+
 template <class Impl>
 void
 FullO3CPU<Impl>::assignL2Cache(int quota)
@@ -2332,6 +2530,59 @@ FullO3CPU<Impl>::reConfigOneCache(
             wayRationConfig.assoc - HPTAssoc;
 
     wayRationConfig.updatedByCore = true;
+    wayRationConfig.version++;
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::assignMSHR(int quota)
+{
+    if (!dynMSHR) {
+        return;
+    }
+
+    DPRINTF(Cazorla, "Allocate %d MSHR to HPT\n", quota);
+
+    // NOTE that LPT should keep at least one MSHR
+    quota = std::min(1024-128, quota);
+    for (auto config : {&controlPanel.l1IMSHRConfig,
+                        &controlPanel.l1DMSHRConfig,
+                        &controlPanel.l2MSHRConfig}) {
+        if (config->numEntries < 2) {
+            continue;
+        }
+        int HPTReserve = std::max(config->numEntries * quota / 1024, 1);
+        reConfigOneMSHR(*config,
+                        std::min(HPTReserve, config->numEntries - 1));
+    }
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::assignPrefetch(int quota)
+{
+    if (!dynPrefetch) {
+        return;
+    }
+
+    DPRINTF(Cazorla, "Allocate %d prefetch to HPT\n", quota);
+    PrefetchThrottleConfig &config = controlPanel.prefetchConfig;
+    config.threadQuotas[HPT] = 1024;
+    config.threadQuotas[LPT] = 1024 - quota;
+    config.version++;
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::reConfigOneMSHR(
+        MSHRRationConfig &mshrRationConfig, int HPTReserve)
+{
+    assert(HPTReserve <= mshrRationConfig.numEntries);
+    mshrRationConfig.threadReserves[HPT] = HPTReserve;
+    mshrRationConfig.threadReserves[LPT] =
+            mshrRationConfig.numEntries - HPTReserve;
+
+    mshrRationConfig.updatedByCore = true;
 }
 
 template <class Impl>
@@ -2343,7 +2594,12 @@ FullO3CPU<Impl>::assignAllResource2HPT()
     assignIQ(1024);
     assignLQ(1024);
     assignSQ(1024);
+    assignRegs(1024);
+    assignIssue(1024);
+    assignCommit(1024);
     assignL2Cache(1024);
+    assignMSHR(1024);
+    assignPrefetch(1024);
 }
 
 template <class Impl>
@@ -2363,7 +2619,17 @@ FullO3CPU<Impl>::allocAllResource(bool incHPT)
     allocIQ(incHPT); // Including issue width
     allocLQ(incHPT);
     allocSQ(incHPT);
+    allocRegs(incHPT);
+    allocIssue(incHPT);
+    allocCommit(incHPT);
     allocCache(2, true, incHPT);
+    if (dynMSHR) {
+        allocMSHR(1, true, incHPT);
+        allocMSHR(2, true, incHPT);
+    }
+    if (dynPrefetch) {
+        allocPrefetch(incHPT);
+    }
 }
 
 template <class Impl>
@@ -2375,7 +2641,12 @@ FullO3CPU<Impl>::assignHalfResource2HPT()
     assignIQ(512);
     assignLQ(512);
     assignSQ(512);
+    assignRegs(512);
+    assignIssue(512);
+    assignCommit(512);
     assignL2Cache(512);
+    assignMSHR(512);
+    assignPrefetch(512);
 }
 
 // Forward declaration of FullO3CPU.
@@ -494,6 +494,10 @@ class FullO3CPU : public BaseO3CPU
     /** Function to tell the CPU that an instruction has completed. */
     void instDone(ThreadID tid, DynInstPtr &inst);
 
+    /** Finds an instruction of a thread in the ROB, NULL if absent. */
+    DynInstPtr findROBInst(ThreadID tid, InstSeqNum seq_num)
+    { return rob.findInst(tid, seq_num); }
+
     /** Remove an instruction from the front end of the list.  There's
      *  no restriction on location of the instruction.
      */
@@ -561,6 +565,8 @@ class FullO3CPU : public BaseO3CPU
 
     typename CPUPolicy::Bmt bmt;
 
+    typename CPUPolicy::SoloWin soloWindow;
+
 
     /** The register file. */
     PhysRegFile regFile;
@@ -821,8 +827,18 @@ class FullO3CPU : public BaseO3CPU
 
     void allocSQ(bool incHPT);
 
+    void allocRegs(bool incHPT);
+
+    void allocIssue(bool incHPT);
+
+    void allocCommit(bool incHPT);
+
     void allocCache(int cacheLevel, bool DCache, bool incHPT);
 
+    void allocMSHR(int cacheLevel, bool DCache, bool incHPT);
+
+    void allocPrefetch(bool incHPT);
+
     void assignFetch(int quota);
 
     void assignROB(int quota);
@@ -833,8 +849,18 @@ class FullO3CPU : public BaseO3CPU
 
     void assignSQ(int quota);
 
+    void assignRegs(int quota);
+
+    void assignIssue(int quota);
+
+    void assignCommit(int quota);
+
     void assignL2Cache(int quota);
 
+    void assignMSHR(int quota);
+
+    void assignPrefetch(int quota);
+
     enum Contention {
         L1DCacheCont = 0,
         L1ICacheCont,
@@ -844,6 +870,11 @@ class FullO3CPU : public BaseO3CPU
         IQCont,
         LQCont,
         SQCont,
+        RegCont,
+        IssueCont,
+        CommitCont,
+        MSHRCont,
+        PrefetchCont,
         ContentionNum
     };
 
@@ -861,6 +892,10 @@ class FullO3CPU : public BaseO3CPU
 
     const bool dynCache;
 
+    const bool dynMSHR;
+
+    const bool dynPrefetch;
+
     void doCazorlaControl();
 
     enum CazorlaPhase {
@@ -914,6 +949,8 @@ class FullO3CPU : public BaseO3CPU
 
     void reConfigOneCache(WayRationConfig &wayRationConfig, int HPTAssoc);
 
+    void reConfigOneMSHR(MSHRRationConfig &mshrRationConfig, int HPTReserve);
+
     void assignAllResource2HPT();
 
     void assignHalfResource2HPT();
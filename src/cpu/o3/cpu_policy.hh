@@ -49,6 +49,7 @@
 #include "cpu/o3/store_set.hh"
 #include "cpu/o3/fmt.hh"
 #include "cpu/o3/bmt.hh"
+#include "cpu/o3/solo_window.hh"
 #include "cpu/o3/slot_consume.hh"
 
 /**
@@ -94,6 +95,9 @@ struct SimpleCPUPolicy
 
     typedef BMT<Impl> Bmt;
 
+    /** Typedef for the per-thread solo-run back-end model. */
+    typedef SoloWindow<Impl> SoloWin;
+
     /** The struct for communication between fetch and decode. */
     typedef DefaultFetchDefaultDecode<Impl> FetchStruct;
 
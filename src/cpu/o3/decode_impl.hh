@@ -46,6 +46,7 @@
 #include <algorithm>
 
 #include "arch/types.hh"
+#include "base/host_profile.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/decode.hh"
@@ -628,6 +629,8 @@ template<class Impl>
 void
 DefaultDecode<Impl>::tick()
 {
+    HOST_PROFILE("o3.decode");
+
     wroteToTimeBuffer = false;
 
     bool status_change = false;
@@ -396,8 +396,6 @@ class BaseO3DynInst : public BaseDynInst<Impl>
     bool readMiss;
     bool DCacheMiss;
 
-    int waitSlots;
-
     bool memRefRejected;
 };
 
@@ -169,8 +169,6 @@ BaseO3DynInst<Impl>::initVars()
     readMiss = false;
     DCacheMiss = false;
 
-    waitSlots = 0;
-
     memRefRejected = false;
 }
 
@@ -87,6 +87,7 @@ class DefaultFetch : public SlotCounter<Impl>
     typedef typename CPUPol::TimeStruct TimeStruct;
     typedef typename CPUPol::IEW IEW;
     typedef typename CPUPol::Fmt Fmt;
+    typedef typename CPUPol::Bmt Bmt;
 
     /** Typedefs from ISA. */
     typedef TheISA::MachInst MachInst;
@@ -187,7 +188,11 @@ class DefaultFetch : public SlotCounter<Impl>
         Branch,
         IQ,
         LSQ,
-        Programmable
+        Programmable,
+        ICount,
+        Stall,
+        Flush,
+        DCRA
     };
 
   private:
@@ -400,6 +405,20 @@ class DefaultFetch : public SlotCounter<Impl>
      * policy. */
     ThreadID branchCount();
 
+    /** Returns the fetchable thread with the fewest weighted instructions
+     * in the front end and IQ. Shared by ICOUNT, STALL, FLUSH and DCRA,
+     * which differ only in which threads fetchGated() holds back. */
+    ThreadID icount();
+
+    /** Whether the fetch policy keeps a thread from fetching this cycle. */
+    bool fetchGated(ThreadID tid);
+
+    /** Whether a load of the thread in the ROB misses in the L2. */
+    bool llLoadPending(ThreadID tid);
+
+    /** DCRA: whether a thread holds at least its share of a resource. */
+    bool dcraOverShare(ThreadID tid, unsigned used, unsigned total);
+
     /** Pipeline the next I-cache access to the current one. */
     void pipelineIcacheAccesses(ThreadID tid);
 
@@ -602,11 +621,29 @@ class DefaultFetch : public SlotCounter<Impl>
     Stats::Formula branchRate;
     /** Number of instruction fetched per cycle. */
     Stats::Formula fetchRate;
+    /** Stat for cycles a thread was held back by the fetch policy. */
+    Stats::Vector policyGatedCycles;
 
   private:
 
     Fmt *fmt;
 
+    Bmt *bmt;
+
+    /** Instructions of each thread sent to decode but not dispatched yet. */
+    unsigned frontEndInsts[Impl::MaxThreads];
+
+    /** Per-thread weights of the ICOUNT key, larger is lower priority. */
+    unsigned icountWeights[Impl::MaxThreads];
+
+    /** Whether the LPT is flushed behind its long-latency loads, and
+     * kept from fetching until they return. */
+    bool lptLLFlush;
+
+    /** IQ and LSQ sizes DCRA divides among the threads. */
+    unsigned numIQEntries;
+    unsigned numLSQEntries;
+
     bool fetchedThisCycle[Impl::MaxThreads];
 
   public:
@@ -622,6 +659,8 @@ class DefaultFetch : public SlotCounter<Impl>
         fmt = _fmt;
     }
 
+    void setBmt(Bmt *_bmt) {bmt = _bmt;}
+
   public:
 
     void passLB(ThreadID tid);
@@ -53,6 +53,7 @@
 #include "arch/isa_traits.hh"
 #include "arch/tlb.hh"
 #include "arch/utility.hh"
+#include "base/host_profile.hh"
 #include "arch/vtophys.hh"
 #include "base/random.hh"
 #include "base/types.hh"
@@ -147,11 +148,44 @@ DefaultFetch<Impl>::DefaultFetch(O3CPU *_cpu, DerivO3CPUParams *params)
     } else if (policy == "programmable") {
         fetchPolicy = Programmable;
         DPRINTF(Pard, "Fetch policy set to Programmable\n");
+    } else if (policy == "icount") {
+        fetchPolicy = ICount;
+        DPRINTF(Fetch, "Fetch policy set to ICOUNT\n");
+    } else if (policy == "stall") {
+        fetchPolicy = Stall;
+        DPRINTF(Fetch, "Fetch policy set to STALL\n");
+    } else if (policy == "flush") {
+        fetchPolicy = Flush;
+        DPRINTF(Fetch, "Fetch policy set to FLUSH\n");
+    } else if (policy == "dcra") {
+        fetchPolicy = DCRA;
+        DPRINTF(Fetch, "Fetch policy set to DCRA\n");
     } else {
         fatal("Invalid Fetch Policy. Options Are: {SingleThread,"
-              " RoundRobin,LSQcount,IQcount}\n");
+              " RoundRobin,LSQcount,IQcount,Branch,Programmable,"
+              "ICount,Stall,Flush,DCRA}\n");
     }
 
+    if (!params->icountWeights.empty() &&
+        params->icountWeights.size() != numThreads)
+        fatal("icountWeights has %d entries for %d threads\n",
+              params->icountWeights.size(), numThreads);
+
+    for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++) {
+        frontEndInsts[tid] = 0;
+        icountWeights[tid] = 1;
+    }
+    for (ThreadID tid = 0; tid < params->icountWeights.size(); tid++) {
+        if (params->icountWeights[tid] == 0)
+            fatal("icountWeights must be positive\n");
+        icountWeights[tid] = params->icountWeights[tid];
+    }
+
+    lptLLFlush = params->lptLLFlush;
+    numIQEntries = params->numIQEntries;
+    numLSQEntries = params->LQEntries + params->SQEntries;
+    bmt = NULL;
+
     // Get the size of an instruction.
     instSize = sizeof(TheISA::MachInst);
 
@@ -253,6 +287,12 @@ DefaultFetch<Impl>::regStats()
         .desc("Number of cycles fetch has spent blocked each thread")
         .flags(Stats::pdf);
 
+    policyGatedCycles
+        .init(cpu->numThreads)
+        .name(name() + ".PolicyGatedCycles")
+        .desc("Number of cycles each thread was held back by the fetch "
+              "policy");
+
     fetchedCacheLines
         .name(name() + ".CacheLines")
         .desc("Number of cache lines fetched")
@@ -390,6 +430,7 @@ DefaultFetch<Impl>::resetStage()
         pc[tid] = cpu->pcState(tid);
         fetchOffset[tid] = 0;
         macroop[tid] = NULL;
+        frontEndInsts[tid] = 0;
 
         delayedCommit[tid] = false;
         memReq[tid] = NULL;
@@ -431,6 +472,7 @@ DefaultFetch<Impl>::processCacheCompletion(PacketPtr pkt)
         DPRINTF(MissTable, "T[%i] Remove L%i cache miss [0x%x] from L2 miss table.\n",
                 tid, it->second.cacheLevel, phyAddress);
         ms.numL2InstMiss[tid]--;
+        missTables.removeL2Miss(it->second);
         l2_table.erase(it);
     }
 
@@ -668,6 +710,7 @@ DefaultFetch<Impl>::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
                 tid);
         return false;
     } else if (missTables.perThreadMSHRFull(1, false, tid, false)) {
+        missTables.noteMSHRReject(tid, cpu->curCycle());
         int threadInstMiss = 0;
         for (auto &it : missTables.l1IMissTable) {
             threadInstMiss += it.second.tid == tid;
@@ -675,7 +718,10 @@ DefaultFetch<Impl>::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
         DPRINTF(MSHR, "T[%i] fetch blocked because of MSHR full\n");
         DPRINTF(MSHR, "T[%i] miss stat inst miss: %i, inst miss table size: %i\n",
                 tid, missTables.missStat.numL1InstMiss[tid], threadInstMiss);
-        warn("MSHR of icache should not be used up!\n");
+        // with reservations the thread is just held to its share
+        if (!missTables.reserved(missTables.l1IMSHRs)) {
+            warn("MSHR of icache should not be used up!\n");
+        }
         return false;
     }
 
@@ -853,6 +899,7 @@ DefaultFetch<Impl>::doSquash(const TheISA::PCState &newPC,
 
     // Empty fetch queue
     fetchQueue[tid].clear();
+    frontEndInsts[tid] = 0;
 
     // microops are being squashed, it is not known wheather the
     // youngest non-squashed microop was  marked delayed commit
@@ -952,6 +999,8 @@ template <class Impl>
 void
 DefaultFetch<Impl>::tick()
 {
+    HOST_PROFILE("o3.fetch");
+
     fetchThread = InvalidThreadID;
     list<ThreadID>::iterator threads = activeThreads->begin();
     list<ThreadID>::iterator end = activeThreads->end();
@@ -1031,6 +1080,7 @@ DefaultFetch<Impl>::tick()
         if (!stalls[tid].decode && !fetchQueue[tid].empty() ) {
             auto inst = fetchQueue[tid].front();
             toDecode->insts[toDecode->size++] = inst;
+            frontEndInsts[tid]++;
             DPRINTF(Fetch, "[tid:%i][sn:%i]: Sending instruction to decode from "
                     "fetch queue. Fetch queue size: %i.\n",
                     tid, inst->seqNum, fetchQueue[tid].size());
@@ -1087,6 +1137,10 @@ template <class Impl>
 bool
 DefaultFetch<Impl>::checkSignalsAndUpdate(ThreadID tid)
 {
+    // Instructions dispatched by IEW leave the front end.
+    frontEndInsts[tid] -= std::min(frontEndInsts[tid],
+                                   fromIEW->iewInfo[tid].dispatched);
+
     // Update the per thread stall statuses.
     if (fromDecode->decodeBlock[tid]) {
         stalls[tid].decode = true;
@@ -1574,6 +1628,12 @@ DefaultFetch<Impl>::getFetchingThread(FetchPriority &fetch_priority)
           case Programmable:
             return roundRobin();
 
+          case ICount:
+          case Stall:
+          case Flush:
+          case DCRA:
+            return icount();
+
           default:
             return InvalidThreadID;
         }
@@ -1615,6 +1675,12 @@ DefaultFetch<Impl>::roundRobin()
             fetchStatus[high_pri] == IcacheAccessComplete ||
             fetchStatus[high_pri] == Idle) && !fetchedThisCycle[high_pri]) {
 
+            if (fetchGated(high_pri)) {
+                ++policyGatedCycles[high_pri];
+                pri_iter++;
+                continue;
+            }
+
             priorityList.erase(pri_iter);
             priorityList.push_back(high_pri);
 
@@ -1665,6 +1731,122 @@ DefaultFetch<Impl>::iqCount()
     return InvalidThreadID;
 }
 
+template<class Impl>
+ThreadID
+DefaultFetch<Impl>::icount()
+{
+    ThreadID high_pri = InvalidThreadID;
+    uint64_t high_pri_count = 0;
+
+    list<ThreadID>::iterator threads = activeThreads->begin();
+    list<ThreadID>::iterator end = activeThreads->end();
+
+    while (threads != end) {
+        ThreadID tid = *threads++;
+
+        if ((fetchStatus[tid] != Running &&
+             fetchStatus[tid] != IcacheAccessComplete &&
+             fetchStatus[tid] != Idle) || fetchedThisCycle[tid]) {
+            continue;
+        }
+
+        if (fetchGated(tid)) {
+            ++policyGatedCycles[tid];
+            continue;
+        }
+
+        uint64_t count = (uint64_t) icountWeights[tid] *
+            (frontEndInsts[tid] + fromIEW->iewInfo[tid].iqCount);
+
+        // Ties go to the thread with the smaller ID, i.e., the HPT.
+        if (high_pri == InvalidThreadID || count < high_pri_count ||
+            (count == high_pri_count && tid < high_pri)) {
+            high_pri = tid;
+            high_pri_count = count;
+        }
+    }
+
+    DPRINTF(Fetch, "ICOUNT selected thread %i, count %llu\n",
+            high_pri, high_pri_count);
+
+    return high_pri;
+}
+
+template<class Impl>
+bool
+DefaultFetch<Impl>::fetchGated(ThreadID tid)
+{
+    // The flushed LPT refetches only after its miss returns.
+    if (lptLLFlush && tid != HPT && llLoadPending(tid)) {
+        return true;
+    }
+
+    switch (fetchPolicy) {
+      case Stall:
+      case Flush:
+        // Hold the thread back while one of its loads misses in the L2;
+        // FLUSH additionally has IEW squash what was fetched after it.
+        return llLoadPending(tid);
+
+      case DCRA:
+        return dcraOverShare(tid, fromIEW->iewInfo[tid].iqCount,
+                             numIQEntries) ||
+            dcraOverShare(tid, fromIEW->iewInfo[tid].ldstqCount,
+                          numLSQEntries);
+
+      default:
+        return false;
+    }
+}
+
+template<class Impl>
+bool
+DefaultFetch<Impl>::llLoadPending(ThreadID tid)
+{
+    // Squashed loads are dropped from the tracked misses, so any
+    // tracked one is still in the ROB
+    return bmt->oldestLLLoad(tid) != 0;
+}
+
+template<class Impl>
+bool
+DefaultFetch<Impl>::dcraOverShare(ThreadID tid, unsigned used,
+                                  unsigned total)
+{
+    // Threads with outstanding data misses are slow and entitled to a
+    // larger share, R/T * (1 + C * FT), with C = 1 / (T + 4), where T is
+    // the number of active threads and FT the number of fast ones.
+    unsigned num_active = 0;
+    unsigned num_fast = 0;
+
+    list<ThreadID>::iterator threads = activeThreads->begin();
+    list<ThreadID>::iterator end = activeThreads->end();
+
+    while (threads != end) {
+        ThreadID i = *threads++;
+        num_active++;
+        if (!missTables.hasDataMiss(i)) {
+            num_fast++;
+        }
+    }
+
+    if (num_active <= 1) {
+        return false;
+    }
+
+    double slow_share = (double) total / num_active *
+        (1.0 + (double) num_fast / (num_active + 4));
+
+    double share;
+    if (missTables.hasDataMiss(tid)) {
+        share = slow_share;
+    } else {
+        share = (total - slow_share * (num_active - num_fast)) / num_fast;
+    }
+
+    return used >= share;
+}
+
 template<class Impl>
 ThreadID
 DefaultFetch<Impl>::lsqCount()
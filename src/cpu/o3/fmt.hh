@@ -113,6 +113,11 @@ class FMT {
      */
     void resolveBranch(bool right, DynInstPtr &bran, ThreadID tid);
 
+    /* Count slots of all branches younger than seq as miss event slots,
+     * used when the instructions after seq are thrown away.
+     */
+    void squashAfter(ThreadID tid, InstSeqNum seq);
+
     /* The following functions are used to add slots to global counter
      * directly, which should be deterministic
      */
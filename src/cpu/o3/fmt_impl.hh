@@ -4,6 +4,7 @@
 #define __STDC_FORMAT_MACROS // for PRIu64 macro
 #include <cinttypes>
 
+#include "base/host_profile.hh"
 #include "cpu/o3/comm.hh"
 #include "debug/FMT.hh"
 #include "debug/FmtSlot.hh"
@@ -116,6 +117,8 @@ void FMT<Impl>::setStage(Fetch *_fetch, Decode *_decode, IEW *_iew)
     template<class Impl>
 void FMT<Impl>::addBranch(DynInstPtr &bran, ThreadID tid, uint64_t timeStamp)
 {
+    HOST_PROFILE("o3.fmt");
+
     DPRINTF(FMT, "Adding %i\n", bran->seqNum);
     rBranchEntryIterator it = table[tid].rbegin();
 
@@ -174,6 +177,8 @@ void FMT<Impl>::resolveBranch(bool right, DynInstPtr &bran, ThreadID tid)
     DPRINTF(FMT, "Resolving %i\n", bran->seqNum);
 
     if (right) {
+        HOST_PROFILE("o3.fmt");
+
         BranchEntryIterator it = table[tid].begin();
         it++; // Do not delete the first one
 
@@ -200,25 +205,40 @@ void FMT<Impl>::resolveBranch(bool right, DynInstPtr &bran, ThreadID tid)
             }
         }
     } else {
-        rBranchEntryIterator rit = table[tid].rbegin();
-        for (; rit->seqNum > bran->seqNum; rit++);
+        squashAfter(tid, bran->seqNum);
+        return;
+    }
 
-        BranchEntryIterator it = std::next(rit).base();
-        if (it->seqNum < bran->seqNum) {
-            it++;
-        }
-        while (it != table[tid].end()) {
-            globalMiss[tid] += it->baseSlots;
-            globalMiss[tid] += it->missSlots;
-            globalMiss[tid] += it->waitSlots;
+    DPRINTF(FMT, "Branches now in table[%d] is: ", tid);
+    for (BranchEntryIterator it2 = table[tid].begin(); it2 != table[tid].end(); it2++) {
+        DPRINTFR(FMT, "%d, ", it2->seqNum);
+    }
+    DPRINTFR(FMT, "\n");
+}
+
+    template<class Impl>
+void FMT<Impl>::squashAfter(ThreadID tid, InstSeqNum seq)
+{
+    HOST_PROFILE("o3.fmt");
 
-            waitToMiss[tid] += it->waitSlots;
-            baseToMiss[tid] += it->baseSlots;
+    rBranchEntryIterator rit = table[tid].rbegin();
+    for (; rit->seqNum > seq; rit++);
 
-            DPRINTF(FMT, "Squashing Inst: %i\n", it->seqNum);
+    BranchEntryIterator it = std::next(rit).base();
+    if (it->seqNum < seq) {
+        it++;
+    }
+    while (it != table[tid].end()) {
+        globalMiss[tid] += it->baseSlots;
+        globalMiss[tid] += it->missSlots;
+        globalMiss[tid] += it->waitSlots;
 
-            it = table[tid].erase(it);
-        }
+        waitToMiss[tid] += it->waitSlots;
+        baseToMiss[tid] += it->baseSlots;
+
+        DPRINTF(FMT, "Squashing Inst: %i\n", it->seqNum);
+
+        it = table[tid].erase(it);
     }
 
     DPRINTF(FMT, "Branches now in table[%d] is: ", tid);
@@ -36,11 +36,20 @@
 #include "debug/FreeList.hh"
 
 UnifiedFreeList::UnifiedFreeList(const std::string &_my_name,
-                                 PhysRegFile *_regFile)
+                                 PhysRegFile *_regFile, bool bitmap)
     : _name(_my_name), regFile(_regFile)
 {
     DPRINTF(FreeList, "Creating new free list object.\n");
 
+    if (bitmap) {
+        intList.initBitmap(0, regFile->numIntPhysRegs());
+        floatList.initBitmap(regFile->numIntPhysRegs(),
+                             regFile->numFloatPhysRegs());
+        ccList.initBitmap(regFile->numIntPhysRegs() +
+                          regFile->numFloatPhysRegs(),
+                          regFile->numCCPhysRegs());
+    }
+
     // Have the register file initialize the free list since it knows
     // about its internal organization
     regFile->initFreeList(this);
@@ -32,8 +32,10 @@
 #ifndef __CPU_O3_FREE_LIST_HH__
 #define __CPU_O3_FREE_LIST_HH__
 
+#include <cstdint>
 #include <iostream>
 #include <queue>
+#include <vector>
 
 #include "base/misc.hh"
 #include "base/trace.hh"
@@ -47,35 +49,98 @@
  * determined by the rename map instance being accessed, all
  * architectural register index parameters and values in this class
  * are relative (e.g., %fp2 is just index 2).
+ *
+ * By default the free registers are kept in FIFO order.  In bitmap
+ * mode they are kept as one bit per register of the class and the
+ * lowest free register is handed out first, which avoids the queue's
+ * allocations and catches registers freed twice.
  */
 class SimpleFreeList
 {
   private:
 
-    /** The actual free list */
+    /** The actual free list, when not in bitmap mode */
     std::queue<PhysRegIndex> freeRegs;
 
+    /** One bit per register of the class, set when it is free */
+    std::vector<uint64_t> freeBits;
+
+    /** Physical index of the register of bit 0 */
+    PhysRegIndex baseReg;
+
+    /** Number of bits set in freeBits */
+    unsigned numFree;
+
+    /** Lowest word of freeBits that may have a bit set */
+    unsigned firstWord;
+
+    bool bitmap;
+
   public:
 
-    SimpleFreeList() {};
+    SimpleFreeList()
+        : baseReg(0), numFree(0), firstWord(0), bitmap(false)
+    {}
+
+    /**
+     * Switch to bitmap mode for the registers [base, base + size).
+     * Must be called before any register is added.
+     */
+    void initBitmap(PhysRegIndex base, unsigned size)
+    {
+        assert(freeRegs.empty());
+        bitmap = true;
+        baseReg = base;
+        freeBits.assign((size + 63) / 64, 0);
+        firstWord = freeBits.size();
+    }
 
     /** Add a physical register to the free list */
-    void addReg(PhysRegIndex reg) { freeRegs.push(reg); }
+    void addReg(PhysRegIndex reg)
+    {
+        if (!bitmap) {
+            freeRegs.push(reg);
+            return;
+        }
+
+        unsigned bit = reg - baseReg;
+        unsigned word = bit / 64;
+        uint64_t mask = uint64_t(1) << (bit % 64);
+        assert(word < freeBits.size());
+        panic_if(freeBits[word] & mask,
+                 "Physical register %i freed twice\n", reg);
+        freeBits[word] |= mask;
+        ++numFree;
+        if (word < firstWord)
+            firstWord = word;
+    }
 
     /** Get the next available register from the free list */
     PhysRegIndex getReg()
     {
-        assert(!freeRegs.empty());
-        PhysRegIndex free_reg = freeRegs.front();
-        freeRegs.pop();
-        return free_reg;
+        if (!bitmap) {
+            assert(!freeRegs.empty());
+            PhysRegIndex free_reg = freeRegs.front();
+            freeRegs.pop();
+            return free_reg;
+        }
+
+        assert(numFree);
+        while (!freeBits[firstWord])
+            ++firstWord;
+        uint64_t &word = freeBits[firstWord];
+        unsigned bit = __builtin_ctzll(word);
+        word &= word - 1;
+        --numFree;
+        return baseReg + firstWord * 64 + bit;
     }
 
     /** Return the number of free registers on the list. */
-    unsigned numFreeRegs() const { return freeRegs.size(); }
+    unsigned numFreeRegs() const
+    { return bitmap ? numFree : freeRegs.size(); }
 
     /** True iff there are free registers on the list. */
-    bool hasFreeRegs() const { return !freeRegs.empty(); }
+    bool hasFreeRegs() const { return numFreeRegs() != 0; }
 };
 
 
@@ -131,7 +196,8 @@ class UnifiedFreeList
      *  @param reservedFloatRegs Number of fp registers already
      *                           used by initial mappings.
      */
-    UnifiedFreeList(const std::string &_my_name, PhysRegFile *_regFile);
+    UnifiedFreeList(const std::string &_my_name, PhysRegFile *_regFile,
+                    bool bitmap = false);
 
     /** Gives the name of the freelist. */
     std::string name() const { return _name; };
@@ -151,6 +217,12 @@ class UnifiedFreeList
     /** Adds a register back to the free list. */
     void addReg(PhysRegIndex freed_reg);
 
+    /**
+     * Adds back every register whose bit is set in a mask indexed by
+     * physical register.
+     */
+    void addRegs(const std::vector<uint64_t> &mask);
+
     /** Adds an integer register back to the free list. */
     void addIntReg(PhysRegIndex freed_reg) { intList.addReg(freed_reg); }
 
@@ -207,5 +279,15 @@ UnifiedFreeList::addReg(PhysRegIndex freed_reg)
     // assert(freeFloatRegs.size() <= numPhysicalFloatRegs);
 }
 
+inline void
+UnifiedFreeList::addRegs(const std::vector<uint64_t> &mask)
+{
+    for (unsigned w = 0; w < mask.size(); w++) {
+        for (uint64_t bits = mask[w]; bits; bits &= bits - 1) {
+            addReg(w * 64 + __builtin_ctzll(bits));
+        }
+    }
+}
+
 
 #endif // __CPU_O3_FREE_LIST_HH__
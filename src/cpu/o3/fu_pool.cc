@@ -43,6 +43,7 @@
 #include <sstream>
 
 #include "cpu/o3/fu_pool.hh"
+#include "cpu/o3/slot_counter.hh"
 #include "cpu/func_unit.hh"
 
 using namespace std;
@@ -130,6 +131,12 @@ FUPool::FUPool(const Params *p)
                     pipelined[(*j)->opClass] = false;
             }
 
+            if ((*i)->hptReserved > (*i)->number) {
+                fatal("%s reserves %d of its %d FU's for the high priority "
+                      "thread\n", (*i)->name(), (*i)->hptReserved,
+                      (*i)->number);
+            }
+
             numFU++;
 
             //  Add the appropriate number of copies of this FU to the list
@@ -145,18 +152,25 @@ FUPool::FUPool(const Params *p)
                 fu2->name = s.str();
                 funcUnits.push_back(fu2);
             }
+
+            // The last copies are the reserved ones
+            unitReserved.resize(numFU, false);
+            for (unsigned c = 0; c < (*i)->hptReserved; ++c)
+                unitReserved[numFU - 1 - c] = true;
         }
     }
 
     unitBusy.resize(numFU);
+    unitOwner.resize(numFU);
 
     for (int i = 0; i < numFU; i++) {
         unitBusy[i] = false;
+        unitOwner[i] = InvalidThreadID;
     }
 }
 
 int
-FUPool::getUnit(OpClass capability)
+FUPool::getUnit(OpClass capability, ThreadID tid)
 {
     //  If this pool doesn't have the specified capability,
     //  return this information to the caller
@@ -168,7 +182,7 @@ FUPool::getUnit(OpClass capability)
 
     // Iterate through the circular queue if needed, stopping if we've reached
     // the first element again.
-    while (unitBusy[fu_idx]) {
+    while (unitBusy[fu_idx] || (unitReserved[fu_idx] && tid != HPT)) {
         fu_idx = fuPerCapList[capability].getFU();
         if (fu_idx == start_idx) {
             // No FU available
@@ -179,10 +193,23 @@ FUPool::getUnit(OpClass capability)
     assert(fu_idx < numFU);
 
     unitBusy[fu_idx] = true;
+    unitOwner[fu_idx] = tid;
 
     return fu_idx;
 }
 
+bool
+FUPool::busyWithOthers(OpClass capability, ThreadID tid) const
+{
+    for (int fu_idx : fuPerCapList[capability].units()) {
+        if (unitReserved[fu_idx] && tid != HPT)
+            continue;
+        if (unitBusy[fu_idx] && unitOwner[fu_idx] != tid)
+            return true;
+    }
+    return false;
+}
+
 void
 FUPool::freeUnitNextCycle(int fu_idx)
 {
@@ -200,6 +227,7 @@ FUPool::processFreeUnits()
         assert(unitBusy[fu_idx]);
 
         unitBusy[fu_idx] = false;
+        unitOwner[fu_idx] = InvalidThreadID;
     }
 }
 
@@ -82,6 +82,12 @@ class FUPool : public SimObject
     /** Bitvector listing which FUs are busy. */
     std::vector<bool> unitBusy;
 
+    /** Bitvector listing which FUs only the high priority thread uses. */
+    std::vector<bool> unitReserved;
+
+    /** Thread holding each busy FU. */
+    std::vector<ThreadID> unitOwner;
+
     /** List of units to be freed at the end of this cycle. */
     std::vector<int> unitsToBeFreed;
 
@@ -106,6 +112,9 @@ class FUPool : public SimObject
          */
         inline int getFU();
 
+        /** All FU indices in the queue. */
+        const std::vector<int> &units() const { return funcUnitsIdx; }
+
       private:
         /** Circular queue index. */
         int idx;
@@ -138,10 +147,19 @@ class FUPool : public SimObject
      * Gets a FU providing the requested capability. Will mark the unit as busy,
      * but leaves the freeing of the unit up to the IEW stage.
      * @param capability The capability requested.
+     * @param tid The thread the unit is for. Reserved FUs are only handed
+     * to the HPT.
      * @return Returns -2 if the FU pool does not have the capability, -1 if
      * there is no free FU, and the FU's index otherwise.
      */
-    int getUnit(OpClass capability);
+    int getUnit(OpClass capability, ThreadID tid = 0);
+
+    /**
+     * Whether a FU with the capability that the thread may use is busy
+     * with an op of another thread, i.e. whether the thread would have
+     * got a unit if it ran alone.
+     */
+    bool busyWithOthers(OpClass capability, ThreadID tid) const;
 
     /** Frees a FU at the end of this cycle. */
     void freeUnitNextCycle(int fu_idx);
@@ -101,6 +101,7 @@ class DefaultIEW : public SlotCounter<Impl>
 
     typedef typename CPUPol::Fmt Fmt;
     typedef typename CPUPol::Bmt Bmt;
+    typedef typename CPUPol::SoloWin SoloWin;
     typedef SlotConsumer<Impl> SlotConsm;
 
     typedef std::queue<DynInstPtr> InstRow;
@@ -254,6 +255,12 @@ class DefaultIEW : public SlotCounter<Impl>
      */
     void squashDueToMemOrder(DynInstPtr &inst, ThreadID tid);
 
+    /** Under the FLUSH fetch policy or the LPT flush, sends commit a
+     * squash of the instructions younger than a new L2-missing load of
+     * the thread.
+     */
+    void flushAfterLLMiss(ThreadID tid);
+
     /** Sets Dispatch to blocked, and signals back to other stages to block. */
     void block(ThreadID tid);
 
@@ -449,6 +456,10 @@ class DefaultIEW : public SlotCounter<Impl>
     Stats::Vector iewUnblockCycles;
     /** Stat for total number of running cycles. */
     Stats::Vector iewRunCycles;
+    /** Stat for number of flushes after long-latency loads. */
+    Stats::Vector iewLLFlushes;
+    /** Stat for number of INV instructions skipped in runahead mode. */
+    Stats::Vector iewRunaheadInvInsts;
     /** Stat for total number of instructions dispatched. */
     Stats::Scalar iewDispatchedInsts;
     /** Stat for total number of squashed instructions dispatch skips. */
@@ -530,6 +541,19 @@ class DefaultIEW : public SlotCounter<Impl>
 
     Bmt *bmt;
 
+    /** Solo-run back-end model, fed with IQ and LSQ stalls. */
+    SoloWin *soloWindow;
+
+    /** Whether the FLUSH fetch policy is in use. */
+    bool flushPolicy;
+
+    /** Whether the LPT is flushed behind long-latency loads that have
+     * dependents waiting in the IQ. */
+    bool lptLLFlush;
+
+    /** The last long-latency load each thread was flushed behind. */
+    InstSeqNum lastFlushedLL[Impl::MaxThreads];
+
     uint32_t tempWaitSlots[Impl::MaxThreads];
 
   public:
@@ -538,6 +562,31 @@ class DefaultIEW : public SlotCounter<Impl>
 
     void setBmt(Bmt *_bmt) {bmt = _bmt;}
 
+    void setSoloWindow(SoloWin *_solo) { soloWindow = _solo; }
+
+    /** Puts a thread in or out of runahead mode. */
+    void enterRunahead(ThreadID tid);
+    void exitRunahead(ThreadID tid);
+
+    bool inRunahead(ThreadID tid) const { return runahead[tid]; }
+
+    /** Runahead: marks the results of inst INV and wakes its dependents,
+     * which then skip execution too. */
+    void runaheadInvalidate(DynInstPtr &inst);
+
+  private:
+    /** Runahead: whether inst reads an INV register; passes the INV bit
+     * on to its destination registers. */
+    bool runaheadInv(DynInstPtr &inst);
+
+    /** Whether each thread is in runahead mode. */
+    bool runahead[Impl::MaxThreads];
+
+    /** INV bits of the physical registers written in runahead mode. */
+    std::vector<bool> invRegs;
+
+  public:
+
     bool Programmable;
 
     int dispatchWidths[Impl::MaxThreads];
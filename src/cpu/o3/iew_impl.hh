@@ -48,9 +48,11 @@
 // iew.  There's a clear delay between issue and execute, yet backwards
 // communication happens simultaneously.
 
+#include <algorithm>
 #include <queue>
 
 #include "arch/utility.hh"
+#include "base/host_profile.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
 #include "cpu/o3/fu_pool.hh"
@@ -141,6 +143,20 @@ DefaultIEW<Impl>::DefaultIEW(O3CPU *_cpu, DerivO3CPUParams *params)
     updateLSQNextCycle = false;
 
     skidBufferMax = (renameToIEWDelay + 1);
+
+    std::string fetch_policy = params->smtFetchPolicy;
+    std::transform(fetch_policy.begin(), fetch_policy.end(),
+                   fetch_policy.begin(), (int(*)(int)) tolower);
+    flushPolicy = fetch_policy == "flush";
+    lptLLFlush = params->lptLLFlush;
+
+    for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++) {
+        lastFlushedLL[tid] = 0;
+        runahead[tid] = false;
+    }
+
+    invRegs.resize(params->numPhysIntRegs + params->numPhysFloatRegs +
+                   params->numPhysCCRegs, false);
 }
 
 template <class Impl>
@@ -194,6 +210,16 @@ DefaultIEW<Impl>::regStats()
         .name(name() + ".iewRunCycles")
         .desc("Number of cycles IEW is Running");
 
+    iewLLFlushes
+        .init(numThreads)
+        .name(name() + ".iewLLFlushes")
+        .desc("Number of squashes behind long-latency loads");
+
+    iewRunaheadInvInsts
+        .init(numThreads)
+        .name(name() + ".iewRunaheadInvInsts")
+        .desc("Number of INV instructions skipped in runahead mode");
+
     iewDispatchedInsts
         .name(name() + ".iewDispatchedInsts")
         .desc("Number of instructions dispatched to IQ")
@@ -662,6 +688,128 @@ DefaultIEW<Impl>::squashDueToMemOrder(DynInstPtr &inst, ThreadID tid)
     }
 }
 
+template<class Impl>
+void
+DefaultIEW<Impl>::flushAfterLLMiss(ThreadID tid)
+{
+    InstSeqNum ll_seq = bmt->oldestLLLoad(tid);
+
+    if (ll_seq == 0 || ll_seq <= lastFlushedLL[tid]) {
+        return;
+    }
+
+    DynInstPtr inst = cpu->findROBInst(tid, ll_seq);
+
+    // The load may be squashed already, or be in the middle of a macroop
+    // which cannot be restarted after it.
+    if (!inst || inst->isSquashed() ||
+        (inst->isMicroop() && !inst->isLastMicroop())) {
+        return;
+    }
+
+    // The LPT flush only pays off once the load's dependence tree starts
+    // to hold IQ entries; retry on later cycles until it does.
+    if (!flushPolicy && !instQueue.hasDependents(inst)) {
+        return;
+    }
+
+    lastFlushedLL[tid] = ll_seq;
+
+    // An older squash this cycle covers the flush.
+    if (toCommit->squash[tid] && toCommit->squashedSeqNum[tid] <= ll_seq) {
+        return;
+    }
+
+    DPRINTF(IEW, "[tid:%i]: Long-latency load [sn:%i], squashing younger "
+            "insts, PC: %s.\n", tid, ll_seq, inst->pcState());
+
+    toCommit->squash[tid] = true;
+    toCommit->squashedSeqNum[tid] = ll_seq;
+
+    TheISA::PCState pc = inst->pcState();
+    TheISA::advancePC(pc, inst->staticInst);
+    toCommit->pc[tid] = pc;
+    toCommit->mispredictInst[tid] = NULL;
+
+    // The load itself stays and completes.
+    toCommit->includeSquashInst[tid] = false;
+
+    wroteToTimeBuffer = true;
+    ++iewLLFlushes[tid];
+}
+
+template<class Impl>
+void
+DefaultIEW<Impl>::enterRunahead(ThreadID tid)
+{
+    DPRINTF(IEW, "[tid:%i]: Entering runahead mode.\n", tid);
+    runahead[tid] = true;
+}
+
+template<class Impl>
+void
+DefaultIEW<Impl>::exitRunahead(ThreadID tid)
+{
+    DPRINTF(IEW, "[tid:%i]: Exiting runahead mode.\n", tid);
+    runahead[tid] = false;
+    std::fill(invRegs.begin(), invRegs.end(), false);
+}
+
+template<class Impl>
+void
+DefaultIEW<Impl>::runaheadInvalidate(DynInstPtr &inst)
+{
+    DPRINTF(IEW, "[tid:%i]: Runahead INV [sn:%i].\n",
+            inst->threadNumber, inst->seqNum);
+
+    for (int i = 0; i < inst->numDestRegs(); i++) {
+        PhysRegIndex dest_reg = inst->renamedDestRegIdx(i);
+        if (dest_reg < invRegs.size()) {
+            invRegs[dest_reg] = true;
+        }
+    }
+
+    if (!inst->isSquashed()) {
+        instQueue.wakeDependents(inst);
+
+        for (int i = 0; i < inst->numDestRegs(); i++) {
+            scoreboard->setReg(inst->renamedDestRegIdx(i));
+        }
+    }
+
+    inst->setExecuted();
+    inst->setCanCommit();
+
+    // Drop whatever the instruction still has in flight, e.g., the
+    // response of a missing load.
+    inst->setSquashed();
+
+    ++iewRunaheadInvInsts[inst->threadNumber];
+}
+
+template<class Impl>
+bool
+DefaultIEW<Impl>::runaheadInv(DynInstPtr &inst)
+{
+    bool inv = false;
+
+    for (int i = 0; i < inst->numSrcRegs(); i++) {
+        PhysRegIndex src_reg = inst->renamedSrcRegIdx(i);
+        if (src_reg < invRegs.size() && invRegs[src_reg]) {
+            inv = true;
+        }
+    }
+
+    for (int i = 0; i < inst->numDestRegs(); i++) {
+        PhysRegIndex dest_reg = inst->renamedDestRegIdx(i);
+        if (dest_reg < invRegs.size()) {
+            invRegs[dest_reg] = inv;
+        }
+    }
+
+    return inv;
+}
+
 template<class Impl>
 void
 DefaultIEW<Impl>::block(ThreadID tid)
@@ -1232,7 +1380,7 @@ DefaultIEW<Impl>::dispatchInsts(ThreadID tid)
             ++numIQFull[tid];
             fullSource[tid] = SlotConsm::IQ;
 
-            instQueue.incVIQ(tid, dispatchWidth);
+            soloWindow->stalled(tid, dispatchWidth - dis_num_inst);
 
             break;
         }
@@ -1251,14 +1399,8 @@ DefaultIEW<Impl>::dispatchInsts(ThreadID tid)
                 ++numSQFull[tid];
             }
 
-            if (inst->isLoad()) {
-                DPRINTF(missTry2, "increase VLQ %f\n", loadRate);
-                ldstQueue.incVLQ(tid, loadRate);
+            soloWindow->stalled(tid, dispatchWidth - dis_num_inst);
 
-            } else if (inst->isStore()) {
-                ldstQueue.incVSQ(tid, storeRate);
-                DPRINTF(missTry2, "increase VSQ %f\n", storeRate);
-            }
             // Call function to start blocking.
             block(tid);
 
@@ -1512,6 +1654,21 @@ DefaultIEW<Impl>::executeInsts()
             continue;
         }
 
+        // In runahead mode, instructions depending on a missing load
+        // would only compute bogus values and addresses.
+        if (runahead[inst->threadNumber] && runaheadInv(inst)) {
+            DPRINTF(IEW, "Execute: Runahead INV [sn:%i], skipping.\n",
+                    inst->seqNum);
+
+            inst->setExecuted();
+            instToCommit(inst);
+            activityThisCycle();
+
+            ++iewRunaheadInvInsts[inst->threadNumber];
+
+            continue;
+        }
+
         Fault fault = NoFault;
 
         // Execute instruction.
@@ -1746,6 +1903,8 @@ template<class Impl>
 void
 DefaultIEW<Impl>::tick()
 {
+    HOST_PROFILE("o3.iew");
+
     clearLocalSignals();
     sortInsts();
 
@@ -1779,6 +1938,14 @@ DefaultIEW<Impl>::tick()
         dispatch(tid);
     }
 
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        soloWindow->setOccupancy(tid, SoloWin::IQ,
+                                 instQueue.numBusyEntries(tid));
+        soloWindow->setOccupancy(tid, SoloWin::LQ, ldstQueue.numLoads(tid));
+        soloWindow->setOccupancy(tid, SoloWin::SQ, ldstQueue.numStores(tid));
+    }
+    soloWindow->sample();
+
     cycleDispatchEnd(HPT);
 
     updateILP();
@@ -1788,9 +1955,19 @@ DefaultIEW<Impl>::tick()
     if (this->checkSlots(HPT)) {
         //only inst miss should be counted
         this->sumLocalSlots(HPT);
-        fmt->incBaseDirect(HPT, this->curCycleBase[HPT]);
-        fmt->incMissDirect(HPT, this->curCycleMiss[HPT]);
-        fmt->incWaitDirect(HPT, this->curCycleWait[HPT], false);
+
+        HOST_PROFILE("o3.fmt");
+        if (runahead[HPT]) {
+            // Runahead work is thrown away, so alone the HPT would have
+            // stalled on its miss in these slots.
+            fmt->incMissDirect(HPT, this->curCycleBase[HPT] +
+                               this->curCycleMiss[HPT] +
+                               this->curCycleWait[HPT]);
+        } else {
+            fmt->incBaseDirect(HPT, this->curCycleBase[HPT]);
+            fmt->incMissDirect(HPT, this->curCycleMiss[HPT]);
+            fmt->incWaitDirect(HPT, this->curCycleWait[HPT], false);
+        }
     }
 
 
@@ -1799,6 +1976,15 @@ DefaultIEW<Impl>::tick()
 
         writebackInsts();
 
+        // The FLUSH fetch policy flushes every thread, the LPT flush only
+        // the threads sharing the core with the HPT.
+        for (ThreadID tid = 0; tid < numThreads; ++tid) {
+            if ((flushPolicy || (lptLLFlush && tid != HPT)) &&
+                dispatchStatus[tid] != Squashing) {
+                flushAfterLLMiss(tid);
+            }
+        }
+
         // Have the instruction queue try to schedule any ready instructions.
         // (In actuality, this scheduling is for instructions that will
         // be executed next cycle.)
@@ -1867,12 +2053,12 @@ DefaultIEW<Impl>::tick()
             }
         }
 
-        if (broadcast_free_entries) {
-            toFetch->iewInfo[tid].iqCount =
-                instQueue.getCount(tid);
-            toFetch->iewInfo[tid].ldstqCount =
-                ldstQueue.getCount(tid);
+        // The fetch policies rank threads on these every cycle, so they
+        // are sent even when the free entries are not broadcast
+        toFetch->iewInfo[tid].iqCount = instQueue.getCount(tid);
+        toFetch->iewInfo[tid].ldstqCount = ldstQueue.getCount(tid);
 
+        if (broadcast_free_entries) {
             toRename->iewInfo[tid].usedIQ = true;
             toRename->iewInfo[tid].freeIQEntries =
                 instQueue.numFreeEntries(tid);
@@ -2046,23 +2232,16 @@ DefaultIEW<Impl>::genShadow()
 {
     DPRINTF(BMT, "genShadowing\n");
     inShadow = true;
-    shadowIQ = instQueue.maxEntries[HPT] - instQueue.numBusyEntries(HPT);
-    shadowLQ = ldstQueue.maxLQEntries[HPT] - ldstQueue.numLoads(HPT);
-    shadowSQ = ldstQueue.maxSQEntries[HPT] - ldstQueue.numStores(HPT);
+    // the shadow lasts as long as a solo run could keep dispatching
+    shadowIQ = soloWindow->headroom(HPT, SoloWin::IQ);
+    shadowLQ = soloWindow->headroom(HPT, SoloWin::LQ);
+    shadowSQ = soloWindow->headroom(HPT, SoloWin::SQ);
 
+    // the shadowed loads, kept in order by the miss tables
     InstSeqNum start = (InstSeqNum) ~0, end = 0;
-
-    for (MissTable::const_iterator it = missTables.l2MissTable.begin();
-            it != missTables.l2MissTable.end(); it++) {
-        if (it->second.cacheLevel == 2 && it->second.tid == HPT) {
-            if (it->second.seqNum < start) {
-                start = it->second.seqNum;
-            }
-
-            if (it->second.seqNum > end) {
-                end = it->second.seqNum;
-            }
-        }
+    if (missTables.oldestLLLoad(HPT)) {
+        start = missTables.oldestLLLoad(HPT);
+        end = missTables.newestLLLoad(HPT);
     }
     bmt->clear(HPT);
     bmt->setRange(start, end);
@@ -2117,12 +2296,14 @@ DefaultIEW<Impl>::cycleDispatchEnd(ThreadID tid)
                 "VIQ[T%i]:%f\n",
                 HPT, instQueue.numBusyEntries(HPT),
                 LPT, instQueue.numBusyEntries(LPT),
-                head[tid] ? 1 : 0, tid, instQueue.VIQ[tid]);
+                head[tid] ? 1 : 0, tid,
+                soloWindow->occupancy(tid, SoloWin::IQ));
         if (head[tid]) {
             DPRINTF(DispatchBreakdown, "IQ head is Miss: %i\n",
                     missTables.isL1Miss(head[tid]->physEffAddr, no_use));
         }
-        DPRINTF(DispatchBreakdown, "VIQFull: %i\n", instQueue.VIQFull(tid));
+        DPRINTF(DispatchBreakdown, "VIQFull: %i\n",
+                soloWindow->full(tid, SoloWin::IQ));
     }
 
     if (fullSource[tid] == SlotConsm::FullSource::LQ) {
@@ -2130,38 +2311,53 @@ DefaultIEW<Impl>::cycleDispatchEnd(ThreadID tid)
                 "VLQ[T%i]:%f\n",
                 HPT, ldstQueue.numLoads(HPT),
                 LPT, ldstQueue.numLoads(LPT),
-                LQHead[tid] ? 1 : 0, tid, ldstQueue.getVLQ(tid));
+                LQHead[tid] ? 1 : 0, tid,
+                soloWindow->occupancy(tid, SoloWin::LQ));
         if (LQHead[tid]) {
             DPRINTF(DispatchBreakdown, "LQ head is Miss: %i\n",
                     missTables.isL1Miss(LQHead[tid]->physEffAddr, no_use));
         }
-        DPRINTF(DispatchBreakdown, "VLQFull: %i\n", ldstQueue.VLQFull(tid));
+        DPRINTF(DispatchBreakdown, "VLQFull: %i\n",
+                soloWindow->full(tid, SoloWin::LQ));
     }
     if (fullSource[tid] == SlotConsm::FullSource::SQ) {
         DPRINTF(DispatchBreakdown, "SQ[T%i]: %i, SQ[T%i]: %i, SQ has head: %i, "
                 "VSQ[T%i]:%f\n",
                 HPT, ldstQueue.numLoads(HPT),
                 LPT, ldstQueue.numLoads(LPT),
-                SQHead[tid] ? 1 : 0, tid, ldstQueue.getVSQ(tid));
+                SQHead[tid] ? 1 : 0, tid,
+                soloWindow->occupancy(tid, SoloWin::SQ));
         if (SQHead[tid]) {
             DPRINTF(DispatchBreakdown, "SQ head is Miss: %i\n",
                     missTables.isL1Miss(SQHead[tid]->physEffAddr, no_use));
         }
-        DPRINTF(DispatchBreakdown, "VSQFull: %i\n", ldstQueue.VSQFull(tid));
+        DPRINTF(DispatchBreakdown, "VSQFull: %i\n",
+                soloWindow->full(tid, SoloWin::SQ));
     }
 
     slotConsumer.vqState[tid][SlotConsm::FullSource::IQ] =
-            instQueue.VIQFull(tid) ?
+            soloWindow->full(tid, SoloWin::IQ) ?
             VQState::VQFull : VQState::VQNotFull;
 
     slotConsumer.vqState[tid][SlotConsm::FullSource::LQ] =
-            ldstQueue.VLQFull(tid) ?
+            soloWindow->full(tid, SoloWin::LQ) ?
             VQState::VQFull : VQState::VQNotFull;
 
     slotConsumer.vqState[tid][SlotConsm::FullSource::SQ] =
-            ldstQueue.VSQFull(tid) ?
+            soloWindow->full(tid, SoloWin::SQ) ?
             VQState::VQFull : VQState::VQNotFull;
 
+    switch (instQueue.issueBlocked(tid)) {
+      case IQ::BlockedByOthers:
+        slotConsumer.issueState[tid] = VQState::VQNotFull;
+        break;
+      case IQ::BlockedBySelf:
+        slotConsumer.issueState[tid] = VQState::VQFull;
+        break;
+      default:
+        slotConsumer.issueState[tid] = VQState::NoVQ;
+    }
+
     bool LB_to_rename;
     slotConsumer.cycleEnd(
             tid, dispatched, fullSource[tid], curCycleRow[tid],
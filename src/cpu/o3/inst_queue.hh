@@ -149,6 +149,10 @@ class InstructionQueue
     /** reassign issue prioirity for each thread. */
     void reassignIssuePrio(int newPrioVec[], int len);
 
+    /** Reassign the share of the issue width of each thread. */
+    void reassignIssuePortion(int newPortionVec[], int lenNewPortionVec,
+                              int newPortionDenominator);
+
     /** Sets active threads list. */
     void setActiveThreads(std::list<ThreadID> *at_ptr);
 
@@ -284,6 +288,9 @@ class InstructionQueue
     /** Returns the number of used entries for a thread. */
     unsigned getCount(ThreadID tid) { return count[tid]; };
 
+    /** Whether instructions in the IQ wait on a result of inst. */
+    bool hasDependents(DynInstPtr &inst);
+
     /** Debug function to print all instructions. */
     void printInsts();
 
@@ -629,14 +636,6 @@ class InstructionQueue
 
     const unsigned hptInitPriv;
 
-    std::array<float, Impl::MaxThreads> VIQ;
-
-    void incVIQ(ThreadID tid, int num);
-
-    bool VIQFull(ThreadID tid) {
-        return VIQ[tid] >= ((float) numEntries) - 0.1;
-    }
-
     DynInstPtr dummyInst;
 
     DynInstPtr &getHeadInst (ThreadID tid) {
@@ -647,16 +646,34 @@ class InstructionQueue
         return portion[HPT];
     }
 
-  private:
+    int getHPTIssuePortion() const {
+        return issuePortion[HPT];
+    }
 
-    const bool PTAVQ;
+    bool isIssuePolicyProgrammable() const {
+        return widthPartitioned;
+    }
+
+    /** Why ready instructions of a thread were left in the IQ. */
+    enum IssueBlock {
+        NotBlocked,
+        /** By the issue width quota or FUs busy with another thread. */
+        BlockedByOthers,
+        /** Only by FUs busy with the thread's own instructions. */
+        BlockedBySelf
+    };
+
+    /** Why ready instructions of the thread missed the last issue. */
+    IssueBlock issueBlocked(ThreadID tid) const {
+        return issueBlock[tid];
+    }
+
+  private:
 
     void commitInstCount(DynInstPtr inst, ThreadID tid);
 
     void insertInstCount(DynInstPtr inst, ThreadID tid);
 
-    std::array<int, Impl::MaxThreads> localWaitSlots;
-
   public:
 
     void mshrRejectMemInst(DynInstPtr &rejected_inst);
@@ -674,6 +691,19 @@ class InstructionQueue
     // Issue width per thread
     std::array<unsigned, Impl::MaxThreads> threadWidths;
 
+    /** Whether the issue width is split by issuePortion. */
+    bool widthPartitioned;
+
+    /** Share of the issue width of each thread. */
+    int issuePortion[Impl::MaxThreads];
+
+    int issueDenominator;
+
+    /** Set the issue width of each thread from its share. */
+    void updateThreadWidths();
+
+    std::array<IssueBlock, Impl::MaxThreads> issueBlock;
+
 };
 
 #endif //__CPU_O3_INST_QUEUE_HH__
@@ -103,8 +103,7 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
       sampleCycle(0),
       sampleTime(0),
       sampleRate((unsigned int) params->dumpWindowSize),
-      hptInitPriv(unsigned(float(numEntries) * params->hptIQPrivProp)),
-      PTAVQ(params->PTAVQ)
+      hptInitPriv(unsigned(float(numEntries) * params->hptIQPrivProp))
 {
     assert(fuPool);
 
@@ -145,6 +144,9 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
     }
 
 
+    threadWidths.fill(totalWidth);
+    issueBlock.fill(NotBlocked);
+
     std::string policy = params->smtIQPolicy;
 
     //Convert string to lowercase
@@ -206,14 +208,39 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
         assert(0 && "Invalid IQ Sharing Policy.Options Are:{Dynamic,"
                 "Partitioned, Threshold}");
     }
+
+    policy = params->smtIssueWidthPolicy;
+    std::transform(policy.begin(), policy.end(), policy.begin(),
+                   (int(*)(int)) tolower);
+
+    issueDenominator = 1024;
+    if (policy == "dynamic") {
+        widthPartitioned = false;
+        for (ThreadID tid = 0; tid < numThreads; tid++) {
+            issuePortion[tid] = issueDenominator / numThreads;
+        }
+    } else if (policy == "programmable") {
+        widthPartitioned = true;
+        issuePortion[HPT] = numThreads > 1 ?
+            int(params->hptIssuePrivProp * issueDenominator) :
+            issueDenominator;
+        for (ThreadID tid = 0; tid < numThreads; tid++) {
+            if (tid != HPT) {
+                issuePortion[tid] = (issueDenominator - issuePortion[HPT]) /
+                    std::max(numThreads - 1, 1);
+            }
+        }
+        updateThreadWidths();
+    } else {
+        fatal("Invalid SMT issue width policy %s, options are: "
+              "Dynamic, Programmable\n", params->smtIssueWidthPolicy);
+    }
+
     numThreadUsedEntries[0] = 0;
     numThreadUsedEntries[1] = 0;
     iqThreadUtil[0] = 0;
     iqThreadUtil[1] = 0;
     iqUtil = 0;
-
-    std::fill(VIQ.begin(), VIQ.end(), 0.0);
-    std::fill(localWaitSlots.begin(), localWaitSlots.end(), 0.0);
 }
 
 template <class Impl>
@@ -460,7 +487,6 @@ InstructionQueue<Impl>::resetState()
     //Initialize thread IQ counts
     for (ThreadID tid = 0; tid <numThreads; tid++) {
         count[tid] = 0;
-        VIQ[tid] = 0.0;
         instList[tid].clear();
         if (maxEntriesUpToDate) { // no portion assigned
             portion[tid] = denominator / numThreads;
@@ -499,7 +525,6 @@ InstructionQueue<Impl>::resetState()
     blockedMemInsts.clear();
     retryMemInsts.clear();
     wbOutstanding = 0;
-    std::fill(VIQ.begin(), VIQ.end(), 0.0);
 }
 
 template <class Impl>
@@ -626,12 +651,44 @@ InstructionQueue<Impl>::reassignPortion(int newPortionVec[],
         threadWidths[HPT] = std::min((unsigned) totalWidth - 1, threadWidths[HPT]);
         threadWidths[LPT] = totalWidth - threadWidths[HPT];
 
-    } else {
+    } else if (!widthPartitioned) {
         threadWidths[HPT] = totalWidth;
         threadWidths[LPT] = totalWidth;
     }
 }
 
+template <class Impl>
+void
+InstructionQueue<Impl>::reassignIssuePortion(int newPortionVec[],
+        int lenNewPortionVec, int newPortionDenominator)
+{
+    if (!widthPartitioned) {
+        return;
+    }
+
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        DPRINTF(ResourceAllocation, "Thread [%i] issue width portion: %i\n",
+                tid, newPortionVec[tid]);
+        issuePortion[tid] = newPortionVec[tid];
+    }
+    issueDenominator = newPortionDenominator;
+
+    updateThreadWidths();
+}
+
+template <class Impl>
+void
+InstructionQueue<Impl>::updateThreadWidths()
+{
+    // Every thread keeps at least one slot so that it cannot be starved
+    // of issue altogether.
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        threadWidths[tid] = std::max(
+            totalWidth * issuePortion[tid] / issueDenominator, 1u);
+        DPRINTF(IQ, "Thread [%i] issue width: %i\n", tid, threadWidths[tid]);
+    }
+}
+
 template <class Impl>
 void
 InstructionQueue<Impl>::reassignIssuePrio(int newPrioVec[],
@@ -766,6 +823,19 @@ InstructionQueue<Impl>::hasReadyInsts()
     return false;
 }
 
+template <class Impl>
+bool
+InstructionQueue<Impl>::hasDependents(DynInstPtr &inst)
+{
+    for (int i = 0; i < inst->numDestRegs(); ++i) {
+        if (!dependGraph.empty(inst->renamedDestRegIdx(i))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 template <class Impl>
 void
 InstructionQueue<Impl>::insert(DynInstPtr &new_inst)
@@ -978,6 +1048,7 @@ InstructionQueue<Impl>::scheduleReadyInsts()
     // FUs that handle it.
     int total_issued = 0;
     std::fill(issuedInsts.begin(), issuedInsts.end(), 0);
+    issueBlock.fill(NotBlocked);
     ListOrderIt order_it = listOrder.begin();
     ListOrderIt order_end_it = listOrder.end();
 
@@ -1020,7 +1091,7 @@ InstructionQueue<Impl>::scheduleReadyInsts()
         if (issuedInsts[tid] < threadWidths[tid]) {
             //<editor-fold desc="Get Op">
             if (op_class != No_OpClass) {
-                idx = fuPool->getUnit(op_class);
+                idx = fuPool->getUnit(op_class, tid);
                 issuing_inst->isFloating() ? fpAluAccesses++ : intAluAccesses++;
                 if (idx > -1) {
                     op_latency = fuPool->getOpLatency(op_class);
@@ -1097,11 +1168,17 @@ InstructionQueue<Impl>::scheduleReadyInsts()
             } else {
                 statFuBusy[op_class]++;
                 fuBusy[tid]++;
+                if (fuPool->busyWithOthers(op_class, tid)) {
+                    issueBlock[tid] = BlockedByOthers;
+                } else if (issueBlock[tid] == NotBlocked) {
+                    issueBlock[tid] = BlockedBySelf;
+                }
                 ++order_it;
             }
 
         } else {
             issueThreadBlockedCycles[tid]++;
+            issueBlock[tid] = BlockedByOthers;
             ++order_it;
         }
     }
@@ -1886,30 +1963,11 @@ InstructionQueue<Impl>::dumpUsedEntries()
     resetUsedEntries();
 }
 
-template <class Impl>
-void
-InstructionQueue<Impl>::incVIQ(ThreadID tid, int num) {
-    int inc = std::min((int)numEntries - (int) VIQ[tid], num);
-    if (PTAVQ) {
-        localWaitSlots[tid] += inc;
-        VIQ[tid] += localWaitSlots[tid];
-    } else {
-        VIQ[tid] += inc;
-    }
-}
-
 template <class Impl>
 void
 InstructionQueue<Impl>::commitInstCount(DynInstPtr inst, ThreadID tid) {
     freeEntries++;
-    float dec;
-    if (PTAVQ) {
-        dec = 1 + inst->waitSlots;
-    } else {
-        dec = VIQ[tid]/count[tid];
-    }
     count[tid]--;
-    VIQ[tid] = std::max(VIQ[tid] - dec, (float) 0.0);
 }
 
 template <class Impl>
@@ -1917,12 +1975,6 @@ void
 InstructionQueue<Impl>::insertInstCount(DynInstPtr inst, ThreadID tid) {
     freeEntries--;
     count[tid]++;
-    VIQ[tid] = std::min(1 + VIQ[tid], (float) numEntries);
-
-    if (PTAVQ && localWaitSlots[tid]) {
-        inst->waitSlots = localWaitSlots[tid];
-        localWaitSlots[tid] = 0;
-    }
 }
 
 template <class Impl>
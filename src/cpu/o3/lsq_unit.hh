@@ -614,23 +614,6 @@ class LSQUnit {
 
   public:
 
-    float VLQ, VSQ;
-
-    void incVLQ(float num) {
-        VLQ = std::min(num + VLQ, (float) LQEntries - 1);
-    }
-    void incVSQ(float num) {
-        VSQ = std::min(num + VSQ, (float) SQEntries - 1);
-    }
-
-    bool VLQFull() {
-        // note dummy entry in LSQ !
-        return VLQ >= ((float) LQEntries) - 1.1;
-    }
-    bool VSQFull() {
-        return VSQ >= ((float) SQEntries) - 1.1;
-    }
-
     unsigned blkSize;
 
     Addr blockAlign(Addr addr) {
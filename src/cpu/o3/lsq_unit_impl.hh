@@ -161,7 +161,8 @@ LSQUnit<Impl>::completeDataAccess(PacketPtr pkt)
         DPRINTF(MissTable, "T[%i] Remove L%i cache miss [0x%x] from L2 miss table.\n",
                 tid, it2->second.cacheLevel, phyAddress);
         ms.numL2DataMiss[tid]--;
-        l2_table.erase(it2);;
+        missTables.removeL2Miss(it2->second);
+        l2_table.erase(it2);
     } else if (it2 != l2_table.end()){
         it2->second.MSHRHits--;
     }
@@ -269,7 +270,6 @@ void
 LSQUnit<Impl>::resetState()
 {
     loads = stores = storesToWB = 0;
-    VLQ = VSQ = 0.0;
 
     loadHead = loadTail = 0;
 
@@ -558,7 +558,6 @@ LSQUnit<Impl>::insertLoad(DynInstPtr &load_inst)
     incrLdIdx(loadTail);
 
     ++loads;
-    incVLQ(1);
 }
 
 template <class Impl>
@@ -580,7 +579,6 @@ LSQUnit<Impl>::insertStore(DynInstPtr &store_inst)
     incrStIdx(storeTail);
 
     ++stores;
-    incVSQ(1);
 }
 
 template <class Impl>
@@ -805,6 +803,7 @@ LSQUnit<Impl>::executeLoad(DynInstPtr &inst)
 
     if (missTables.perThreadMSHRFull(1, true, lsqID, true)) {
         inst->memRefRejected = true;
+        missTables.noteMSHRReject(lsqID, cpu->curCycle());
         DPRINTF(MSHR, "Return because MSHR full.\n");
         return NoFault;
     }
@@ -864,6 +863,7 @@ LSQUnit<Impl>::executeStore(DynInstPtr &store_inst)
     if (missTables.perThreadMSHRFull(1, true, lsqID, false)) {
         DPRINTF(MSHR, "Return because MSHR full.\n");
         store_inst->memRefRejected = true;
+        missTables.noteMSHRReject(lsqID, cpu->curCycle());
         return NoFault;
     }
     store_inst->memRefRejected = false;
@@ -935,7 +935,6 @@ LSQUnit<Impl>::commitLoad()
 
     incrLdIdx(loadHead);
 
-    VLQ = std::max(VLQ - VLQ/loads, (float) 0.0);
     --loads;
 }
 
@@ -1238,7 +1237,6 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
         // Clear the smart pointer to make sure it is decremented.
         loadQueue[load_idx]->setSquashed();
         loadQueue[load_idx] = NULL;
-        VLQ = std::max(VLQ - VLQ/loads, (float) 0.0);
         --loads;
 
         // Inefficient!
@@ -1294,7 +1292,6 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
         }
 
         storeQueue[store_idx].req = NULL;
-        VSQ = std::max(VSQ - VSQ/stores, (float) 0.0);
         --stores;
 
         // Inefficient!
@@ -1394,7 +1391,6 @@ LSQUnit<Impl>::completeStore(int store_idx)
     if (store_idx == storeHead) {
         do {
             incrStIdx(storeHead);
-            VSQ = std::max(VSQ - VSQ/stores, (float) 0.0);
             --stores;
 
             if (stores > 0 && storeQueue[storeHead].inst->comTick) {
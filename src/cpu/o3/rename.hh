@@ -91,6 +91,7 @@ class DefaultRename : public SlotCounter<Impl>
     typedef typename CPUPol::Commit Commit;
 
     typedef typename CPUPol::Bmt Bmt;
+    typedef typename CPUPol::SoloWin SoloWin;
     typedef SlotConsumer<Impl> SlotConsm;
 
     // Typedefs from the ISA.
@@ -323,9 +324,10 @@ class DefaultRename : public SlotCounter<Impl>
     };
 
     /** A per-thread list of all destination register renames, used to either
-     * undo rename mappings or free old physical registers.
+     * undo rename mappings or free old physical registers.  The youngest
+     * rename is at the front.
      */
-    std::list<RenameHistory> historyBuffer[Impl::MaxThreads];
+    std::deque<RenameHistory> historyBuffer[Impl::MaxThreads];
 
     /** Pointer to CPU. */
     O3CPU *cpu;
@@ -526,6 +528,8 @@ class DefaultRename : public SlotCounter<Impl>
     /** Stat for total number of times that rename runs out of free registers
      * to use to rename. */
     Stats::Scalar renameFullRegistersEvents;
+    /** Stat for the times a thread reached its register quota. */
+    Stats::Vector renameRegQuotaEvents;
     /** Stat for total number of renamed destination registers. */
     Stats::Scalar renameRenamedOperands;
     /** Stat for total number of source register rename lookups. */
@@ -547,13 +551,126 @@ class DefaultRename : public SlotCounter<Impl>
 
     Stats::Scalar floatRegUtilization;
 
+  private:
+    /** Register classes that are split between threads. */
+    enum QuotaClass {
+        QuotaInt = 0,
+        QuotaFloat,
+        NumQuotaClasses
+    };
+
+    /** Quota class of a flattened destination register, or
+     * NumQuotaClasses if the class is not split. */
+    static QuotaClass quotaClass(RegIndex flat_reg);
+
+    /** Whether each thread may only hold its portion of the registers. */
+    bool regPartitioned;
+
+    /** Registers left for renaming once the architectural state of
+     * all threads is mapped. */
+    unsigned renamableRegs[NumQuotaClasses];
+
+    /** Registers left for renaming if the thread ran alone. */
+    unsigned soloRenamableRegs[NumQuotaClasses];
+
+    /** Registers each thread holds beyond its architectural state. */
+    unsigned regsInFlight[Impl::MaxThreads][NumQuotaClasses];
+
+    /** Most registers each thread may hold beyond its architectural
+     * state. */
+    unsigned maxRegs[Impl::MaxThreads][NumQuotaClasses];
+
+    int regPortion[Impl::MaxThreads];
+
+    int regDenominator;
+
+    /** Recompute maxRegs from the portions. */
+    void updateMaxRegs();
+
+    /** Whether the thread may rename the destinations of the inst. */
+    bool withinRegQuota(ThreadID tid, DynInstPtr &inst) const;
+
+    /** Count a register taken (n = 1) or given back (n = -1). */
+    void holdReg(ThreadID tid, RegIndex flat_reg, int n);
+
+    /** Tell slot accounting whether a solo run would have stalled on
+     * registers too. */
+    void setRegState(ThreadID tid, unsigned int_regs, unsigned fp_regs);
+
   public:
-    /** The number of available free physical regs for each thread
-     * and its initial value indicates the maximum number. */
-    unsigned nrFreeRegs[Impl::MaxThreads];
+    /** Reassign the portion of renamable registers of each thread. A
+     * thread above its new quota stalls until it drains below it. */
+    void reassignRegPortion(int newPortionVec[],
+            int lenNewPortionVec, int newPortionDenominator);
+
+    int getHPTRegPortion() const { return regPortion[HPT]; }
+
+    bool isRegPolicyProgrammable() const { return regPartitioned; }
+
+  private:
+    /**
+     * Snapshot of a thread's rename map taken right after a control
+     * instruction renamed. A squash back to that instruction restores
+     * the map and frees the registers of younger renames at once,
+     * instead of undoing the younger renames one by one.
+     */
+    struct RenameCheckpoint {
+        /** The control instruction the snapshot was taken after. */
+        InstSeqNum instSeqNum;
+        /** The rename map right after the instruction renamed. */
+        typename RenameMap::Snapshot map;
+        /** Physical registers renamed to by younger instructions, up
+         * to the next checkpoint, one bit per register. */
+        std::vector<uint64_t> allocated;
+        /** Number of bits in allocated for each quota class. */
+        unsigned allocatedRegs[NumQuotaClasses];
+        /** History entries of younger instructions, up to the next
+         * checkpoint. */
+        size_t historyEntries;
+    };
+
+    /** Maximum number of checkpoints per thread, 0 if disabled. */
+    const unsigned maxCheckpoints;
+
+    /** Per-thread ring of checkpoints, the oldest at ckptHead. */
+    std::vector<RenameCheckpoint> checkpoints[Impl::MaxThreads];
+
+    unsigned ckptHead[Impl::MaxThreads];
+
+    unsigned numCkpts[Impl::MaxThreads];
+
+    /** The i-th oldest live checkpoint of a thread. */
+    RenameCheckpoint &
+    checkpoint(ThreadID tid, unsigned i)
+    {
+        return checkpoints[tid][(ckptHead[tid] + i) % maxCheckpoints];
+    }
+
+    /** Snapshot the rename map after a control instruction renamed. */
+    void takeCheckpoint(DynInstPtr &inst, ThreadID tid);
+
+    /** Record a rename in the youngest checkpoint. */
+    void trackRename(ThreadID tid, const RenameHistory &entry);
+
+    /** Forget a squashed rename recorded by trackRename(). */
+    void untrackRename(ThreadID tid, const RenameHistory &entry);
+
+    /** Drop the checkpoints of squashed instructions, handing what they
+     * track to the checkpoint before them. */
+    void squashCheckpoints(InstSeqNum squashed_seq_num, ThreadID tid);
 
-    void setNrFreeRegs(unsigned _nrFreeRegs[], ThreadID _numThreads);
+    /** Roll the thread back to its youngest checkpoint. */
+    void restoreCheckpoint(ThreadID tid);
 
+    /** Drop the checkpoints of committed instructions. */
+    void releaseCheckpoints(InstSeqNum inst_seq_num, ThreadID tid);
+
+    /** Stat for the checkpoints taken. */
+    Stats::Scalar renameCheckpointsTaken;
+    /** Stat for the squashes served from a checkpoint. */
+    Stats::Scalar renameCheckpointRestores;
+
+  public:
     uint64_t numFreeIntEntries;
 
     uint64_t numFreeFloatEntries;
@@ -617,6 +734,15 @@ class DefaultRename : public SlotCounter<Impl>
 
     void setBmt(Bmt *_bmt) {bmt = _bmt;}
 
+  private:
+
+    /** Solo-run back-end model, fed with ROB stalls and renames. */
+    SoloWin *soloWindow;
+
+  public:
+
+    void setSoloWindow(SoloWin *_solo) { soloWindow = _solo; }
+
   public:
     uint64_t numROBFull[Impl::MaxThreads];
     uint64_t numLQFull[Impl::MaxThreads];
@@ -653,8 +779,6 @@ class DefaultRename : public SlotCounter<Impl>
     std::array<bool, Impl::MaxThreads> tailSI;
     std::array<bool, Impl::MaxThreads> tailSINext;
 
-    std::array<float, Impl::MaxThreads> numVROB;
-
     std::array<unsigned, Impl::MaxThreads> toROBNum;
 
   public:
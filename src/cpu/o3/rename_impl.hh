@@ -45,10 +45,12 @@
 #ifndef __CPU_O3_RENAME_IMPL_HH__
 #define __CPU_O3_RENAME_IMPL_HH__
 
+#include <algorithm>
 #include <list>
 
 #include "arch/isa_traits.hh"
 #include "arch/registers.hh"
+#include "base/host_profile.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/rename.hh"
 #include "mem/cache/miss_table.hh"
@@ -59,6 +61,7 @@
 #include "debug/Pard.hh"
 #include "debug/FmtSlot.hh"
 #include "debug/RenameBreakdown.hh"
+#include "debug/ResourceAllocation.hh"
 #include "debug/LB.hh"
 #include "debug/BMT.hh"
 #include "debug/InstPass.hh"
@@ -87,6 +90,7 @@ DefaultRename<Impl>::DefaultRename(O3CPU *_cpu, DerivO3CPUParams *params)
       numThreads((ThreadID) params->numThreads),
       maxPhysicalRegs((PhysRegIndex) (params->numPhysIntRegs + params->numPhysFloatRegs
                       + params->numPhysCCRegs)),
+      maxCheckpoints(params->renameCheckpoints),
       BLBlocal(false),
       blockCycles(0),
       slotConsumer (params, params->renameWidth, name()),
@@ -100,9 +104,56 @@ DefaultRename<Impl>::DefaultRename(O3CPU *_cpu, DerivO3CPUParams *params)
     // @todo: Make into a parameter.
     skidBufferMax = (unsigned) decodeToRenameDelay + 1;
 
-    for (int i = 0; i < sizeof(this->nrFreeRegs) / sizeof(this->nrFreeRegs[0]); i++) {
-        nrFreeRegs[i] = params->numPhysIntRegs;
+    std::string policy = params->smtRegPolicy;
+    std::transform(policy.begin(), policy.end(), policy.begin(),
+                   (int(*)(int)) tolower);
+
+    if (policy == "dynamic") {
+        regPartitioned = false;
+    } else if (policy == "programmable") {
+        regPartitioned = true;
+    } else {
+        fatal("Invalid SMT register sharing policy %s, options are: "
+              "Dynamic, Programmable\n", params->smtRegPolicy);
+    }
+
+    // The architectural state of every thread stays mapped, so only
+    // the rest of each register file is shared out.
+    const unsigned phys_regs[NumQuotaClasses] = {
+        params->numPhysIntRegs, params->numPhysFloatRegs };
+    const unsigned arch_regs[NumQuotaClasses] = {
+        TheISA::NumIntRegs, TheISA::NumFloatRegs };
+
+    for (int c = 0; c < NumQuotaClasses; c++) {
+        fatal_if(phys_regs[c] <= numThreads * arch_regs[c],
+                 "%s: %d physical registers cannot rename for %d threads\n",
+                 name(), phys_regs[c], numThreads);
+        renamableRegs[c] = phys_regs[c] - numThreads * arch_regs[c];
+        soloRenamableRegs[c] = phys_regs[c] - arch_regs[c];
+    }
+
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        checkpoints[tid].resize(maxCheckpoints);
+        for (auto &ckpt : checkpoints[tid]) {
+            ckpt.allocated.resize((maxPhysicalRegs + 63) / 64);
+        }
+        ckptHead[tid] = 0;
+        numCkpts[tid] = 0;
+    }
+
+    regDenominator = 1024;
+    if (numThreads > 1) {
+        regPortion[HPT] = int(params->hptRegPrivProp * regDenominator);
+        for (ThreadID tid = 0; tid < numThreads; tid++) {
+            if (tid != HPT) {
+                regPortion[tid] =
+                    (regDenominator - regPortion[HPT]) / (numThreads - 1);
+            }
+        }
+    } else {
+        regPortion[HPT] = regDenominator;
     }
+    updateMaxRegs();
 }
 
 template <class Impl>
@@ -180,6 +231,19 @@ DefaultRename<Impl>::regStats()
         .name(name() + ".FullRegisterEvents")
         .desc("Number of times there has been no free registers")
         .prereq(renameFullRegistersEvents);
+    renameRegQuotaEvents
+        .init(numThreads)
+        .name(name() + ".RegQuotaEvents")
+        .desc("Number of times rename has blocked due to register quota")
+        .flags(Stats::total);
+    renameCheckpointsTaken
+        .name(name() + ".CheckpointsTaken")
+        .desc("Number of rename map checkpoints taken")
+        .prereq(renameCheckpointsTaken);
+    renameCheckpointRestores
+        .name(name() + ".CheckpointRestores")
+        .desc("Number of squashes undone from a rename map checkpoint")
+        .prereq(renameCheckpointRestores);
     renameRenamedOperands
         .name(name() + ".RenamedOperands")
         .desc("Number of destination operands rename has renamed")
@@ -357,6 +421,12 @@ DefaultRename<Impl>::resetStage()
 
         emptyROB[tid] = true;
 
+        for (int c = 0; c < NumQuotaClasses; c++) {
+            regsInFlight[tid][c] = 0;
+        }
+        ckptHead[tid] = 0;
+        numCkpts[tid] = 0;
+
         stalls[tid].iew = false;
         serializeInst[tid] = NULL;
         tailSI[tid] = false;
@@ -367,7 +437,6 @@ DefaultRename<Impl>::resetStage()
         storesInProgress[tid] = 0;
 
         serializeOnNextInst[tid] = false;
-        numVROB[tid] = 0.0;
     }
     clearFull();
 }
@@ -502,6 +571,9 @@ DefaultRename<Impl>::squash(const InstSeqNum &squash_seq_num, ThreadID tid) {
 
     squashedThisCycle[tid] = true;
 
+    // a solo run squashes the same instructions
+    soloWindow->squash(tid);
+
     if (HPT == tid) {
         shine("squash");
         toIEW->shine = true;
@@ -512,6 +584,8 @@ template <class Impl>
 void
 DefaultRename<Impl>::tick()
 {
+    HOST_PROFILE("o3.rename");
+
     clearLocalSignals();
     wroteToTimeBuffer = false;
 
@@ -798,6 +872,8 @@ DefaultRename<Impl>::renameInsts(ThreadID tid)
     }
 
     int renamed_insts = 0;
+    unsigned renamed_loads = 0;
+    unsigned renamed_stores = 0;
 
     //<editor-fold desc="Main loop to rename instructions">
     while (insts_available > 0 &&  toIEWIndex < renameWidth) {
@@ -830,16 +906,21 @@ DefaultRename<Impl>::renameInsts(ThreadID tid)
 
         // Check here to make sure there are enough destination registers
         // to rename to.  Otherwise block.
+        bool within_quota = withinRegQuota(tid, inst);
         if (!(renameMap[tid]->canRename(inst->numIntDestRegs(),
                                         inst->numFPDestRegs(),
                                         inst->numCCDestRegs())
-              && nrFreeRegs[tid] >= inst->numIntDestRegs())) { // can handle 0
+              && within_quota)) {
             DPRINTF(RenameBreakdown, "Blocking due to lack of free "
                     "physical registers to rename to.\n");
             blockThisCycle = true;
             insts_to_rename.push_front(inst);
             ++renameFullRegistersEvents;
+            if (!within_quota) {
+                ++renameRegQuotaEvents[tid];
+            }
             fullSource[tid] = SlotConsm::Register;
+            setRegState(tid, inst->numIntDestRegs(), inst->numFPDestRegs());
             break;
         }
 
@@ -895,11 +976,17 @@ DefaultRename<Impl>::renameInsts(ThreadID tid)
 
         renameDestRegs(inst, inst->threadNumber);
 
+        if (maxCheckpoints && inst->isControl()) {
+            takeCheckpoint(inst, tid);
+        }
+
         if (inst->isLoad()) {
             loadsInProgress[tid]++;
+            ++renamed_loads;
         }
         if (inst->isStore()) {
             storesInProgress[tid]++;
+            ++renamed_stores;
         }
         ++renamed_insts;
 
@@ -919,6 +1006,8 @@ DefaultRename<Impl>::renameInsts(ThreadID tid)
 
     instsInProgress[tid] += renamed_insts;
     renameRenamedInsts += renamed_insts;
+    soloWindow->dispatched(tid, renamed_insts, renamed_loads,
+                           renamed_stores);
 
     if (HPT == tid && inShadow) {
         inst->inShadowROB = true;
@@ -1149,8 +1238,7 @@ template <class Impl>
 void
 DefaultRename<Impl>::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
 {
-    typename std::list<RenameHistory>::iterator hb_it =
-        historyBuffer[tid].begin();
+    squashCheckpoints(squashed_seq_num, tid);
 
     // After a syscall squashes everything, the history buffer may be empty
     // but the ROB may still be squashing instructions.
@@ -1158,11 +1246,17 @@ DefaultRename<Impl>::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
         return;
     }
 
+    if (numCkpts[tid] &&
+        checkpoint(tid, numCkpts[tid] - 1).instSeqNum == squashed_seq_num) {
+        restoreCheckpoint(tid);
+        return;
+    }
+
     // Go through the most recent instructions, undoing the mappings
     // they did and freeing up the registers.
     while (!historyBuffer[tid].empty() &&
-           hb_it->instSeqNum > squashed_seq_num) {
-        assert(hb_it != historyBuffer[tid].end());
+           historyBuffer[tid].front().instSeqNum > squashed_seq_num) {
+        RenameHistory *hb_it = &historyBuffer[tid].front();
 
         DPRINTF(Rename, "[tid:%u]: Removing history entry with sequence "
                 "number %i.\n", tid, hb_it->instSeqNum);
@@ -1180,10 +1274,12 @@ DefaultRename<Impl>::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
 
             // Put the renamed physical register back on the free list.
             freeList->addReg(hb_it->newPhysReg);
-            nrFreeRegs[tid]++;
+            holdReg(tid, hb_it->archReg, -1);
         }
 
-        historyBuffer[tid].erase(hb_it++);
+        untrackRename(tid, *hb_it);
+
+        historyBuffer[tid].pop_front();
 
         ++renameUndoneMaps;
     }
@@ -1197,15 +1293,12 @@ DefaultRename<Impl>::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
             "history buffer %u (size=%i), until [sn:%lli].\n",
             tid, tid, historyBuffer[tid].size(), inst_seq_num);
 
-    typename std::list<RenameHistory>::iterator hb_it =
-        historyBuffer[tid].end();
-
-    --hb_it;
+    releaseCheckpoints(inst_seq_num, tid);
 
     if (historyBuffer[tid].empty()) {
         DPRINTF(Rename, "[tid:%u]: History buffer is empty.\n", tid);
         return;
-    } else if (hb_it->instSeqNum > inst_seq_num) {
+    } else if (historyBuffer[tid].back().instSeqNum > inst_seq_num) {
         DPRINTF(Rename, "[tid:%u]: Old sequence number encountered.  Ensure "
                 "that a syscall happened recently.\n", tid);
         return;
@@ -1216,8 +1309,8 @@ DefaultRename<Impl>::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
     // rename histories if they did not have destination registers that were
     // renamed.
     while (!historyBuffer[tid].empty() &&
-           hb_it != historyBuffer[tid].end() &&
-           hb_it->instSeqNum <= inst_seq_num) {
+           historyBuffer[tid].back().instSeqNum <= inst_seq_num) {
+        RenameHistory *hb_it = &historyBuffer[tid].back();
 
         DPRINTF(Rename, "[tid:%u]: Freeing up older rename of reg %i, "
                 "[sn:%lli].\n",
@@ -1228,12 +1321,12 @@ DefaultRename<Impl>::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
         // the old one.
         if (hb_it->newPhysReg != hb_it->prevPhysReg) {
             freeList->addReg(hb_it->prevPhysReg);
-            nrFreeRegs[tid]++;
+            holdReg(tid, hb_it->archReg, -1);
         }
 
         ++renameCommittedMaps;
 
-        historyBuffer[tid].erase(hb_it--);
+        historyBuffer[tid].pop_back();
     }
 }
 
@@ -1323,8 +1416,6 @@ DefaultRename<Impl>::renameDestRegs(DynInstPtr &inst, ThreadID tid)
             flat_rel_dest_reg = tc->flattenIntIndex(rel_dest_reg);
             rename_result = map->renameInt(flat_rel_dest_reg);
             flat_uni_dest_reg = flat_rel_dest_reg;  // 1:1 mapping
-            nrFreeRegs[tid]--;
-            assert(nrFreeRegs[tid] >= 0);
             break;
 
           case FloatRegClass:
@@ -1366,6 +1457,11 @@ DefaultRename<Impl>::renameDestRegs(DynInstPtr &inst, ThreadID tid)
 
         historyBuffer[tid].push_front(hb_entry);
 
+        if (rename_result.first != rename_result.second) {
+            holdReg(tid, flat_uni_dest_reg, 1);
+        }
+        trackRename(tid, hb_entry);
+
         DPRINTF(Rename, "[tid:%u]: Adding instruction to history buffer "
                 "(size=%i), [sn:%lli].\n",tid,
                 historyBuffer[tid].size(),
@@ -1507,7 +1603,7 @@ DefaultRename<Impl>::checkStall(ThreadID tid)
         fullSource[tid] = SlotConsm::ROB;
         ret_val = true;
 
-        toIEW->incVROB[tid] = true;
+        soloWindow->stalled(tid, renameWidth);
 
         if (tid == HPT) {
             DPRINTF(RenameBreakdown, "HPT stall because no ROB.\n");
@@ -1515,6 +1611,8 @@ DefaultRename<Impl>::checkStall(ThreadID tid)
 
     } else if (renameMap[tid]->numFreeEntries() <= 0) {
         fullSource[tid] = SlotConsm::Register;
+        setRegState(tid, renameMap[tid]->numFreeIntEntries() ? 0 : 1,
+                    renameMap[tid]->numFreeFloatEntries() ? 0 : 1);
         DPRINTF(Rename,"[tid:%i]: Stall: RenameMap has 0 free entries.\n", tid);
         ret_val = true;
     } else if (renameStatus[tid] == SerializeStall &&
@@ -1558,9 +1656,12 @@ DefaultRename<Impl>::readFreeEntries(ThreadID tid)
         maxEntries[tid].robEntries = fromCommit->commitInfo[tid].maxROBEntries;
         busyEntries[tid].robEntries = fromCommit->commitInfo[tid].busyROBEntries;
         ROBHead[tid] = fromCommit->commitInfo[tid].ROBHead;
-        numVROB[tid] = fromCommit->commitInfo[tid].numVROB;
     }
 
+    // instructions on their way to the ROB already occupy it
+    soloWindow->setOccupancy(tid, SoloWin::ROB, busyEntries[tid].robEntries +
+                             toIEWNum[tid] + toROBNum[tid]);
+
     LQHead[tid] = fromIEW->iewInfo[tid].LQHead;
     SQHead[tid] = fromIEW->iewInfo[tid].SQHead;
 
@@ -1727,7 +1828,7 @@ template <class Impl>
 void
 DefaultRename<Impl>::dumpHistory()
 {
-    typename std::list<RenameHistory>::iterator buf_it;
+    typename std::deque<RenameHistory>::iterator buf_it;
 
     for (ThreadID tid = 0; tid < numThreads; tid++) {
 
@@ -1745,16 +1846,220 @@ DefaultRename<Impl>::dumpHistory()
 
 template <class Impl>
 void
-DefaultRename<Impl>::setNrFreeRegs(unsigned _nrFreeRegs[], ThreadID _numThreads)
+DefaultRename<Impl>::takeCheckpoint(DynInstPtr &inst, ThreadID tid)
+{
+    if (numCkpts[tid] == maxCheckpoints) {
+        return;
+    }
+
+    RenameCheckpoint &ckpt = checkpoint(tid, numCkpts[tid]++);
+    ckpt.instSeqNum = inst->seqNum;
+    renameMap[tid]->checkpoint(ckpt.map);
+    std::fill(ckpt.allocated.begin(), ckpt.allocated.end(), 0);
+    std::fill(std::begin(ckpt.allocatedRegs), std::end(ckpt.allocatedRegs), 0);
+    ckpt.historyEntries = 0;
+
+    ++renameCheckpointsTaken;
+
+    DPRINTF(Rename, "[tid:%u]: Checkpoint %i taken after [sn:%lli].\n",
+            tid, numCkpts[tid] - 1, inst->seqNum);
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::trackRename(ThreadID tid, const RenameHistory &entry)
+{
+    if (!numCkpts[tid]) {
+        return;
+    }
+
+    RenameCheckpoint &ckpt = checkpoint(tid, numCkpts[tid] - 1);
+    ++ckpt.historyEntries;
+    if (entry.newPhysReg != entry.prevPhysReg) {
+        ckpt.allocated[entry.newPhysReg / 64] |=
+            uint64_t(1) << (entry.newPhysReg % 64);
+        QuotaClass c = quotaClass(entry.archReg);
+        if (c != NumQuotaClasses) {
+            ++ckpt.allocatedRegs[c];
+        }
+    }
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::untrackRename(ThreadID tid, const RenameHistory &entry)
 {
-    assert(_numThreads == this->numThreads);
-    for (ThreadID tid = 0; tid < _numThreads; ++tid) {
-        // Use `+=' to work around with the pre-assignment for architectual regs.
-        // nrFreeRegs[tid] might become negtive in that procedure.
-        nrFreeRegs[tid] += _nrFreeRegs[tid];
+    if (!numCkpts[tid]) {
+        return;
     }
-    // TODO Support set in runtime, which needs more checks for correctness.
-    // TODO Support more register classes.
+
+    RenameCheckpoint &ckpt = checkpoint(tid, numCkpts[tid] - 1);
+    assert(ckpt.historyEntries);
+    --ckpt.historyEntries;
+    if (entry.newPhysReg != entry.prevPhysReg) {
+        ckpt.allocated[entry.newPhysReg / 64] &=
+            ~(uint64_t(1) << (entry.newPhysReg % 64));
+        QuotaClass c = quotaClass(entry.archReg);
+        if (c != NumQuotaClasses) {
+            --ckpt.allocatedRegs[c];
+        }
+    }
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::squashCheckpoints(InstSeqNum squashed_seq_num,
+                                       ThreadID tid)
+{
+    while (numCkpts[tid] &&
+           checkpoint(tid, numCkpts[tid] - 1).instSeqNum > squashed_seq_num) {
+        RenameCheckpoint &squashed = checkpoint(tid, --numCkpts[tid]);
+        if (!numCkpts[tid]) {
+            break;
+        }
+
+        RenameCheckpoint &prev = checkpoint(tid, numCkpts[tid] - 1);
+        for (size_t w = 0; w < prev.allocated.size(); w++) {
+            prev.allocated[w] |= squashed.allocated[w];
+        }
+        for (int c = 0; c < NumQuotaClasses; c++) {
+            prev.allocatedRegs[c] += squashed.allocatedRegs[c];
+        }
+        prev.historyEntries += squashed.historyEntries;
+    }
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::restoreCheckpoint(ThreadID tid)
+{
+    RenameCheckpoint &ckpt = checkpoint(tid, numCkpts[tid] - 1);
+
+    DPRINTF(Rename, "[tid:%u]: Restoring checkpoint of [sn:%lli], "
+            "undoing %i renames.\n", tid, ckpt.instSeqNum,
+            ckpt.historyEntries);
+
+    renameMap[tid]->restore(ckpt.map);
+    freeList->addRegs(ckpt.allocated);
+    for (int c = 0; c < NumQuotaClasses; c++) {
+        assert(regsInFlight[tid][c] >= ckpt.allocatedRegs[c]);
+        regsInFlight[tid][c] -= ckpt.allocatedRegs[c];
+    }
+
+    assert(ckpt.historyEntries <= historyBuffer[tid].size());
+    historyBuffer[tid].erase(historyBuffer[tid].begin(),
+                             historyBuffer[tid].begin() +
+                             ckpt.historyEntries);
+    renameUndoneMaps += ckpt.historyEntries;
+    ++renameCheckpointRestores;
+
+    // The control instruction itself is still in flight, so keep its
+    // checkpoint for a later squash to the same point.
+    std::fill(ckpt.allocated.begin(), ckpt.allocated.end(), 0);
+    std::fill(std::begin(ckpt.allocatedRegs), std::end(ckpt.allocatedRegs), 0);
+    ckpt.historyEntries = 0;
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::releaseCheckpoints(InstSeqNum inst_seq_num,
+                                        ThreadID tid)
+{
+    while (numCkpts[tid] && checkpoint(tid, 0).instSeqNum <= inst_seq_num) {
+        ckptHead[tid] = (ckptHead[tid] + 1) % maxCheckpoints;
+        --numCkpts[tid];
+    }
+}
+
+template <class Impl>
+typename DefaultRename<Impl>::QuotaClass
+DefaultRename<Impl>::quotaClass(RegIndex flat_reg)
+{
+    switch (regIdxToClass(flat_reg)) {
+      case IntRegClass:
+        return QuotaInt;
+      case FloatRegClass:
+        return QuotaFloat;
+      default:
+        return NumQuotaClasses;
+    }
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::updateMaxRegs()
+{
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        for (int c = 0; c < NumQuotaClasses; c++) {
+            unsigned quota = uint64_t(renamableRegs[c]) * regPortion[tid] /
+                regDenominator;
+            // a thread must always be able to rename a whole instruction
+            maxRegs[tid][c] =
+                std::max(quota, (unsigned) TheISA::MaxInstDestRegs);
+        }
+        DPRINTF(Pard, "Thread [%i] register quota: int %d, float %d\n",
+                tid, maxRegs[tid][QuotaInt], maxRegs[tid][QuotaFloat]);
+    }
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::reassignRegPortion(int newPortionVec[],
+        int lenNewPortionVec, int newPortionDenominator)
+{
+    if (!regPartitioned) {
+        return;
+    }
+
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        DPRINTF(ResourceAllocation, "Thread [%i] register portion: %i\n",
+                tid, newPortionVec[tid]);
+        regPortion[tid] = newPortionVec[tid];
+    }
+    regDenominator = newPortionDenominator;
+
+    updateMaxRegs();
+}
+
+template <class Impl>
+bool
+DefaultRename<Impl>::withinRegQuota(ThreadID tid, DynInstPtr &inst) const
+{
+    if (!regPartitioned) {
+        return true;
+    }
+
+    return regsInFlight[tid][QuotaInt] + inst->numIntDestRegs() <=
+        maxRegs[tid][QuotaInt] &&
+        regsInFlight[tid][QuotaFloat] + inst->numFPDestRegs() <=
+        maxRegs[tid][QuotaFloat];
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::holdReg(ThreadID tid, RegIndex flat_reg, int n)
+{
+    QuotaClass c = quotaClass(flat_reg);
+    if (c == NumQuotaClasses) {
+        return;
+    }
+
+    assert(n > 0 || regsInFlight[tid][c] > 0);
+    regsInFlight[tid][c] += n;
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::setRegState(ThreadID tid, unsigned int_regs,
+        unsigned fp_regs)
+{
+    bool solo_full =
+        regsInFlight[tid][QuotaInt] + int_regs > soloRenamableRegs[QuotaInt] ||
+        regsInFlight[tid][QuotaFloat] + fp_regs >
+        soloRenamableRegs[QuotaFloat];
+
+    slotConsumer.regState[tid] =
+        solo_full ? VQState::VQFull : VQState::VQNotFull;
 }
 
 template <class Impl>
@@ -1940,7 +2245,8 @@ DefaultRename<Impl>::genShadow()
             calcOwnLQEntries(HPT), calcOwnLQEntries(LPT));
 
     inShadow = true;
-    shadowROB = maxEntries[HPT].robEntries - calcOwnROBEntries(HPT);
+    // the shadow lasts as long as a solo run could keep dispatching
+    shadowROB = soloWindow->headroom(HPT, SoloWin::ROB);
 
     InstSeqNum start = ~0, end = 0;
 
@@ -2080,17 +2386,14 @@ DefaultRename<Impl>::getQHeadState(ThreadID tid)
         }
     }
 
-    int in_flight = toIEWNum[tid] + toROBNum[tid];
-    float calculated_VROB = numVROB[tid] + in_flight;
-    bool VROB_full = calculated_VROB > maxEntries[tid].robEntries - 0.1;
+    bool VROB_full = soloWindow->full(tid, SoloWin::ROB);
     slotConsumer.vqState[tid][SlotConsm::FullSource::ROB] =
             VROB_full ? VQState::VQFull : VQState::VQNotFull;
     if (!VROB_full) {
-        DPRINTF(missTry3, "ROB[T%i] from commit is %i, %i in flight\n", tid,
-                busyEntries[tid].robEntries, in_flight);
-        DPRINTF(missTry3, "VROB[T%i] from commit is %f, %i in flight\n", tid,
-                numVROB[tid], in_flight);
-        DPRINTF(missTry3, "VROB[T%i] is%s full\n", tid, VROB_full ? "" : " not");
+        DPRINTF(missTry3, "ROB[T%i] from commit is %i\n", tid,
+                busyEntries[tid].robEntries);
+        DPRINTF(missTry3, "VROB[T%i] is %f, not full\n", tid,
+                soloWindow->occupancy(tid, SoloWin::ROB));
     }
 
     if (slotConsumer.queueHeadState[tid][SlotConsm::FullSource::ROB]
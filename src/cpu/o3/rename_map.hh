@@ -49,6 +49,7 @@
 #ifndef __CPU_O3_RENAME_MAP_HH__
 #define __CPU_O3_RENAME_MAP_HH__
 
+#include <algorithm>
 #include <iostream>
 #include <utility>
 #include <vector>
@@ -144,6 +145,19 @@ class SimpleRenameMap
         map[arch_reg] = phys_reg;
     }
 
+    /** Copy all mappings out, for a later restore(). */
+    void checkpoint(std::vector<PhysRegIndex> &snapshot) const
+    {
+        snapshot.assign(map.begin(), map.end());
+    }
+
+    /** Replace all mappings with ones saved by checkpoint(). */
+    void restore(const std::vector<PhysRegIndex> &snapshot)
+    {
+        assert(snapshot.size() == map.size());
+        std::copy(snapshot.begin(), snapshot.end(), map.begin());
+    }
+
     /** Return the number of free entries on the associated free list. */
     unsigned numFreeEntries() const { return freeList->numFreeRegs(); }
 };
@@ -183,6 +197,14 @@ class UnifiedRenameMap
 
     typedef SimpleRenameMap::RenameInfo RenameInfo;
 
+    /** The mappings of all register classes at one point in time. */
+    struct Snapshot
+    {
+        std::vector<PhysRegIndex> intMap;
+        std::vector<PhysRegIndex> floatMap;
+        std::vector<PhysRegIndex> ccMap;
+    };
+
     /** Default constructor.  init() must be called prior to use. */
     UnifiedRenameMap() : regFile(nullptr) {};
 
@@ -348,6 +370,25 @@ class UnifiedRenameMap
         ccMap.setEntry(arch_reg, phys_reg);
     }
 
+    /**
+     * Save all mappings.  The snapshot's storage is reused when it is
+     * taken again, so snapshots can be kept in a pool.
+     */
+    void checkpoint(Snapshot &snapshot) const
+    {
+        intMap.checkpoint(snapshot.intMap);
+        floatMap.checkpoint(snapshot.floatMap);
+        ccMap.checkpoint(snapshot.ccMap);
+    }
+
+    /** Roll all mappings back to a snapshot. */
+    void restore(const Snapshot &snapshot)
+    {
+        intMap.restore(snapshot.intMap);
+        floatMap.restore(snapshot.floatMap);
+        ccMap.restore(snapshot.ccMap);
+    }
+
     /**
      * Return the minimum number of free entries across all of the
      * register classes.  The minimum is used so we guarantee that
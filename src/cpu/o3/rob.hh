@@ -406,12 +406,6 @@ class ROB
     unsigned sampleRate;
 
     const unsigned hptInitPriv;
-
-    std::array<float, Impl::MaxThreads> VROB;
-
-    void incVROB(ThreadID tid, int num);
-
-    bool VROBFull(ThreadID tid);
 };
 
 #endif //__CPU_O3_ROB_HH__
@@ -52,10 +52,10 @@
 #include "debug/ROB.hh"
 #include "debug/Pard.hh"
 #include "debug/FmtCtrl.hh"
-#include "debug/missTry.hh"
 #include "debug/ResourceAllocation.hh"
 #include "params/DerivO3CPU.hh"
 #include "cpu/o3/log.hh"
+#include "mem/cache/miss_table.hh"
 
 using namespace std;
 
@@ -147,7 +147,6 @@ ROB<Impl>::resetState()
         threadEntries[tid] = 0;
         squashIt[tid] = instList[tid].end();
         squashedSeqNum[tid] = 0;
-        VROB[tid] = 0;
     }
     numInstsInROB = 0;
 
@@ -271,7 +270,6 @@ ROB<Impl>::insertInst(DynInstPtr &inst)
     inst->setInROB();
 
     ++numInstsInROB;
-    VROB[tid] = std::min(VROB[tid] + 1, (float) numEntries);
     ++threadEntries[tid];
 
     assert((*tail) == inst);
@@ -299,7 +297,6 @@ ROB<Impl>::retireHead(ThreadID tid)
             head_inst->seqNum);
 
     --numInstsInROB;
-    VROB[tid] = std::max(VROB[tid] - VROB[tid]/threadEntries[tid], (float) 0.0);
     --threadEntries[tid];
 
     head_inst->clearInROB();
@@ -538,6 +535,9 @@ template <class Impl>
 void
 ROB<Impl>::squash(InstSeqNum squash_num, ThreadID tid)
 {
+    // The squashed loads no longer hold the thread back on their misses
+    missTables.squashLLLoads(tid, squash_num);
+
     if (isEmpty(tid)) {
         DPRINTF(ROB, "Does not need to squash due to being empty "
                 "[sn:%i]\n",
@@ -767,22 +767,5 @@ ROB<Impl>::dumpUsedEntries()
     resetUsedEntries();
 }
 
-template <class Impl>
-void
-ROB<Impl>::incVROB(ThreadID tid, int num) {
-    DPRINTF(missTry, "Before incVROB, VROB[%i] = %f\n", tid, VROB[tid]);
-    VROB[tid] = std::min(num + VROB[tid], (float) numEntries);
-}
-
-template <class Impl>
-bool
-ROB<Impl>::VROBFull(ThreadID tid) {
-    bool ret = VROB[tid] >= ((float) numEntries) - 0.1;
-    if (!ret) {
-        DPRINTF(missTry, "VROB[%i] = %f\n", tid, VROB[tid]);
-    }
-    return ret;
-}
-
 
 #endif//__CPU_O3_ROB_IMPL_HH__
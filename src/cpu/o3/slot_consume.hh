@@ -58,6 +58,13 @@ class SlotConsumer
 
     std::array<std::array<VQState, 4>, Impl::MaxThreads> vqState;
 
+    /** Whether a solo run would have run out of registers as well. */
+    std::array<VQState, Impl::MaxThreads> regState;
+
+    /** Whether a solo run would have issued the ready instructions the
+     * IQ held back last cycle; NoVQ if none were held back. */
+    std::array<VQState, Impl::MaxThreads> issueState;
+
     // way of slots consumed by each thread
     std::array<std::array<SlotsUse, Impl::MaxWidth>,
             Impl::MaxThreads> slotConsumption;
@@ -20,6 +20,8 @@ cleanSlots()
                   queueHeadState[tid].end(), HeadInstrState::NoState);
         std::fill(vqState[tid].begin(), vqState[tid].end(), NoVQ);
     }
+    std::fill(regState.begin(), regState.end(), NoVQ);
+    std::fill(issueState.begin(), issueState.end(), NoVQ);
     std::fill(localSlotIndex.begin(), localSlotIndex.end(), 0);
 }
 
@@ -168,7 +170,13 @@ cycleEnd(ThreadID tid,
                 slotCounter->incLocalSlots(tid, LaterMiss, blockedSlots);
             }
         } else if (fullSource == FullSource::Register) {
-            slotCounter->incLocalSlots(tid, EntryMiss, blockedSlots);
+            assert(regState[tid] != NoVQ);
+            if (regState[tid] == VQNotFull) {
+                slotCounter->incLocalSlots(tid, RegWait, blockedSlots);
+                BLB_out = true;
+            } else {
+                slotCounter->incLocalSlots(tid, RegMiss, blockedSlots);
+            }
         } else if (fullSource == FullSource::ROB) {
             if (considerHeadStatus && queueHeadState[tid][ROB] == Normal) {
                 slotCounter->incLocalSlots(tid, ROBWait, blockedSlots);
@@ -214,8 +222,8 @@ cycleEnd(ThreadID tid,
                 slotCounter->incLocalSlots(tid, L2DCacheInterference, blockedSlots);
                 BLB_out = true;
 
-            } else { // head inst in queue is DCache Miss
-                assert(queueHeadState[tid][fullSource] != NoState);
+            } else if (queueHeadState[tid][fullSource] != NoState) {
+                // head inst in queue is DCache Miss
                 if (vqState[tid][fullSource] == VQNotFull) {
                     slotCounter->incLocalSlots(
                             tid, static_cast<SlotsUse>(IQWait + 2*distance_to_iq + 0),
@@ -227,6 +235,16 @@ cycleEnd(ThreadID tid,
                             blockedSlots);
                 }
                 assert(vqState[tid][fullSource] != NoVQ);
+
+            } else if (fullSource == FullSource::IQ &&
+                       issueState[tid] == VQNotFull) {
+                slotCounter->incLocalSlots(tid, IssueWait, blockedSlots);
+                BLB_out = true;
+
+            } else { // ready insts left behind by the issue width quota
+                assert(fullSource == FullSource::IQ &&
+                       issueState[tid] == VQFull);
+                slotCounter->incLocalSlots(tid, IssueMiss, blockedSlots);
             }
         }
     }
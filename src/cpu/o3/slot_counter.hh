@@ -58,10 +58,21 @@ enum SlotsUse {
     SplitMiss,
     L1DCacheInterference,
     L2DCacheInterference,
+    /** Out of physical registers: RegWait when a solo run would still
+     * have had free registers, RegMiss otherwise.
+     */
+    RegWait,
+    RegMiss,
+    /** IQ full while ready instructions were held back at issue:
+     * IssueWait when by the issue width quota or FUs used by another
+     * thread, IssueMiss when by FUs busy with the thread itself.
+     */
+    IssueWait,
+    IssueMiss,
     NumUse
 };
 
-extern std::array<SlotsUse, 13> waitEnums;
+extern std::array<SlotsUse, 15> waitEnums;
 
 
 template <class Impl>
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <numeric>
 
+#include "base/host_profile.hh"
 #include "cpu/o3/comm.hh"
 #include "debug/LB.hh"
 #include "debug/VLB.hh"
@@ -45,9 +46,13 @@ const char* slotUseStr[] = {
         "SplitMiss",
         "L1DCacheInterference",
         "L2DCacheInterference",
+        "RegWait",
+        "RegMiss",
+        "IssueWait",
+        "IssueMiss",
 };
 
-std::array<SlotsUse, 11> missEnums = {
+std::array<SlotsUse, 13> missEnums = {
         InstSupMiss,
         EntryMiss,
         LaterMiss,
@@ -59,9 +64,11 @@ std::array<SlotsUse, 11> missEnums = {
         LQMiss,
         SQMiss,
         SplitMiss,
+        RegMiss,
+        IssueMiss,
 };
 
-std::array<SlotsUse, 13> waitEnums = {
+std::array<SlotsUse, 15> waitEnums = {
         L1ICacheInterference,
         L2ICacheInterference,
         FetchSliceWait,
@@ -75,6 +82,8 @@ std::array<SlotsUse, 13> waitEnums = {
         LaterWait,
         LBLCWait,
         SplitWait,
+        RegWait,
+        IssueWait,
 };
 
     template<class Impl>
@@ -159,6 +168,8 @@ template <class Impl>
 void
 SlotCounter<Impl>::sumLocalSlots(ThreadID tid)
 {
+    HOST_PROFILE("o3.slots");
+
     curCycleMiss[tid] = 0;
     curCycleWait[tid] = 0;
 
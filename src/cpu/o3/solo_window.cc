@@ -0,0 +1,4 @@
+#include "cpu/o3/isa_specific.hh"
+#include "cpu/o3/solo_window_impl.hh"
+
+template class SoloWindow<O3CPUImpl>;
@@ -0,0 +1,149 @@
+#ifndef __CPU_O3_SOLO_WINDOW_HH__
+#define __CPU_O3_SOLO_WINDOW_HH__
+
+#include <array>
+#include <string>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+struct DerivO3CPUParams;
+
+/**
+ * Shadow model of each thread's back end as if it ran alone on the
+ * core. A solo thread owns the whole ROB, IQ, LQ and SQ, so it keeps
+ * dispatching while the SMT thread is held back by structures shared
+ * with, or partitioned against, the other thread. The model tracks how
+ * many instructions a thread has fallen behind its solo run this way:
+ * its virtual occupancy of a structure is the real occupancy plus its
+ * share of those instructions.
+ *
+ * Each cycle the solo run may dispatch as many instructions as its
+ * fullest virtual structure still takes. Instructions the real thread
+ * dispatches use up that budget first, as the solo run dispatches the
+ * same instructions; slots the real thread loses add to the backlog as
+ * far as the rest of the budget allows. Real dispatch beyond the budget
+ * means the solo run was stalled on a full structure, so the real run
+ * catches up on the backlog by that much. A squash discards it.
+ *
+ * Real occupancies are reported by the stage owning each structure,
+ * rename for the ROB and IEW for the IQ and LSQ. Loads and stores are
+ * assumed to make up the backlog in the same proportion as in the
+ * instructions the thread renamed recently.
+ */
+template <class Impl>
+class SoloWindow
+{
+  public:
+    typedef typename Impl::O3CPU O3CPU;
+
+    /** Modelled structures, in the order of SlotConsm::FullSource. */
+    enum Resource {
+        ROB = 0,
+        IQ,
+        LQ,
+        SQ,
+        NumResources
+    };
+
+  private:
+    O3CPU *cpu;
+
+    ThreadID numThreads;
+
+    /** Size of each structure available to a solo thread. */
+    std::array<float, NumResources> capacity;
+
+    /** Last occupancy reported by the owning stage. */
+    std::array<std::array<unsigned, NumResources>, Impl::MaxThreads> real;
+
+    /** Instructions the solo run has dispatched beyond the real one. */
+    std::array<float, Impl::MaxThreads> ahead;
+
+    /** Fraction of instructions that are loads and stores. */
+    std::array<float, Impl::MaxThreads> loadMix;
+    std::array<float, Impl::MaxThreads> storeMix;
+
+    /**
+     * Renamed instructions, loads and stores the mix is taken from.
+     * The counts are halved every MixWindow instructions, so the mix
+     * follows the recent code.
+     */
+    static const unsigned MixWindow = 1024;
+    std::array<unsigned, Impl::MaxThreads> mixInsts;
+    std::array<unsigned, Impl::MaxThreads> mixLoads;
+    std::array<unsigned, Impl::MaxThreads> mixStores;
+
+    /**
+     * Cycle the per-cycle state below belongs to, the dispatch budget
+     * of the solo run left in it, and the lost slots reported in it.
+     * Rename and IEW may both report the same lost slots in one cycle.
+     */
+    std::array<Cycles, Impl::MaxThreads> budgetCycle;
+    std::array<float, Impl::MaxThreads> budget;
+    std::array<unsigned, Impl::MaxThreads> stallSlots;
+
+    /** Instructions the solo run may still dispatch this cycle. */
+    float &cycleBudget(ThreadID tid);
+
+    /** Share of the backlog that sits in the given structure. */
+    float share(ThreadID tid, Resource r) const;
+
+    Stats::Vector occupancySum[NumResources];
+    Stats::Vector realOccupancySum[NumResources];
+    Stats::Scalar samples;
+    Stats::Formula avgOccupancy[NumResources];
+    Stats::Formula avgRealOccupancy[NumResources];
+    Stats::Vector caughtUpSlots;
+    Stats::Vector aheadSlots;
+    Stats::Vector fullSlots;
+
+  public:
+    SoloWindow(O3CPU *cpu_ptr, DerivO3CPUParams *params);
+
+    std::string name() const { return cpu->name() + ".soloWindow"; }
+
+    void regStats();
+
+    /** Record the occupancy of a structure seen by its stage. */
+    void setOccupancy(ThreadID tid, Resource r, unsigned n)
+    { real[tid][r] = n; }
+
+    /**
+     * The thread dispatched n instructions into the back end, of which
+     * the given number are loads and stores.
+     */
+    void dispatched(ThreadID tid, unsigned n, unsigned loads,
+                    unsigned stores);
+
+    /**
+     * The thread could not use the given dispatch slots because a
+     * back-end structure was full. A solo run would have used as many
+     * of them as its own window allows. Slots reported more than once
+     * in a cycle are only counted once.
+     */
+    void stalled(ThreadID tid, unsigned slots);
+
+    /** The thread squashed its younger instructions. */
+    void squash(ThreadID tid) { ahead[tid] = 0.0; }
+
+    /** Occupancy of a structure in the solo run. */
+    float occupancy(ThreadID tid, Resource r) const
+    { return real[tid][r] + share(tid, r); }
+
+    /** Entries of a structure still free in the solo run. */
+    float headroom(ThreadID tid, Resource r) const
+    { return capacity[r] - occupancy(tid, r); }
+
+    /** Would the solo run have this structure full as well? */
+    bool full(ThreadID tid, Resource r) const
+    { return headroom(tid, r) < 0.1; }
+
+    /** Sample the virtual occupancies, once per cycle. */
+    void sample();
+
+    /** Forget all state, e.g. when switching in a new CPU. */
+    void reset();
+};
+
+#endif // __CPU_O3_SOLO_WINDOW_HH__
@@ -0,0 +1,212 @@
+#ifndef __CPU_O3_SOLO_WINDOW_IMPL_HH__
+#define __CPU_O3_SOLO_WINDOW_IMPL_HH__
+
+#include <algorithm>
+#include <limits>
+
+#include "cpu/o3/solo_window.hh"
+#include "debug/SoloWindow.hh"
+#include "params/DerivO3CPU.hh"
+
+template <class Impl>
+SoloWindow<Impl>::SoloWindow(O3CPU *cpu_ptr, DerivO3CPUParams *params)
+    : cpu(cpu_ptr),
+      numThreads(params->numThreads)
+{
+    capacity[ROB] = params->numROBEntries;
+    capacity[IQ] = params->numIQEntries;
+    capacity[LQ] = params->LQEntries;
+    capacity[SQ] = params->SQEntries;
+
+    reset();
+}
+
+template <class Impl>
+void
+SoloWindow<Impl>::reset()
+{
+    for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++) {
+        real[tid].fill(0);
+        ahead[tid] = 0.0;
+        loadMix[tid] = 0.0;
+        storeMix[tid] = 0.0;
+        mixInsts[tid] = 0;
+        mixLoads[tid] = 0;
+        mixStores[tid] = 0;
+        // no cycle yet, the first event computes a budget
+        budgetCycle[tid] = Cycles(std::numeric_limits<uint64_t>::max());
+        budget[tid] = 0.0;
+        stallSlots[tid] = 0;
+    }
+}
+
+template <class Impl>
+float
+SoloWindow<Impl>::share(ThreadID tid, Resource r) const
+{
+    switch (r) {
+      case LQ:
+        return ahead[tid] * loadMix[tid];
+      case SQ:
+        return ahead[tid] * storeMix[tid];
+      default:
+        // the backlog is still waiting on the shadowed miss, so none
+        // of it has issued or committed
+        return ahead[tid];
+    }
+}
+
+template <class Impl>
+float &
+SoloWindow<Impl>::cycleBudget(ThreadID tid)
+{
+    Cycles now = cpu->curCycle();
+    if (budgetCycle[tid] != now) {
+        // occupancies are those reported at the end of the last cycle
+        float limit = std::numeric_limits<float>::max();
+        for (int r = 0; r < NumResources; r++) {
+            float per_inst = r == LQ ? loadMix[tid] :
+                r == SQ ? storeMix[tid] : 1.0;
+            if (per_inst > 0) {
+                limit = std::min(limit,
+                                 headroom(tid, Resource(r)) / per_inst);
+            }
+        }
+        budgetCycle[tid] = now;
+        budget[tid] = std::max(limit, 0.0f);
+        stallSlots[tid] = 0;
+    }
+    return budget[tid];
+}
+
+template <class Impl>
+void
+SoloWindow<Impl>::dispatched(ThreadID tid, unsigned n, unsigned loads,
+                             unsigned stores)
+{
+    // the solo run dispatches these instructions too, unless its own
+    // window is full, in which case the real run catches up
+    float &left = cycleBudget(tid);
+    float used = std::min(float(n), left);
+    left -= used;
+    float caught_up = std::min(n - used, ahead[tid]);
+    ahead[tid] -= caught_up;
+    caughtUpSlots[tid] += caught_up;
+
+    if (n == 0)
+        return;
+
+    mixInsts[tid] += n;
+    mixLoads[tid] += loads;
+    mixStores[tid] += stores;
+    if (mixInsts[tid] >= MixWindow) {
+        mixInsts[tid] /= 2;
+        mixLoads[tid] /= 2;
+        mixStores[tid] /= 2;
+    }
+
+    loadMix[tid] = float(mixLoads[tid]) / mixInsts[tid];
+    storeMix[tid] = float(mixStores[tid]) / mixInsts[tid];
+}
+
+template <class Impl>
+void
+SoloWindow<Impl>::stalled(ThreadID tid, unsigned slots)
+{
+    float &left = cycleBudget(tid);
+
+    // rename (ROB) and IEW (IQ, LSQ) can both stall on the same slots
+    // in one cycle, so only count what exceeds the earlier report
+    if (slots <= stallSlots[tid])
+        return;
+    unsigned extra = slots - stallSlots[tid];
+    stallSlots[tid] = slots;
+    slots = extra;
+
+    // the solo run stops at the first structure it fills up
+    float grow = std::min(float(slots), left);
+    left -= grow;
+
+    ahead[tid] += grow;
+    aheadSlots[tid] += grow;
+    fullSlots[tid] += slots - grow;
+
+    DPRINTF(SoloWindow, "T[%i] stalled %i slots, solo run gains %f, "
+            "%f ahead\n", tid, slots, grow, ahead[tid]);
+}
+
+template <class Impl>
+void
+SoloWindow<Impl>::sample()
+{
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        for (int r = 0; r < NumResources; r++) {
+            occupancySum[r][tid] += occupancy(tid, Resource(r));
+            realOccupancySum[r][tid] += real[tid][r];
+        }
+    }
+    ++samples;
+}
+
+template <class Impl>
+void
+SoloWindow<Impl>::regStats()
+{
+    const char *names[NumResources] = { "ROB", "IQ", "LQ", "SQ" };
+
+    for (int r = 0; r < NumResources; r++) {
+        occupancySum[r]
+            .init(numThreads)
+            .name(name() + ".occupancy" + names[r])
+            .desc(std::string("Sum of sampled solo-run ") + names[r] +
+                  " occupancy")
+            ;
+
+        avgOccupancy[r]
+            .name(name() + ".avgOccupancy" + names[r])
+            .desc(std::string("Average solo-run ") + names[r] +
+                  " occupancy, compare with a single-thread run")
+            .flags(Stats::total)
+            ;
+        avgOccupancy[r] = occupancySum[r] / samples;
+
+        realOccupancySum[r]
+            .init(numThreads)
+            .name(name() + ".realOccupancy" + names[r])
+            .desc(std::string("Sum of sampled real ") + names[r] +
+                  " occupancy")
+            ;
+
+        avgRealOccupancy[r]
+            .name(name() + ".avgRealOccupancy" + names[r])
+            .desc(std::string("Average real ") + names[r] + " occupancy")
+            .flags(Stats::total)
+            ;
+        avgRealOccupancy[r] = realOccupancySum[r] / samples;
+    }
+
+    samples
+        .name(name() + ".samples")
+        .desc("Cycles the solo-run occupancy was sampled")
+        ;
+
+    aheadSlots
+        .init(numThreads)
+        .name(name() + ".aheadSlots")
+        .desc("Stalled dispatch slots a solo run would have used")
+        ;
+
+    caughtUpSlots
+        .init(numThreads)
+        .name(name() + ".caughtUpSlots")
+        .desc("Instructions dispatched while the solo run was stalled")
+        ;
+
+    fullSlots
+        .init(numThreads)
+        .name(name() + ".fullSlots")
+        .desc("Stalled dispatch slots a solo run would have lost too")
+        ;
+}
+
+#endif // __CPU_O3_SOLO_WINDOW_IMPL_HH__
@@ -299,6 +299,8 @@ AbstractMemory::checkLockedAddrList(PacketPtr pkt)
 
 #define TRACE_PACKET(A)                                                 \
     do {                                                                \
+        if (!pkt->hasPayload())                                         \
+            break;                                                      \
         switch (pkt->getSize()) {                                       \
           CASE(A, uint64_t);                                            \
           CASE(A, uint32_t);                                            \
@@ -372,7 +374,9 @@ AbstractMemory::access(PacketPtr pkt)
         if (pkt->isLLSC()) {
             trackLoadLocked(pkt);
         }
-        if (pmemAddr)
+        // caches without data send no payload, the backing store is
+        // then read directly by the cache that needs the data
+        if (pmemAddr && pkt->hasPayload())
             memcpy(pkt->getPtr<uint8_t>(), hostAddr, pkt->getSize());
         TRACE_PACKET(pkt->req->isInstFetch() ? "IFetch" : "Read");
         numReads[pkt->req->masterId()]++;
@@ -388,7 +392,7 @@ AbstractMemory::access(PacketPtr pkt)
         // because the Write -> WriteInvalidate rewrite happens in the cache.
     } else if (pkt->isWrite()) {
         if (writeOK(pkt)) {
-            if (pmemAddr) {
+            if (pmemAddr && pkt->hasPayload()) {
                 memcpy(hostAddr, pkt->getConstPtr<uint8_t>(), pkt->getSize());
                 DPRINTF(MemoryAccess, "%s wrote %x bytes to address %x\n",
                         __func__, pkt->getSize(), pkt->getAddr());
@@ -0,0 +1,72 @@
+/**
+ * @file
+ * Reference counted cache block payloads, shared copy-on-write between
+ * packets and cache blocks when a cache runs with share_block_data.
+ */
+
+#ifndef __MEM_BLOCK_DATA_HH__
+#define __MEM_BLOCK_DATA_HH__
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "base/refcnt.hh"
+
+/**
+ * One block worth of data with an intrusive reference count. The
+ * bytes follow the header in the same allocation, so sharing a block
+ * costs a single allocation and no copies. Holders only write through
+ * data() while they are the sole owner; anyone else must take a
+ * private copy first (see CacheBlk::makeDataUnique).
+ */
+class BlockData
+{
+  private:
+    int count;
+    unsigned _size;
+
+    BlockData(unsigned size) : count(0), _size(size) {}
+
+    BlockData(const BlockData &);
+    BlockData &operator=(const BlockData &);
+
+  public:
+    /** Allocate an uninitialised buffer of the given size. */
+    static BlockData *
+    create(unsigned size)
+    {
+        void *p = ::operator new(sizeof(BlockData) + size);
+        return new (p) BlockData(size);
+    }
+
+    /** Allocate a buffer holding a copy of the given bytes. */
+    static BlockData *
+    copy(const uint8_t *src, unsigned size)
+    {
+        BlockData *b = create(size);
+        std::memcpy(b->data(), src, size);
+        return b;
+    }
+
+    uint8_t *data() { return reinterpret_cast<uint8_t *>(this + 1); }
+    unsigned size() const { return _size; }
+
+    /** More than one packet or block refers to this buffer. */
+    bool shared() const { return count > 1; }
+
+    void incref() { ++count; }
+
+    void
+    decref()
+    {
+        if (--count <= 0) {
+            this->~BlockData();
+            ::operator delete(this);
+        }
+    }
+};
+
+typedef RefCountingPtr<BlockData> BlockDataPtr;
+
+#endif // __MEM_BLOCK_DATA_HH__
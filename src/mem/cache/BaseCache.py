@@ -62,9 +62,21 @@ class BaseCache(MemObject):
     tgts_per_mshr = Param.Unsigned("Max number of accesses per MSHR")
     write_buffers = Param.Unsigned(8, "Number of write buffers")
 
+    # Entries reserved for each hardware thread, indexed by thread id.
+    # An empty list keeps the queue shared first-come-first-served; the
+    # O3 QoS controller may resize the MSHR reservations at runtime.
+    mshr_thread_reserve = VectorParam.Unsigned([],
+        "MSHRs reserved for each thread")
+    write_buffer_thread_reserve = VectorParam.Unsigned([],
+        "Write buffers reserved for each thread")
+
     forward_snoops = Param.Bool(True,
         "Forward snoops from mem side to cpu side")
     is_top_level = Param.Bool(False, "Is this cache at the top level (e.g. L1)")
+    share_block_data = Param.Bool(False,
+        "Share block data with packets copy-on-write instead of copying it")
+    no_data = Param.Bool(False,
+        "Timing only: keep no data, satisfy accesses from the backing store")
 
     prefetcher = Param.BasePrefetcher(NULL,"Prefetcher attached to cache")
     prefetch_on_access = Param.Bool(False,
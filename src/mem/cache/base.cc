@@ -70,9 +70,10 @@ BaseCache::BaseCache(const Params *p)
     : MemObject(p),
       cpuSidePort(nullptr), memSidePort(nullptr),
       mshrQueue("MSHRs", p->mshrs, 4, p->demand_mshr_reserve,
-                MSHRQueue_MSHRs, p->cache_level),
+                MSHRQueue_MSHRs, p->cache_level, p->mshr_thread_reserve),
       writeBuffer("write buffer", p->write_buffers, p->mshrs + 1000, 0,
-                  MSHRQueue_WriteBuffer, p->cache_level),
+                  MSHRQueue_WriteBuffer, p->cache_level,
+                  p->write_buffer_thread_reserve),
       blkSize(p->system->cacheLineSize()),
       lookupLatency(p->hit_latency),
       forwardLatency(p->hit_latency),
@@ -81,6 +82,8 @@ BaseCache::BaseCache(const Params *p)
       numTarget(p->tgts_per_mshr),
       forwardSnoops(p->forward_snoops),
       isTopLevel(p->is_top_level),
+      shareBlockData(p->share_block_data),
+      noData(p->no_data),
       blocked(0),
       order(0),
       noTargetMSHR(NULL),
@@ -92,18 +95,28 @@ BaseCache::BaseCache(const Params *p)
       isDCache(p->is_dcache)
 
 {
+    fatal_if(shareBlockData && noData,
+             "%s: share_block_data and no_data are exclusive\n", name());
+
     missTables.cacheBlockSize = blkSize;
     if (cacheLevel == 2) {
         missTable = &missTables.l2MissTable;
         missTables.numL2_MSHR = p->mshrs;
+        missTables.l2MSHRs = &mshrQueue;
+        mshrQueue.setRationConfig(&controlPanel.l2MSHRConfig);
     } else if (cacheLevel == 1){
         if (isDCache) {
             missTable = &missTables.l1DMissTable;
             missTables.numL1DR_MSHR = p->mshrs;
             missTables.numL1DW_MSHR = p->write_buffers;
+            missTables.l1DMSHRs = &mshrQueue;
+            missTables.l1DWriteBuffer = &writeBuffer;
+            mshrQueue.setRationConfig(&controlPanel.l1DMSHRConfig);
         } else {
             missTable = &missTables.l1IMissTable;
             missTables.numL1I_MSHR = p->mshrs;
+            missTables.l1IMSHRs = &mshrQueue;
+            mshrQueue.setRationConfig(&controlPanel.l1IMSHRConfig);
         }
     } else {
         panic("Unknown cache level %i\n", cacheLevel);
@@ -138,6 +151,15 @@ BaseCache::CacheSlavePort::clearBlocked()
     }
 }
 
+void
+BaseCache::CacheSlavePort::retryAt(Tick when)
+{
+    // a blocked port sends its retry once it is cleared
+    if (!blocked && !sendRetryEvent.scheduled()) {
+        owner.schedule(sendRetryEvent, when);
+    }
+}
+
 void
 BaseCache::CacheSlavePort::processSendRetry()
 {
@@ -175,6 +175,12 @@ class BaseCache : public MemObject
 
         bool isBlocked() const { return blocked; }
 
+        /**
+         * Send a retry at the given time for a request that was
+         * rejected without blocking the port.
+         */
+        void retryAt(Tick when);
+
       protected:
 
         CacheSlavePort(const std::string &_name, BaseCache *_cache,
@@ -313,6 +319,22 @@ class BaseCache : public MemObject
      * side */
     const bool isTopLevel;
 
+    /**
+     * Do blocks and the packets filling, writing back or reading
+     * whole blocks share reference counted buffers copy-on-write,
+     * rather than copying the data at every hop?
+     */
+    const bool shareBlockData;
+
+    /**
+     * Keep no data in the cache. Blocks refer to the system's backing
+     * store, which is always up to date: CPU accesses read and write it
+     * when they are satisfied here, while fills and writebacks carry no
+     * payload and only model timing. All caches in the system must
+     * agree on this setting.
+     */
+    const bool noData;
+
     /**
      * Bit vector of the blocking reasons for the access path.
      * @sa #BlockedCause
@@ -636,7 +658,7 @@ class BaseCache : public MemObject
             ThreadID tid = pkt->req->threadId();
             auto ent = missTable->find(blockAlign(pkt->getAddr()));
             if (ent == missTable->end()) {
-                missTable->emplace(blockAlign(pkt->getAddr()),
+                ent = missTable->emplace(blockAlign(pkt->getAddr()),
                                    MissEntry{
                                            tid,
                                            cacheLevel,
@@ -645,7 +667,7 @@ class BaseCache : public MemObject
                                            curTick(),
                                            pkt->req->seqNum,
                                            blockAlign(pkt->getAddr())
-                                   });
+                                   }).first;
 
                 MissStat &ms = missTables.missStat;
                 if (cacheLevel == 1) {
@@ -667,6 +689,7 @@ class BaseCache : public MemObject
                     }
                     if (is_data) {
                         ms.numL2DataMiss[tid]++;
+                        missTables.addL2Miss(ent->first, ent->second);
                     } else {
                         ms.numL2InstMiss[tid]++;
                     }
@@ -51,6 +51,7 @@
 #include <list>
 
 #include "base/printable.hh"
+#include "mem/block_data.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 #include "sim/core.hh"          // for Tick
@@ -102,6 +103,12 @@ class CacheBlk
      * referenced by this block.
      */
     uint8_t *data;
+    /**
+     * The buffer data points into when the cache shares block data
+     * with packets (share_block_data); NULL when data points into the
+     * tag store's own array.
+     */
+    BlockDataPtr buffer;
     /** the number of bytes stored in this block. */
     int size;
 
@@ -191,6 +198,7 @@ class CacheBlk
         asid = rhs.asid;
         tag = rhs.tag;
         data = rhs.data;
+        buffer = rhs.buffer;
         size = rhs.size;
         status = rhs.status;
         whenReady = rhs.whenReady;
@@ -201,6 +209,32 @@ class CacheBlk
         return *this;
     }
 
+    /**
+     * Make the block refer to the given shared buffer.
+     * @param buf The buffer holding the block's data.
+     */
+    void adoptData(const BlockDataPtr &buf)
+    {
+        buffer = buf;
+        data = buffer->data();
+    }
+
+    /**
+     * Make sure the block owns its buffer before it is written, taking
+     * a private copy if a packet or another cache still refers to it.
+     * @param preserve Whether the current contents are still needed,
+     * rather than about to be overwritten as a whole.
+     */
+    void makeDataUnique(bool preserve = true)
+    {
+        if (!buffer) {
+            adoptData(BlockData::create(size));
+        } else if (buffer->shared()) {
+            adoptData(preserve ? BlockData::copy(data, size) :
+                      BlockData::create(size));
+        }
+    }
+
     /**
      * Checks the write permissions of this block.
      * @return True if the block is writable.
@@ -240,6 +274,12 @@ class CacheBlk
         status = 0;
         isTouched = false;
         clearLoadLocks();
+        // an invalid block holds no shared buffer, so that the memory
+        // goes away with the last packet referring to it
+        if (buffer) {
+            buffer = NULL;
+            data = NULL;
+        }
     }
 
     /**
@@ -189,6 +189,12 @@ class Cache : public BaseCache
      */
     void promoteWholeLineWrites(PacketPtr pkt);
 
+    /**
+     * Whether a request would need a new MSHR that its thread may not
+     * take, because the rest is reserved for the other threads.
+     */
+    bool overThreadReserve(PacketPtr pkt);
+
     /**
      * Notify the prefetcher on every access, not just misses.
      */
@@ -217,6 +223,22 @@ class Cache : public BaseCache
      */
     void cmpAndSwap(CacheBlk *blk, PacketPtr pkt);
 
+    /**
+     * Get the block's data for writing. With shared block data this
+     * first gives the block a buffer of its own.
+     * @param blk The block about to be written.
+     * @param preserve Whether the current contents must be kept.
+     * @return Pointer to the start of the block's data.
+     */
+    uint8_t *writableData(CacheBlk *blk, bool preserve = true);
+
+    /**
+     * Fill a whole block with the data carried by a packet, taking a
+     * reference to the packet's buffer rather than copying it when
+     * both share block data.
+     */
+    void fillBlockData(CacheBlk *blk, PacketPtr pkt);
+
     /**
      * Find a block frame for new block at address addr targeting the
      * given security space, assuming that the block is not currently
@@ -56,6 +56,7 @@
 
 #include <algorithm>
 
+#include "base/host_profile.hh"
 #include "base/misc.hh"
 #include "base/types.hh"
 #include "debug/Cache.hh"
@@ -76,7 +77,8 @@ Cache::Cache(const Params *p)
       prefetchOnAccess(p->prefetch_on_access)
 {
     tempBlock = new CacheBlk();
-    tempBlock->data = new uint8_t[blkSize];
+    if (!noData)
+        tempBlock->data = new uint8_t[blkSize];
 
     cpuSidePort = new CpuSidePort(p->name + ".cpu_side", this,
                                   "CpuSidePort");
@@ -101,7 +103,8 @@ Cache::Cache(const Params *p)
 
 Cache::~Cache()
 {
-    delete [] tempBlock->data;
+    if (!noData)
+        delete [] tempBlock->data;
     delete tempBlock;
 
     delete cpuSidePort;
@@ -149,12 +152,43 @@ Cache::cmpAndSwap(CacheBlk *blk, PacketPtr pkt)
     }
 
     if (overwrite_mem) {
-        std::memcpy(blk_data, &overwrite_val, pkt->getSize());
+        std::memcpy(writableData(blk) + offset, &overwrite_val,
+                    pkt->getSize());
         blk->status |= BlkDirty;
     }
 }
 
 
+uint8_t *
+Cache::writableData(CacheBlk *blk, bool preserve)
+{
+    // the temporary block always keeps its own array
+    if (shareBlockData && blk != tempBlock)
+        blk->makeDataUnique(preserve);
+    return blk->data;
+}
+
+void
+Cache::fillBlockData(CacheBlk *blk, PacketPtr pkt)
+{
+    assert(pkt->getSize() == blkSize);
+
+    if (noData) {
+        // the backing store is always up to date, so whatever the
+        // packet carries is ignored and the block simply refers to
+        // the memory itself
+        Addr blk_addr = blockAlign(pkt->getAddr());
+        blk->data = system->getPhysMem().toHostAddr(blk_addr);
+        fatal_if(!blk->data, "%s: no_data needs %#llx to be backed by "
+                 "host memory\n", name(), blk_addr);
+    } else if (shareBlockData && blk != tempBlock && pkt->hasSharedData()) {
+        blk->adoptData(pkt->sharedData());
+    } else {
+        std::memcpy(writableData(blk, false), pkt->getConstPtr<uint8_t>(),
+                    blkSize);
+    }
+}
+
 void
 Cache::satisfyCpuSideRequest(PacketPtr pkt, CacheBlk *blk,
                              bool deferred_response, bool pending_downgrade)
@@ -180,7 +214,7 @@ Cache::satisfyCpuSideRequest(PacketPtr pkt, CacheBlk *blk,
         assert(blk->isWritable());
         // Write or WriteInvalidate at the first cache with block in Exclusive
         if (blk->checkWrite(pkt)) {
-            pkt->writeDataToBlock(blk->data, blkSize);
+            pkt->writeDataToBlock(writableData(blk), blkSize);
         }
         // Always mark the line as dirty even if we are a failed
         // StoreCond so we supply data to any snoops that have
@@ -193,7 +227,10 @@ Cache::satisfyCpuSideRequest(PacketPtr pkt, CacheBlk *blk,
         if (pkt->isLLSC()) {
             blk->trackLoadLocked(pkt);
         }
-        pkt->setDataFromBlock(blk->data, blkSize);
+        if (blk->buffer)
+            pkt->setDataFromSharedBlock(blk->buffer, blkSize);
+        else if (pkt->hasPayload())
+            pkt->setDataFromBlock(blk->data, blkSize);
         if (pkt->getSize() == blkSize) {
             // special handling for coherent block requests from
             // upper-level caches
@@ -310,6 +347,8 @@ bool
 Cache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
               PacketList &writebacks)
 {
+    HOST_PROFILE("cache.access");
+
     // sanity check
     assert(pkt->isRequest());
 
@@ -390,7 +429,7 @@ Cache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
         }
         // nothing else to do; writeback doesn't expect response
         assert(!pkt->needsResponse());
-        std::memcpy(blk->data, pkt->getConstPtr<uint8_t>(), blkSize);
+        fillBlockData(blk, pkt);
         DPRINTF(Cache, "%s new state is %s\n", __func__, blk->print());
         incHitCount(pkt);
         return true;
@@ -476,6 +515,29 @@ Cache::promoteWholeLineWrites(PacketPtr pkt)
     }
 }
 
+bool
+Cache::overThreadReserve(PacketPtr pkt)
+{
+    mshrQueue.checkRationUpdate();
+    if (!mshrQueue.threadPartitioned() || pkt->req->isUncacheable() ||
+        pkt->cmd == MemCmd::Writeback || pkt->cmd.isPrefetch() ||
+        !pkt->req->hasThreadId()) {
+        return false;
+    }
+
+    // hits and requests that coalesce into an existing MSHR are fine
+    if (mshrQueue.findMatch(blockAlign(pkt->getAddr()), pkt->isSecure())) {
+        return false;
+    }
+    CacheBlk *blk = tags->findBlock(pkt->getAddr(), pkt->isSecure());
+    if (blk && blk->isValid() &&
+        (!pkt->needsExclusive() || blk->isWritable())) {
+        return false;
+    }
+
+    return mshrQueue.threadFull(pkt->req->threadId());
+}
+
 bool
 Cache::recvTimingReq(PacketPtr pkt)
 {
@@ -552,6 +614,16 @@ Cache::recvTimingReq(PacketPtr pkt)
         return true;
     }
 
+    // A thread may not eat into the entries reserved for the others,
+    // even though the port is only blocked once all entries are gone;
+    // the sender tries again next cycle
+    if (overThreadReserve(pkt)) {
+        DPRINTF(MSHR, "T[%i] packet %llu rejected by thread reservation\n",
+                pkt->req->threadId(), pkt->req->seqNum);
+        cpuSidePort->retryAt(clockEdge(Cycles(1)));
+        return false;
+    }
+
     // anything that is merely forwarded pays for the forward latency and
     // the delay provided by the crossbar
     Tick forward_time = clockEdge(forwardLatency) + pkt->headerDelay;
@@ -602,8 +674,10 @@ Cache::recvTimingReq(PacketPtr pkt)
         // hit (for all other request types)
 
         if (prefetcher && (prefetchOnAccess || (blk && blk->wasPrefetched()))) {
-            if (blk)
+            if (blk && blk->wasPrefetched()) {
+                prefetcher->prefetchUseful(blk->threadID);
                 blk->status &= ~BlkHWPrefetched;
+            }
 
             // Don't notify on SWPrefetch
             if (!pkt->cmd.isSWPrefetch())
@@ -785,8 +859,11 @@ Cache::recvTimingReq(PacketPtr pkt)
 
             if (prefetcher) {
                 // Don't notify on SWPrefetch
-                if (!pkt->cmd.isSWPrefetch())
+                if (!pkt->cmd.isSWPrefetch()) {
+                    if (pkt->req->hasThreadId())
+                        prefetcher->demandMiss(pkt->req->threadId());
                     next_pf_time = prefetcher->notify(pkt);
+                }
             }
         }
     }
@@ -867,7 +944,12 @@ Cache::getBusPacket(PacketPtr cpu_pkt, CacheBlk *blk,
     // the packet should be block aligned
     assert(pkt->getAddr() == blockAlign(pkt->getAddr()));
 
-    pkt->allocate();
+    // with shared block data the response can be adopted by this
+    // cache and passed up the hierarchy without further copies
+    if (shareBlockData)
+        pkt->allocateShared();
+    else if (!noData)
+        pkt->allocate();
     DPRINTF(Cache, "%s created %s addr %#llx size %d\n",
             __func__, pkt->cmdString(), pkt->getAddr(), pkt->getSize());
     return pkt;
@@ -1050,9 +1132,11 @@ Cache::functionalAccess(PacketPtr pkt, bool fromCpuSide)
     // needs to be found.  As a result we always update the request if
     // we have it, but only declare it satisfied if we are the owner.
 
-    // see if we have data at all (owned or otherwise)
+    // see if we have data at all (owned or otherwise); functional
+    // writes must not show through in buffers others still hold
     bool have_data = blk && blk->isValid()
         && pkt->checkFunctional(&cbpw, blk_addr, is_secure, blkSize,
+                                pkt->isWrite() ? writableData(blk) :
                                 blk->data);
 
     // data we have is dirty if marked as such or if valid & ownership
@@ -1381,8 +1465,12 @@ Cache::writebackBlk(CacheBlk *blk)
     if (blk->isWritable()) {
         writeback->setSupplyExclusive();
     }
-    writeback->allocate();
-    std::memcpy(writeback->getPtr<uint8_t>(), blk->data, blkSize);
+    if (blk->buffer) {
+        writeback->dataShared(blk->buffer);
+    } else if (!noData) {
+        writeback->allocate();
+        std::memcpy(writeback->getPtr<uint8_t>(), blk->data, blkSize);
+    }
 
     blk->status &= ~BlkDirty;
     return writeback;
@@ -1474,6 +1562,10 @@ Cache::allocateBlock(Addr addr, bool is_secure, PacketList &writebacks)
                 // Save writeback packet for handling by caller
                 writebacks.push_back(writebackBlk(blk));
             }
+
+            if (prefetcher && blk->wasPrefetched()) {
+                prefetcher->prefetchUnused(blk->threadID);
+            }
         }
     }
 
@@ -1564,7 +1656,7 @@ Cache::handleFill(PacketPtr pkt, CacheBlk *blk, PacketList &writebacks)
         assert(pkt->hasData());
         assert(pkt->getSize() == blkSize);
 
-        std::memcpy(blk->data, pkt->getConstPtr<uint8_t>(), blkSize);
+        fillBlockData(blk, pkt);
     }
     // We pay for fillLatency here.
     blk->whenReady = clockEdge() + fillLatency * clockPeriod() +
@@ -1596,13 +1688,15 @@ Cache::doTimingSupplyResponse(PacketPtr req_pkt, const uint8_t *blk_data,
     if (!already_copied)
         // do not clear flags, and allocate space for data if the
         // packet needs it (the only packets that carry data are read
-        // responses)
-        pkt = new Packet(req_pkt, false, req_pkt->isRead());
+        // responses); without data, only requesters that brought a
+        // payload of their own get the data back
+        pkt = new Packet(req_pkt, false, req_pkt->isRead() &&
+                         (!noData || req_pkt->hasPayload()));
 
     assert(req_pkt->req->isUncacheable() || req_pkt->isInvalidate() ||
            pkt->sharedAsserted());
     pkt->makeTimingResponse();
-    if (pkt->isRead()) {
+    if (pkt->isRead() && pkt->hasPayload()) {
         pkt->setDataFromBlock(blk_data, blkSize);
     }
     if (pkt->cmd == MemCmd::ReadResp && pending_inval) {
@@ -1754,7 +1848,8 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
             doTimingSupplyResponse(pkt, blk->data, is_deferred, pending_inval);
         } else {
             pkt->makeAtomicResponse();
-            pkt->setDataFromBlock(blk->data, blkSize);
+            if (pkt->hasPayload())
+                pkt->setDataFromBlock(blk->data, blkSize);
         }
     }
 
@@ -1853,8 +1948,12 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
             // the packet's invalidate flag is set...
             assert(pkt->isInvalidate());
         }
-        doTimingSupplyResponse(pkt, wb_pkt->getConstPtr<uint8_t>(),
-                               false, false);
+        // without data the writeback carries no payload, its value is
+        // in the backing store
+        const uint8_t *wb_data = wb_pkt->hasPayload() ?
+            wb_pkt->getConstPtr<uint8_t>() :
+            system->getPhysMem().toHostAddr(blk_addr);
+        doTimingSupplyResponse(pkt, wb_data, false, false);
 
         if (pkt->isInvalidate()) {
             // Invalidation trumps our writeback... discard here
@@ -1,4 +1,5 @@
 #include "mem/cache/miss_table.hh"
+#include "mem/cache/mshr_queue.hh"
 #include "debug/missTry.hh"
 
 
@@ -77,20 +78,53 @@ bool MissTables::isMSHRFull(int cacheLevel, bool isDCache) {
     }
 }
 
+bool MissTables::reserved(MSHRQueue *mq) {
+    if (!mq) {
+        return false;
+    }
+    mq->checkRationUpdate();
+    return mq->threadPartitioned();
+}
+
+bool MissTables::reservedFull(MSHRQueue *mq, ThreadID tid) {
+    return reserved(mq) && mq->threadFull(tid);
+}
+
 bool MissTables::perThreadMSHRFull(int cacheLevel, bool isDCache,
                                    ThreadID tid, bool isLoad) {
+    // With reservations in L2, a thread that used up its L2 share is
+    // throttled at L1 already: the L2 port blocks for everyone once its
+    // MSHRs are full.
     if (cacheLevel == 1) {
         if (isDCache) {
             if (isLoad) {
+                if (reserved(l1DMSHRs) || reserved(l2MSHRs)) {
+                    return reservedFull(l1DMSHRs, tid) ||
+                        reservedFull(l2MSHRs, tid);
+                }
                 return missStat.numL1LoadMiss[tid] >= numL1DR_MSHR / 2;
             } else {
+                if (reserved(l1DMSHRs) || reserved(l1DWriteBuffer) ||
+                        reserved(l2MSHRs)) {
+                    return reservedFull(l1DMSHRs, tid) ||
+                        reservedFull(l1DWriteBuffer, tid) ||
+                        reservedFull(l2MSHRs, tid);
+                }
                 return missStat.numL1StoreMiss[tid] >= numL1DW_MSHR / 2;
             }
         } else {
+            if (reserved(l1IMSHRs) || reserved(l2MSHRs)) {
+                return reservedFull(l1IMSHRs, tid) ||
+                    reservedFull(l2MSHRs, tid);
+            }
             return missStat.numL1InstMiss[tid] >= numL1I_MSHR / 2;
         }
     } else if (cacheLevel == 2) {
-        panic("Not implemented L%i\n", cacheLevel);
+        if (reserved(l2MSHRs)) {
+            return l2MSHRs->threadFull(tid);
+        }
+        return missStat.numL2InstMiss[tid] + missStat.numL2DataMiss[tid] >=
+            numL2_MSHR / 2;
     } else {
         panic("Unknown cache level %i\n", cacheLevel);
     }
@@ -148,5 +182,27 @@ bool MissTables::hasMiss(MissTable &mt, ThreadID tid) {
     return false;
 }
 
+void MissTables::addL2Miss(Addr address, const MissEntry &me) {
+    if (me.tid < 0 || me.tid >= llLoads.size() || me.seqNum == 0) {
+        return;
+    }
+    // Only the L1 D-cache table knows whether it is a load.
+    auto l1 = l1DMissTable.find(address);
+    if (l1 != l1DMissTable.end() && l1->second.mat == MemAccessType::MemLoad) {
+        llLoads[me.tid].insert(me.seqNum);
+    }
+}
+
+void MissTables::removeL2Miss(const MissEntry &me) {
+    if (me.tid < 0 || me.tid >= llLoads.size()) {
+        return;
+    }
+    // A split load may miss on two lines, drop one of them
+    auto it = llLoads[me.tid].find(me.seqNum);
+    if (it != llLoads[me.tid].end()) {
+        llLoads[me.tid].erase(it);
+    }
+}
+
 
 MissTables missTables;
@@ -1,7 +1,9 @@
 #ifndef __MISS_TABLE_H__
 #define __MISS_TABLE_H__
 
+#include <array>
 #include <cinttypes>
+#include <set>
 #include <unordered_map>
 #include <vector>
 
@@ -10,6 +12,8 @@
 #include "debug/MissTable.hh"
 #include "mem/cache/miss_descpriptor.hh"
 
+class MSHRQueue;
+
 struct MissEntry {
     ThreadID tid;
     int16_t cacheLevel;
@@ -56,8 +60,72 @@ public:
     int numL1DW_MSHR;
     int numL2_MSHR;
 
+    // Registered by the caches, used for per-thread reservations
+    MSHRQueue *l1IMSHRs = nullptr;
+    MSHRQueue *l1DMSHRs = nullptr;
+    MSHRQueue *l1DWriteBuffer = nullptr;
+    MSHRQueue *l2MSHRs = nullptr;
+
     MissStat missStat;
 
+    // Cycles in which a memory reference of each thread was rejected by
+    // a full MSHR share since the core last looked
+    std::array<uint64_t, 2> recentMSHRRejects {{0, 0}};
+    std::array<Cycles, 2> lastMSHRReject {{Cycles(0), Cycles(0)}};
+
+    /**
+     * Note a memory reference rejected by a full MSHR share, counted at
+     * most once per cycle and thread so that the core can weigh it in
+     * dispatch slots like the other contention classes.
+     */
+    void
+    noteMSHRReject(ThreadID tid, Cycles now)
+    {
+        if (recentMSHRRejects[tid] == 0 || lastMSHRReject[tid] != now) {
+            recentMSHRRejects[tid]++;
+            lastMSHRReject[tid] = now;
+        }
+    }
+
+    // Sequence numbers of each thread's loads missing in the L2 that
+    // have not been squashed, kept along with the L2 table so that the
+    // core does not have to scan it
+    std::array<std::multiset<uint64_t>, 2> llLoads;
+
+    /** Track a new L2 miss entry if it is a load of a live thread. */
+    void addL2Miss(Addr address, const MissEntry &me);
+
+    /** Stop tracking an L2 miss entry about to be erased. */
+    void removeL2Miss(const MissEntry &me);
+
+    /** Forget the loads of tid younger than seq, they are squashed. */
+    void
+    squashLLLoads(ThreadID tid, uint64_t seq)
+    {
+        if (tid >= 0 && tid < llLoads.size()) {
+            llLoads[tid].erase(llLoads[tid].upper_bound(seq),
+                               llLoads[tid].end());
+        }
+    }
+
+    /** The oldest load of tid missing in the L2, 0 if there is none. */
+    uint64_t
+    oldestLLLoad(ThreadID tid) const
+    {
+        if (tid < 0 || tid >= llLoads.size() || llLoads[tid].empty())
+            return 0;
+        return *llLoads[tid].begin();
+    }
+
+    /** The youngest load of tid missing in the L2, 0 if there is none. */
+    uint64_t
+    newestLLLoad(ThreadID tid) const
+    {
+        if (tid < 0 || tid >= llLoads.size() || llLoads[tid].empty())
+            return 0;
+        return *llLoads[tid].rbegin();
+    }
+
     bool isSpecifiedMiss(Addr address, bool isDCache, MissDescriptor &md);
 
     bool isL1Miss(Addr address, bool &isInst);
@@ -76,6 +144,10 @@ public:
 
     bool perThreadMSHRFull(int cacheLevel, bool isDCache, ThreadID tid, bool isLoad);
 
+    bool reserved(MSHRQueue *mq);
+
+    bool reservedFull(MSHRQueue *mq, ThreadID tid);
+
     bool hasInstMiss(ThreadID tid);
 
     bool hasDataMiss(ThreadID tid);
@@ -66,7 +66,8 @@ MSHR::MSHR() : readyTime(0), _isUncacheable(false), downstreamPending(false),
                postInvalidate(false), postDowngrade(false),
                queue(NULL), order(0), blkAddr(0),
                blkSize(0), isSecure(false), inService(false),
-               isForward(false), threadNum(InvalidThreadID), data(NULL)
+               isForward(false), threadNum(InvalidThreadID),
+               chargedThread(InvalidThreadID), data(NULL)
 {
 }
 
@@ -370,7 +371,9 @@ MSHR::handleSnoop(PacketPtr pkt, Counter _order)
         if (isPendingDirty()) {
             // Case 1: The new packet will need to get the response from the
             // MSHR already queued up here
-            cp_pkt = new Packet(pkt, true, true);
+            // requests between caches without data carry no payload,
+            // and their responses do not need one either
+            cp_pkt = new Packet(pkt, true, pkt->hasPayload());
             pkt->assertMemInhibit();
             // in the case of an uncacheable request there is no need
             // to set the exclusive flag, but since the recipient does
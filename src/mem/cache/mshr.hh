@@ -184,6 +184,12 @@ class MSHR : public Packet::SenderState, public Printable
     /** Thread number of the miss. */
     ThreadID threadNum;
 
+    /**
+     * Thread whose reservation in the owning queue this entry is
+     * charged to, InvalidThreadID for shared entries (e.g. prefetches).
+     */
+    ThreadID chargedThread;
+
   private:
 
     /** Data buffer (if needed).  Currently used only for pending
@@ -45,17 +45,22 @@
  * Definition of MSHRQueue class functions.
  */
 
+#include <algorithm>
+
 #include "base/trace.hh"
 #include "mem/cache/mshr_queue.hh"
 #include "debug/Drain.hh"
+#include "debug/MSHR.hh"
 
 using namespace std;
 
 MSHRQueue::MSHRQueue(const std::string &_label, int num_entries, int reserve,
                      int demand_reserve, int _index,
-                     int _cacheLevel)
+                     int _cacheLevel,
+                     const std::vector<unsigned> &thread_reserve)
     : label(_label), numEntries(num_entries + reserve - 1),
       numReserve(reserve), demandReserve(demand_reserve),
+      rationConfig(NULL),
       registers(numEntries), drainManager(NULL), allocated(0),
       inServiceEntries(0), index(_index), cacheLevel(_cacheLevel)
 {
@@ -64,6 +69,77 @@ MSHRQueue::MSHRQueue(const std::string &_label, int num_entries, int reserve,
         freeList.push_back(&registers[i]);
     }
     std::fill(numMissPerThread.begin(), numMissPerThread.end(), 0);
+    setThreadReserve(std::vector<int>(thread_reserve.begin(),
+                                      thread_reserve.end()));
+}
+
+void
+MSHRQueue::setThreadReserve(const std::vector<int> &reserve)
+{
+    if (reserve.size() > numMissPerThread.size()) {
+        fatal("%s: reservations for %i threads, at most %i supported\n",
+              label, reserve.size(), numMissPerThread.size());
+    }
+
+    int total = 0;
+    for (int r : reserve) {
+        if (r < 0) {
+            fatal("%s: negative thread reservation %i\n", label, r);
+        }
+        total += r;
+    }
+    if (total > numReservableEntries()) {
+        fatal("%s: %i entries reserved for threads, only %i of %i may be "
+              "reserved\n", label, total, numReservableEntries(),
+              numUsableEntries());
+    }
+
+    threadReserve = reserve;
+}
+
+void
+MSHRQueue::setRationConfig(MSHRRationConfig *config)
+{
+    rationConfig = config;
+    rationConfig->numEntries = numReservableEntries();
+    if (threadPartitioned()) {
+        for (int i = 0; i < 2; i++) {
+            rationConfig->threadReserves[i] =
+                i < threadReserve.size() ? threadReserve[i] : 0;
+        }
+    }
+}
+
+void
+MSHRQueue::checkRationUpdate()
+{
+    if (!rationConfig || !rationConfig->updatedByCore)
+        return;
+
+    DPRINTF(MSHR, "%s: thread reservations updated to %i/%i\n", label,
+            rationConfig->threadReserves[0], rationConfig->threadReserves[1]);
+    setThreadReserve({rationConfig->threadReserves[0],
+                      rationConfig->threadReserves[1]});
+    rationConfig->updatedByCore = false;
+}
+
+int
+MSHRQueue::unusedReserve(ThreadID except) const
+{
+    int unused = 0;
+    for (ThreadID tid = 0; tid < threadReserve.size(); tid++) {
+        if (tid != except) {
+            unused += std::max(threadReserve[tid] - numMissPerThread[tid], 0);
+        }
+    }
+    return unused;
+}
+
+bool
+MSHRQueue::threadFull(ThreadID tid)
+{
+    checkRationUpdate();
+    return allocated + unusedReserve(tid) > numEntries - numReserve;
 }
 
 MSHR *
@@ -155,6 +231,20 @@ MSHRQueue::allocate(Addr blk_addr, unsigned blk_size, PacketPtr pkt,
     freeList.pop_front();
 
     mshr->allocate(blk_addr, blk_size, pkt, when_ready, order);
+
+    // charge the entry to the requesting thread, prefetches and
+    // requests without a thread go to the shared pool; the prefetcher
+    // tags its requests with the triggering thread, so check the
+    // command rather than the request
+    ThreadID tid = !pkt->cmd.isPrefetch() && pkt->req->hasThreadId() ?
+        pkt->req->threadId() : InvalidThreadID;
+    if (tid >= 0 && tid < numMissPerThread.size()) {
+        mshr->chargedThread = tid;
+        numMissPerThread[tid]++;
+    } else {
+        mshr->chargedThread = InvalidThreadID;
+    }
+
     mshr->allocIter = allocatedList.insert(allocatedList.end(), mshr);
     mshr->readyIter = addToReadyList(mshr);
 
@@ -175,6 +265,10 @@ MSHRQueue::deallocateOne(MSHR *mshr)
     MSHR::Iterator retval = allocatedList.erase(mshr->allocIter);
     freeList.push_front(mshr);
     allocated--;
+    if (mshr->chargedThread != InvalidThreadID) {
+        numMissPerThread[mshr->chargedThread]--;
+        mshr->chargedThread = InvalidThreadID;
+    }
     if (mshr->inService) {
         inServiceEntries--;
     } else {
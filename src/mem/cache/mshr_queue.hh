@@ -48,9 +48,12 @@
 #ifndef __MEM_CACHE_MSHR_QUEUE_HH__
 #define __MEM_CACHE_MSHR_QUEUE_HH__
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
 #include "mem/cache/mshr.hh"
+#include "mem/cache/tags/control_panel.hh"
 #include "mem/packet.hh"
 #include "sim/drain.hh"
 
@@ -83,6 +86,17 @@ class MSHRQueue : public Drainable
      */
     const int demandReserve;
 
+    /**
+     * The number of entries reserved for each hardware thread. Entries
+     * a thread has not used up of its reservation are not available to
+     * other threads or to the prefetcher. Empty if the queue is shared
+     * first-come-first-served.
+     */
+    std::vector<int> threadReserve;
+
+    /** Reservations pushed by the core at runtime, may be null. */
+    MSHRRationConfig *rationConfig;
+
     /**  MSHR storage. */
     std::vector<MSHR> registers;
     /** Holds pointers to all allocated entries. */
@@ -114,9 +128,13 @@ class MSHRQueue : public Drainable
      * any access.
      * @param demand_reserve The minimum number of entries needed to satisfy
      * demand accesses.
+     * @param thread_reserve The number of entries reserved for each
+     * thread, empty if the queue is not partitioned.
      */
     MSHRQueue(const std::string &_label, int num_entries, int reserve, int demand_reserve, int index,
-              int _cacheLevel);
+              int _cacheLevel,
+              const std::vector<unsigned> &thread_reserve =
+                  std::vector<unsigned>());
 
     /**
      * Find the first MSHR that matches the provided address.
@@ -238,7 +256,53 @@ class MSHRQueue : public Drainable
      */
     bool canPrefetch() const
     {
-        return (allocated < numEntries - (numReserve + demandReserve));
+        return (allocated + unusedReserve(InvalidThreadID) <
+                numEntries - (numReserve + demandReserve));
+    }
+
+    /**
+     * Whether entries are reserved per thread in this queue.
+     */
+    bool threadPartitioned() const
+    {
+        return !threadReserve.empty();
+    }
+
+    /**
+     * Returns true if the given thread cannot get another entry without
+     * eating into the unused reservation of other threads.
+     * @param tid The thread, InvalidThreadID for shared requests.
+     */
+    bool threadFull(ThreadID tid);
+
+    /**
+     * Set the per-thread reservations. The reservations may not exceed
+     * the number of reservable entries in total.
+     */
+    void setThreadReserve(const std::vector<int> &reserve);
+
+    /**
+     * Take reservations from the control panel of the core, they are
+     * applied lazily when the core updates them.
+     */
+    void setRationConfig(MSHRRationConfig *config);
+
+    /** The number of entries usable by requests. */
+    int numUsableEntries() const
+    {
+        return numEntries - numReserve + 1;
+    }
+
+    /**
+     * The number of entries the threads may reserve in total. The rest
+     * is a pool shared by all threads and the prefetcher: a quarter of
+     * the usable entries, but enough to let a prefetch in beyond the
+     * demand reserve even when all reservations are unused.
+     */
+    int numReservableEntries() const
+    {
+        int shared = std::max(numUsableEntries() / 4, demandReserve + 2);
+        return std::max(numUsableEntries() - shared, 0);
     }
 
     /**
@@ -260,6 +324,17 @@ class MSHRQueue : public Drainable
 
     unsigned int drain(DrainManager *dm);
 
+  private:
+    /**
+     * Sum of reserved but not yet allocated entries of all threads
+     * except the given one.
+     */
+    int unusedReserve(ThreadID except) const;
+
+  public:
+    /** Apply reservations the core has updated since the last call. */
+    void checkRationUpdate();
+
 #define MaxThreads 4
     std::array<int, MaxThreads> numMissPerThread;
 #undef MaxThreads
@@ -68,6 +68,19 @@ class QueuedPrefetcher(BasePrefetcher):
 
     tag_prefetch = Param.Bool(True, "Tag prefetch with PC of generating access")
 
+    # Feedback-directed throttling: after every throttle_interval
+    # prefetches issued for a thread, its aggressiveness moves up or down
+    # one level depending on the accuracy seen in that interval. The O3
+    # QoS controller can further cap a thread through the control panel.
+    throttle = Param.Bool(False, "Throttle prefetches by per-thread accuracy")
+    throttle_interval = Param.Unsigned(256,
+        "Prefetches issued for a thread between throttle decisions")
+    throttle_levels = Param.Unsigned(4, "Number of aggressiveness levels")
+    accuracy_high = Param.Float(0.75,
+        "Accuracy above which prefetching gets more aggressive")
+    accuracy_low = Param.Float(0.40,
+        "Accuracy below which prefetching gets less aggressive")
+
 class StridePrefetcher(QueuedPrefetcher):
     type = 'StridePrefetcher'
     cxx_class = 'StridePrefetcher'
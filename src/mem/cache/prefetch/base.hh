@@ -124,6 +124,26 @@ class BasePrefetcher : public ClockedObject
 
     virtual Tick nextPrefetchReadyTime() const = 0;
 
+    /**
+     * Feedback from the cache: a prefetched block was referenced for the
+     * first time.
+     * @param tid The thread the block was prefetched for.
+     */
+    virtual void prefetchUseful(ThreadID tid) {}
+
+    /**
+     * Feedback from the cache: a prefetched block was evicted before
+     * being referenced.
+     * @param tid The thread the block was prefetched for.
+     */
+    virtual void prefetchUnused(ThreadID tid) {}
+
+    /**
+     * Feedback from the cache: a demand access missed without an
+     * outstanding MSHR.
+     */
+    virtual void demandMiss(ThreadID tid) {}
+
     virtual void regStats();
 };
 #endif //__MEM_CACHE_PREFETCH_BASE_HH__
@@ -37,16 +37,35 @@
  * Authors: Mitch Hayenga
  */
 
+#include "base/intmath.hh"
 #include "debug/HWPrefetch.hh"
 #include "mem/cache/prefetch/queued.hh"
 #include "mem/cache/base.hh"
 
 QueuedPrefetcher::QueuedPrefetcher(const QueuedPrefetcherParams *p)
-    : BasePrefetcher(p), queueSize(p->queue_size), latency(p->latency),
+    : BasePrefetcher(p), throttleVersion(0),
+      queueSize(p->queue_size), latency(p->latency),
       queueSquash(p->queue_squash), queueFilter(p->queue_filter),
-      cacheSnoop(p->cache_snoop), tagPrefetch(p->tag_prefetch)
+      cacheSnoop(p->cache_snoop), tagPrefetch(p->tag_prefetch),
+      throttle(p->throttle), throttleInterval(p->throttle_interval),
+      throttleLevels(p->throttle_levels),
+      accuracyHigh(p->accuracy_high), accuracyLow(p->accuracy_low)
 {
-
+    if (throttleLevels == 0)
+        fatal("%s: throttle_levels must be at least 1\n", name());
+    if (throttle && throttleInterval == 0)
+        fatal("%s: throttle_interval must be at least 1\n", name());
+    if (accuracyLow > accuracyHigh)
+        fatal("%s: accuracy_low above accuracy_high\n", name());
+
+    for (auto &ts : threadState) {
+        // start at full aggressiveness, as without throttling
+        ts.level = throttleLevels;
+        ts.queued = 0;
+        ts.quota = 1024;
+        ts.intervalIssued = 0;
+        ts.intervalUseful = 0;
+    }
 }
 
 QueuedPrefetcher::~QueuedPrefetcher()
@@ -72,9 +91,7 @@ QueuedPrefetcher::notify(const PacketPtr &pkt)
             while (itr != pfq.end()) {
                 if (itr->pkt->getAddr() == blk_addr &&
                     itr->pkt->isSecure() == is_secure) {
-                    delete itr->pkt->req;
-                    delete itr->pkt;
-                    itr = pfq.erase(itr);
+                    itr = erase(itr);
                 } else {
                     ++itr;
                 }
@@ -88,6 +105,18 @@ QueuedPrefetcher::notify(const PacketPtr &pkt)
         std::vector<Addr> addresses;
         calculatePrefetch(pkt, addresses);
 
+        // Keep as many candidates as the thread's aggressiveness allows,
+        // the nearest ones come first
+        checkThrottleUpdate();
+        ThreadID tid = trackedThread(pkt);
+        unsigned allowed = allowedCandidates(tid, addresses.size());
+        if (allowed < addresses.size()) {
+            DPRINTF(HWPrefetch, "T[%i] throttled to %u of %u prefetches\n",
+                    tid, allowed, addresses.size());
+            pfThrottled[tid] += addresses.size() - allowed;
+            addresses.resize(allowed);
+        }
+
         // Queue up generated prefetches
         for (Addr pf_addr : addresses) {
 
@@ -113,6 +142,14 @@ QueuedPrefetcher::notify(const PacketPtr &pkt)
                 continue;
             }
 
+            // A thread without a share of the queue gets no prefetches
+            if (tid != InvalidThreadID && queueQuota(tid) == 0) {
+                pfRemovedQuota[tid]++;
+                DPRINTF(HWPrefetch, "T[%i] has no prefetch queue quota, "
+                        "dropping addr:%#x\n", tid, pf_addr);
+                continue;
+            }
+
             // Create a prefetch memory request
             Request *pf_req =
                 new Request(pf_addr, blkSize, 0, masterId);
@@ -134,22 +171,30 @@ QueuedPrefetcher::notify(const PacketPtr &pkt)
                 pf_pkt->req->setPC(pkt->req->getPC());
             }
 
+            // Verify the thread's share of the prefetch buffer
+            if (tid != InvalidThreadID &&
+                threadState[tid].queued >= queueQuota(tid)) {
+                DPRINTF(HWPrefetch, "T[%i] prefetch quota full, removing "
+                        "its oldest packets\n", tid);
+                pfRemovedQuota[tid] += removeOldest(tid, queueQuota(tid) - 1);
+            }
+
             // Verify prefetch buffer space for request
             if (pfq.size() == queueSize) {
                 pfRemovedFull++;
-                PacketPtr old_pkt = pfq.begin()->pkt;
                 DPRINTF(HWPrefetch, "Prefetch queue full, removing "
-                        "oldest packet addr: %#x", old_pkt->getAddr());
-                delete old_pkt->req;
-                delete old_pkt;
-                pfq.pop_front();
+                        "oldest packet addr: %#x", pfq.begin()->pkt->getAddr());
+                erase(pfq.begin());
             }
 
             Tick pf_time = curTick() + clockPeriod() * latency;
             DPRINTF(HWPrefetch, "Prefetch queued. "
                     "addr:%#x tick:%lld.\n", pf_addr, pf_time);
 
-            pfq.emplace_back(DeferredPacket(pf_time, pf_pkt));
+            pfq.emplace_back(DeferredPacket(pf_time, pf_pkt, tid));
+            if (tid != InvalidThreadID) {
+                threadState[tid].queued++;
+            }
         }
     }
 
@@ -167,9 +212,18 @@ QueuedPrefetcher::getPacket()
     }
 
     PacketPtr pkt = pfq.begin()->pkt;
+    ThreadID tid = pfq.begin()->tid;
     pfq.pop_front();
 
     pfIssued++;
+    if (tid != InvalidThreadID) {
+        threadState[tid].queued--;
+        pfIssuedThread[tid]++;
+        if (throttle && ++threadState[tid].intervalIssued ==
+                throttleInterval) {
+            updateLevel(tid);
+        }
+    }
     assert(pkt != NULL);
     DPRINTF(HWPrefetch, "Generating prefetch for %#x.\n", pkt->getAddr());
     return pkt;
@@ -186,6 +240,122 @@ QueuedPrefetcher::inPrefetch(Addr address, bool is_secure) const
     return false;
 }
 
+ThreadID
+QueuedPrefetcher::trackedThread(const PacketPtr &pkt) const
+{
+    if (!pkt->req->hasThreadId())
+        return InvalidThreadID;
+    ThreadID tid = pkt->req->threadId();
+    return tid >= 0 && tid < maxThreads ? tid : InvalidThreadID;
+}
+
+void
+QueuedPrefetcher::checkThrottleUpdate()
+{
+    const PrefetchThrottleConfig &config = controlPanel.prefetchConfig;
+    if (config.version == throttleVersion)
+        return;
+
+    DPRINTF(HWPrefetch, "Thread prefetch quotas updated to %i/%i\n",
+            config.threadQuotas[0], config.threadQuotas[1]);
+    for (ThreadID tid = 0; tid < maxThreads; tid++) {
+        threadState[tid].quota = config.threadQuotas[tid];
+        // a shrunk quota takes effect at once, not one candidate at a
+        // time
+        pfRemovedQuota[tid] += removeOldest(tid, queueQuota(tid));
+    }
+    throttleVersion = config.version;
+}
+
+unsigned
+QueuedPrefetcher::allowedCandidates(ThreadID tid, unsigned n) const
+{
+    if (tid == InvalidThreadID)
+        return n;
+
+    const ThreadState &ts = threadState[tid];
+    unsigned level = std::min(ts.level,
+            (unsigned)divCeil(throttleLevels * ts.quota, 1024));
+    return divCeil(n * level, throttleLevels);
+}
+
+unsigned
+QueuedPrefetcher::queueQuota(ThreadID tid) const
+{
+    return queueSize * threadState[tid].quota / 1024;
+}
+
+unsigned
+QueuedPrefetcher::removeOldest(ThreadID tid, unsigned keep)
+{
+    unsigned removed = 0;
+    for (auto itr = pfq.begin();
+         itr != pfq.end() && threadState[tid].queued > keep;) {
+        if (itr->tid == tid) {
+            itr = erase(itr);
+            removed++;
+        } else {
+            ++itr;
+        }
+    }
+    return removed;
+}
+
+std::list<QueuedPrefetcher::DeferredPacket>::iterator
+QueuedPrefetcher::erase(std::list<DeferredPacket>::iterator itr)
+{
+    if (itr->tid != InvalidThreadID) {
+        threadState[itr->tid].queued--;
+    }
+    delete itr->pkt->req;
+    delete itr->pkt;
+    return pfq.erase(itr);
+}
+
+void
+QueuedPrefetcher::updateLevel(ThreadID tid)
+{
+    ThreadState &ts = threadState[tid];
+    double accuracy = double(ts.intervalUseful) / ts.intervalIssued;
+
+    if (accuracy >= accuracyHigh && ts.level < throttleLevels) {
+        ts.level++;
+    } else if (accuracy < accuracyLow && ts.level > 1) {
+        ts.level--;
+    }
+    DPRINTF(HWPrefetch, "T[%i] prefetch accuracy %f, aggressiveness %u/%u\n",
+            tid, accuracy, ts.level, throttleLevels);
+
+    ts.intervalIssued = 0;
+    ts.intervalUseful = 0;
+}
+
+void
+QueuedPrefetcher::prefetchUseful(ThreadID tid)
+{
+    if (tid < 0 || tid >= maxThreads)
+        return;
+    pfUseful[tid]++;
+    threadState[tid].intervalUseful++;
+}
+
+void
+QueuedPrefetcher::prefetchUnused(ThreadID tid)
+{
+    if (tid < 0 || tid >= maxThreads)
+        return;
+    pfUnused[tid]++;
+    controlPanel.prefetchConfig.recentUseless[tid]++;
+}
+
+void
+QueuedPrefetcher::demandMiss(ThreadID tid)
+{
+    if (tid < 0 || tid >= maxThreads)
+        return;
+    pfDemandMisses[tid]++;
+}
+
 void
 QueuedPrefetcher::regStats()
 {
@@ -210,4 +380,58 @@ QueuedPrefetcher::regStats()
     pfSpanPage
         .name(name() + ".pfSpanPage")
         .desc("number of prefetches not generated due to page crossing");
+
+    pfIssuedThread
+        .init(maxThreads)
+        .name(name() + ".pfIssuedThread")
+        .desc("number of prefetches issued per thread")
+        .flags(Stats::total)
+        ;
+
+    pfUseful
+        .init(maxThreads)
+        .name(name() + ".pfUseful")
+        .desc("number of prefetched blocks referenced per thread")
+        .flags(Stats::total)
+        ;
+
+    pfUnused
+        .init(maxThreads)
+        .name(name() + ".pfUnused")
+        .desc("number of prefetched blocks evicted unreferenced per thread")
+        .flags(Stats::total)
+        ;
+
+    pfDemandMisses
+        .init(maxThreads)
+        .name(name() + ".pfDemandMisses")
+        .desc("number of demand misses per thread")
+        .flags(Stats::total)
+        ;
+
+    pfThrottled
+        .init(maxThreads)
+        .name(name() + ".pfThrottled")
+        .desc("number of prefetch candidates dropped by throttling")
+        .flags(Stats::total)
+        ;
+
+    pfRemovedQuota
+        .init(maxThreads)
+        .name(name() + ".pfRemovedQuota")
+        .desc("number of prefetches dropped due to thread queue quota")
+        .flags(Stats::total)
+        ;
+
+    pfAccuracy
+        .name(name() + ".pfAccuracy")
+        .desc("fraction of issued prefetches referenced per thread")
+        ;
+    pfAccuracy = pfUseful / pfIssuedThread;
+
+    pfCoverage
+        .name(name() + ".pfCoverage")
+        .desc("fraction of misses eliminated by prefetching per thread")
+        ;
+    pfCoverage = pfUseful / (pfUseful + pfDemandMisses);
 }
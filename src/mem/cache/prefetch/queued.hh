@@ -40,9 +40,11 @@
 #ifndef __MEM_CACHE_PREFETCH_QUEUED_HH__
 #define __MEM_CACHE_PREFETCH_QUEUED_HH__
 
+#include <array>
 #include <list>
 
 #include "mem/cache/prefetch/base.hh"
+#include "mem/cache/tags/control_panel.hh"
 #include "params/QueuedPrefetcher.hh"
 
 class QueuedPrefetcher : public BasePrefetcher
@@ -51,11 +53,35 @@ class QueuedPrefetcher : public BasePrefetcher
     struct DeferredPacket {
         Tick tick;
         PacketPtr pkt;
-        DeferredPacket(Tick t, PacketPtr p) : tick(t), pkt(p) {}
+        /** Thread that trained the prefetch, InvalidThreadID if unknown */
+        ThreadID tid;
+        DeferredPacket(Tick t, PacketPtr p, ThreadID _tid)
+            : tick(t), pkt(p), tid(_tid) {}
     };
 
     std::list<DeferredPacket> pfq;
 
+    /** Number of hardware threads tracked separately */
+    static const int maxThreads = 2;
+
+    /** Per-thread throttling state */
+    struct ThreadState {
+        /** Aggressiveness, from 1 to throttleLevels */
+        unsigned level;
+        /** Prefetches of this thread in the queue */
+        unsigned queued;
+        /** Share of queue and aggressiveness granted by the core */
+        int quota;
+        /** Prefetches issued and found useful in this interval */
+        Counter intervalIssued;
+        Counter intervalUseful;
+    };
+
+    std::array<ThreadState, maxThreads> threadState;
+
+    /** Last control panel version applied */
+    uint64_t throttleVersion;
+
     // PARAMETERS
 
     /** Maximum size of the prefetch queue */
@@ -76,8 +102,49 @@ class QueuedPrefetcher : public BasePrefetcher
     /** Tag prefetch with PC of generating access? */
     const bool tagPrefetch;
 
+    /** Adjust aggressiveness by the accuracy of each thread? */
+    const bool throttle;
+
+    /** Prefetches issued for a thread between throttle decisions */
+    const unsigned throttleInterval;
+
+    /** Number of aggressiveness levels */
+    const unsigned throttleLevels;
+
+    /** Accuracy above which a thread gets more aggressive */
+    const double accuracyHigh;
+
+    /** Accuracy below which a thread gets less aggressive */
+    const double accuracyLow;
+
     bool inPrefetch(Addr address, bool is_secure) const;
 
+    /** The thread a prefetch or access is accounted to */
+    ThreadID trackedThread(const PacketPtr &pkt) const;
+
+    /** Apply quotas the core has updated since the last call */
+    void checkThrottleUpdate();
+
+    /** Number of the n candidates of a thread that may be queued */
+    unsigned allowedCandidates(ThreadID tid, unsigned n) const;
+
+    /** Number of queue entries a thread may hold */
+    unsigned queueQuota(ThreadID tid) const;
+
+    /**
+     * Drop the oldest queued prefetches of the given thread until it
+     * holds at most keep entries.
+     * @return The number of prefetches dropped.
+     */
+    unsigned removeOldest(ThreadID tid, unsigned keep);
+
+    /** Re-evaluate a thread's aggressiveness at the end of an interval */
+    void updateLevel(ThreadID tid);
+
+    /** Remove the packet from the queue and free it */
+    std::list<DeferredPacket>::iterator
+    erase(std::list<DeferredPacket>::iterator itr);
+
     // STATS
     Stats::Scalar pfIdentified;
     Stats::Scalar pfBufferHit;
@@ -85,6 +152,15 @@ class QueuedPrefetcher : public BasePrefetcher
     Stats::Scalar pfRemovedFull;
     Stats::Scalar pfSpanPage;
 
+    Stats::Vector pfIssuedThread;
+    Stats::Vector pfUseful;
+    Stats::Vector pfUnused;
+    Stats::Vector pfDemandMisses;
+    Stats::Vector pfThrottled;
+    Stats::Vector pfRemovedQuota;
+    Stats::Formula pfAccuracy;
+    Stats::Formula pfCoverage;
+
   public:
     QueuedPrefetcher(const QueuedPrefetcherParams *p);
     virtual ~QueuedPrefetcher();
@@ -101,6 +177,12 @@ class QueuedPrefetcher : public BasePrefetcher
         return pfq.empty() ? MaxTick : pfq.front().tick;
     }
 
+    void prefetchUseful(ThreadID tid);
+
+    void prefetchUnused(ThreadID tid);
+
+    void demandMiss(ThreadID tid);
+
     void regStats();
 };
 
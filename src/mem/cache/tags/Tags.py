@@ -61,6 +61,10 @@ class BaseSetAssoc(BaseTags):
     abstract = True
     cxx_header = "mem/cache/tags/base_set_assoc.hh"
     assoc = Param.Int(Parent.assoc, "associativity")
+    share_block_data = Param.Bool(Parent.share_block_data,
+        "Blocks get their data from shared buffers, not a data array")
+    no_data = Param.Bool(Parent.no_data,
+        "Blocks refer to the backing store, not a data array")
     sequential_access = Param.Bool(Parent.sequential_access,
         "Whether to access tags and data sequentially")
 
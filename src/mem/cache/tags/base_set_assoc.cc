@@ -81,9 +81,11 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
 
     sets = new SetType[numSets];
     blks = new BlkType[numSets * assoc];
-    // allocate data storage in one big chunk
+    // allocate data storage in one big chunk, unless the cache hands
+    // the blocks shared buffers or the backing store as they are filled
     numBlocks = numSets * assoc;
-    dataBlks = new uint8_t[numBlocks * blkSize];
+    dataBlks = p->share_block_data || p->no_data ? NULL :
+        new uint8_t[numBlocks * blkSize];
 
     unsigned blkIndex = 0;       // index into blks array
     for (unsigned i = 0; i < numSets; ++i) {
@@ -95,7 +97,7 @@ BaseSetAssoc::BaseSetAssoc(const Params *p)
         for (unsigned j = 0; j < assoc; ++j) {
             // locate next cache block
             BlkType *blk = &blks[blkIndex];
-            blk->data = &dataBlks[blkSize*blkIndex];
+            blk->data = dataBlks ? &dataBlks[blkSize*blkIndex] : NULL;
             ++blkIndex;
 
             // invalidate new cache block
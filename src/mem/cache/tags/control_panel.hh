@@ -12,6 +12,33 @@ struct WayRationConfig {
     int threadWayRations[MaxThreads];
 #undef MaxThreads
     int assoc;
+    // Bumped by the core on every update, for the caches that follow
+    // the rations without consuming updatedByCore
+    uint64_t version;
+    // Thread 0 misses found in the shadow tags since the core last looked
+    uint64_t recentShadowHits;
+};
+
+struct MSHRRationConfig {
+    bool updatedByCore;
+#define MaxThreads 2
+    int threadReserves[MaxThreads];
+#undef MaxThreads
+    // Entries the threads may reserve in total, the rest of the queue
+    // is shared; 0 if no such cache registered
+    int numEntries;
+};
+
+struct PrefetchThrottleConfig {
+    // Bumped by the core on every update, each prefetcher keeps the last
+    // version it applied
+    uint64_t version;
+#define MaxThreads 2
+    // Share of prefetch queue and aggressiveness, out of 1024
+    int threadQuotas[MaxThreads];
+    // Prefetches evicted unused since the core last looked
+    uint64_t recentUseless[MaxThreads];
+#undef MaxThreads
 };
 
 class ControlPanel {
@@ -20,10 +47,32 @@ public:
     WayRationConfig l1DCacheWayConfig;
     WayRationConfig l2CacheWayConfig;
 
+    MSHRRationConfig l1IMSHRConfig;
+    MSHRRationConfig l1DMSHRConfig;
+    MSHRRationConfig l2MSHRConfig;
+
+    PrefetchThrottleConfig prefetchConfig;
+
     ControlPanel() {
-        l1ICacheWayConfig.updatedByCore = false;
-        l1DCacheWayConfig.updatedByCore = false;
-        l2CacheWayConfig.updatedByCore = false;
+        for (auto config : {&l1ICacheWayConfig, &l1DCacheWayConfig,
+                            &l2CacheWayConfig}) {
+            config->updatedByCore = false;
+            config->version = 0;
+            config->recentShadowHits = 0;
+        }
+
+        for (auto config : {&l1IMSHRConfig, &l1DMSHRConfig, &l2MSHRConfig}) {
+            config->updatedByCore = false;
+            config->threadReserves[0] = 0;
+            config->threadReserves[1] = 0;
+            config->numEntries = 0;
+        }
+
+        prefetchConfig.version = 0;
+        for (int i = 0; i < 2; i++) {
+            prefetchConfig.threadQuotas[i] = 1024;
+            prefetchConfig.recentUseless[i] = 0;
+        }
     }
 };
 
@@ -57,11 +57,11 @@ LRUDynPartition::LRUDynPartition(const Params *p)
         : BaseSetAssoc(p), cacheLevel(p->cache_level), isDCache(p->is_dcache),
           shadowLRUTag(numSets, (unsigned int) p->shadow_tag_assoc, this)
 {
-    assert(numSets <= MAX_NUM_SETS);
     int rationFirst = p->thread_0_assoc;
+    threadWayRation[0] = rationFirst;
+    threadWayRation[1] = assoc - rationFirst;
+    wayCount.resize(numSets);
     for (int i = 0; i < numSets; i++) {
-        threadWayRation[i][0] = rationFirst;
-        threadWayRation[i][1] = assoc - rationFirst;
         wayCount[i][0] = 0;
         wayCount[i][1] = 0;
     }
@@ -149,7 +149,7 @@ LRUDynPartition::findVictim(Addr addr)
     get3PossibleVictim(invalidVictim, selfVictim, otherVictim, curThreadID, set);
     DPRINTF(DynCache2, "Got victim\n");
 
-    if (threadWayRation[set][curThreadID] > wayCount[set][curThreadID]) {
+    if (threadWayRation[curThreadID] > wayCount[set][curThreadID]) {
         if (invalidVictim != nullptr) {
             blk = invalidVictim;
         } else {
@@ -164,14 +164,14 @@ LRUDynPartition::findVictim(Addr addr)
         blk = selfVictim;
     }
 
-    assert(threadWayRation[set][curThreadID] > 0);
-    assert(threadWayRation[set][1-curThreadID] > 0);
+    assert(threadWayRation[curThreadID] > 0);
+    assert(threadWayRation[1-curThreadID] > 0);
 
     // NOTE that the real way allocation will not change
     // as soon as the ration changes,
     // so following two assertion is false
-    // assert(threadWayRation[set][curThreadID] >= wayCount[set][curThreadID]);
-    // assert(threadWayRation[set][1-curThreadID] >= wayCount[set][1-curThreadID]);
+    // assert(threadWayRation[curThreadID] >= wayCount[set][curThreadID]);
+    // assert(threadWayRation[1-curThreadID] >= wayCount[set][1-curThreadID]);
 
     assert(wayCount[set][curThreadID] >= 0);
     assert(wayCount[set][1-curThreadID] >= 0);
@@ -216,10 +216,8 @@ LRUDynPartition::invalidate(CacheBlk *blk)
 void
 LRUDynPartition::wayRealloc(ThreadID tid, int wayNum)
 {
-    for (int i = 0; i < numSets; i++) {
-        threadWayRation[i][tid] = wayNum ;
-        threadWayRation[i][1-tid] = assoc - wayNum ;
-    }
+    threadWayRation[tid] = wayNum;
+    threadWayRation[1-tid] = assoc - wayNum;
 }
 
 void
@@ -235,13 +233,11 @@ LRUDynPartition::checkWayRationUpdate() {
         panic("Associativity exceeds\n");
     }
 
-    for (int i = 0; i < ((int) numSets); i++) {
-        threadWayRation[i][0] = wayRationConfig->threadWayRations[0];
-        threadWayRation[i][1] = wayRationConfig->threadWayRations[1];
-    }
+    threadWayRation[0] = wayRationConfig->threadWayRations[0];
+    threadWayRation[1] = wayRationConfig->threadWayRations[1];
     DPRINTF(DynCache3, "Reallocating Thread way ration:\n");
     DPRINTFR(DynCache3, "Thread 0: %i, Thread 1: %i\n",
-             threadWayRation[0][0], threadWayRation[0][1]);
+             threadWayRation[0], threadWayRation[1]);
 
     wayRationConfig->updatedByCore = false;
 }
@@ -266,7 +262,7 @@ LRUDynPartition::get3PossibleVictim(
         DPRINTFR(DynCache2, "Thread[0] wayCount: %i, Thread[1] wayCount: %i, "
                 "Thread[0] ration: %i, Thread[1] ration: %i, curThreadID: %i\n",
                 wayCount[setIndex][0], wayCount[setIndex][1],
-                threadWayRation[setIndex][0], threadWayRation[setIndex][1],
+                threadWayRation[0], threadWayRation[1],
                 tid);
         for (int i = assoc - 1; i >= 0; i--) {
             DPRINTFR(DynCache2, "Block [%i] ---- Thread[%i]\n",
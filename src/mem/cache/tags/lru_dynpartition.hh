@@ -50,6 +50,9 @@
 #ifndef __MEM_CACHE_TAGS_LRUDynPartition_HH__
 #define __MEM_CACHE_TAGS_LRUDynPartition_HH__
 
+#include <array>
+#include <vector>
+
 #include "mem/cache/tags/base_set_assoc.hh"
 #include "mem/cache/tags/shadow_lru_tag.hh"
 #include "mem/cache/tags/control_panel.hh"
@@ -94,13 +97,14 @@ class LRUDynPartition : public BaseSetAssoc
 
   private:
     /**
-     * Determine the upper bound ways for each thread
-     * the max numSets is 128 (to simplify implementation).
+     * Upper bound of the ways each thread may hold in a set; the
+     * ration is always changed for all sets at once.
      */
-#define MAX_NUM_SETS 4096
 #define MaxThreads 2
-    int threadWayRation[MAX_NUM_SETS][MaxThreads];
-    int wayCount[MAX_NUM_SETS][MaxThreads];
+    int threadWayRation[MaxThreads];
+
+    /** Ways each thread currently holds, per set. */
+    std::vector<std::array<int16_t, MaxThreads> > wayCount;
 
     ThreadID curThreadID;
 #undef MaxThreads
@@ -51,9 +51,8 @@
 
 
 LRUPartition::LRUPartition(const Params *p)
-    : BaseSetAssoc(p)
+    : BaseSetAssoc(p), threadWayRation(numSets)
 {
-    assert(numSets <= MAX_NUM_SETS);
     int rationFirst = p->thread_0_assoc;
     for (int i = 0; i < numSets; i++) {
         threadWayRation[i][0] = rationFirst;
@@ -50,6 +50,9 @@
 #ifndef __MEM_CACHE_TAGS_LRUPartition_HH__
 #define __MEM_CACHE_TAGS_LRUPartition_HH__
 
+#include <array>
+#include <vector>
+
 #include "mem/cache/tags/base_set_assoc.hh"
 #include "params/LRUPartition.hh"
 
@@ -85,11 +88,10 @@ class LRUPartition : public BaseSetAssoc
 
   private:
     /**
-     * Determine the upper bound ways for each thread
-     * the max numSets is 128 (to simplify implementation).
+     * Ways each thread may still claim in a set; a thread's blocks
+     * are replaced among themselves once its share is used up.
      */
-#define MAX_NUM_SETS 4096
-    int threadWayRation[MAX_NUM_SETS][2];
+    std::vector<std::array<int16_t, 2> > threadWayRation;
     ThreadID curThreadID;
 };
 
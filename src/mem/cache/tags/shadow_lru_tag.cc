@@ -7,18 +7,29 @@ ShadowLRUTag::ShadowLRUTag(unsigned _numSet, unsigned _shadowAssoc,
                            BaseSetAssoc *_baseSetAssoc)
     :numSet(_numSet), shadowAssoc(_shadowAssoc),
      baseSetAssoc(_baseSetAssoc),
-     shadowTags(numSet, std::list<ShadowTag>(shadowAssoc, ShadowTag(false, 0)))
+     shadowTags(numSet * shadowAssoc, ShadowTag(false, 0))
 {
     DPRINTF(DynCache, "shadow tag num set: %i, assoc: %i\n", numSet, shadowAssoc);
 }
 
+std::vector<ShadowTag>::iterator
+ShadowLRUTag::setBegin(Addr address) {
+    return shadowTags.begin() +
+        baseSetAssoc->extractSet(address) * shadowAssoc;
+}
+
+std::vector<ShadowTag>::const_iterator
+ShadowLRUTag::setBegin(Addr address) const {
+    return shadowTags.begin() +
+        baseSetAssoc->extractSet(address) * shadowAssoc;
+}
+
 bool ShadowLRUTag::findBlock(Addr address) const {
-    auto setIndex = baseSetAssoc->extractSet(address);
     auto targetTag = baseSetAssoc->extractTag(address);
-    auto &shadowSet = shadowTags[setIndex];
+    auto begin = setBegin(address);
 
-    for (auto &tag : shadowSet) {
-        if (tag.valid && tag.tag == targetTag) {
+    for (auto it = begin; it != begin + shadowAssoc; ++it) {
+        if (it->valid && it->tag == targetTag) {
             return true;
         }
     }
@@ -26,15 +37,12 @@ bool ShadowLRUTag::findBlock(Addr address) const {
 }
 
 void ShadowLRUTag::touch(Addr address) {
-    auto setIndex = baseSetAssoc->extractSet(address);
     auto targetTag = baseSetAssoc->extractTag(address);
-    auto &shadowSet = shadowTags[setIndex];
+    auto begin = setBegin(address);
 
-    for (auto it = shadowSet.begin(); it != shadowSet.end(); ++it) {
+    for (auto it = begin; it != begin + shadowAssoc; ++it) {
         if (it->valid && it->tag == targetTag) {
-            auto tmp = *it;
-            shadowSet.erase(it);
-            shadowSet.push_front(tmp);
+            std::rotate(begin, it, it + 1);
             return;
         }
     }
@@ -42,10 +50,10 @@ void ShadowLRUTag::touch(Addr address) {
 }
 
 void ShadowLRUTag::insert(Addr address) {
-    auto setIndex = baseSetAssoc->extractSet(address);
     auto targetTag = baseSetAssoc->extractTag(address);
-    auto &shadowSet = shadowTags[setIndex];
+    auto begin = setBegin(address);
+    auto end = begin + shadowAssoc;
 
-    shadowSet.pop_back();
-    shadowSet.emplace_front(ShadowTag(true, targetTag));
+    std::rotate(begin, end - 1, end);
+    *begin = ShadowTag(true, targetTag);
 }
@@ -1,7 +1,6 @@
 #include "base/types.hh"
 #include "mem/cache/tags/base_set_assoc.hh"
 
-#include <list>
 #include <vector>
 
 struct ShadowTag {
@@ -13,15 +12,21 @@ struct ShadowTag {
 
 class ShadowLRUTag
 {
-    typedef std::list<ShadowTag> ShadowSet;
-
     const unsigned int numSet;
 
     const unsigned int shadowAssoc;
 
     const BaseSetAssoc *baseSetAssoc;
 
-    std::vector<ShadowSet> shadowTags;
+    /**
+     * All shadow sets back to back, shadowAssoc entries each, every
+     * set ordered from MRU to LRU.
+     */
+    std::vector<ShadowTag> shadowTags;
+
+    std::vector<ShadowTag>::iterator setBegin(Addr address);
+
+    std::vector<ShadowTag>::const_iterator setBegin(Addr address) const;
 
 public:
 
@@ -44,6 +44,7 @@
  */
 
 #include "base/bitfield.hh"
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
 #include "debug/DRAMPower.hh"
@@ -240,6 +241,27 @@ DRAMCtrl::init()
             assert(columnsPerStripe <= columnsPerRowBuffer);
         }
     }
+
+    // with DRAM partitions, tell the system where the bank and rank
+    // bits are so that it can color the pages of each process
+    if (system()->numDRAMPartitions() > 1) {
+        // all the mappings keep the bank and rank bits next to each
+        // other, with the banks below the ranks
+        uint64_t below_bank = burstSize * channels;
+        if (addrMapping == Enums::RoCoRaBaCh) {
+            below_bank *= columnsPerStripe;
+        } else {
+            below_bank *= columnsPerRowBuffer;
+        }
+
+        if (!isPowerOf2(below_bank) || !isPowerOf2(banksPerRank) ||
+            !isPowerOf2(ranksPerChannel))
+            fatal("%s needs power-of-two address fields for DRAM "
+                  "partitions\n", name());
+
+        system()->setPageColoring(floorLog2(below_bank),
+                                  banksPerRank * ranksPerChannel);
+    }
 }
 
 void
@@ -1073,6 +1095,13 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
 
         // If there is a page open, precharge it.
         if (bank.openRow != Bank::NO_ROW) {
+            // another thread closing the row is the interference that
+            // DRAM partitions are meant to remove
+            if (bank.rowOwner != InvalidThreadID &&
+                dram_pkt->threadId != InvalidThreadID &&
+                bank.rowOwner != dram_pkt->threadId) {
+                ++crossThreadRowConflicts;
+            }
             prechargeBank(rank, bank, std::max(bank.preAllowedAt, curTick()));
         }
 
@@ -1083,6 +1112,7 @@ DRAMCtrl::doDRAMAccess(DRAMPacket* dram_pkt)
         // Record the activation and deal with all the global timing
         // constraints caused be a new activation (tRRD and tXAW)
         activateBank(rank, bank, act_tick, dram_pkt->row);
+        bank.rowOwner = dram_pkt->threadId;
 
         // issue the command as early as possible
         cmd_at = bank.colAllowedAt;
@@ -2026,6 +2056,10 @@ DRAMCtrl::regStats()
         .name(name() + ".writeRowHits")
         .desc("Number of row buffer hits during writes");
 
+    crossThreadRowConflicts
+        .name(name() + ".crossThreadRowConflicts")
+        .desc("Number of open rows closed by a different thread");
+
     readRowHitRate
         .name(name() + ".readRowHitRate")
         .desc("Row buffer hit rate for reads")
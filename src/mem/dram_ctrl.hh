@@ -171,10 +171,13 @@ class DRAMCtrl : public AbstractMemory
         uint32_t rowAccesses;
         uint32_t bytesAccessed;
 
+        /** Thread whose access opened the current row */
+        ThreadID rowOwner;
+
         Bank() :
             openRow(NO_ROW), bank(0), bankgr(0),
             colAllowedAt(0), preAllowedAt(0), actAllowedAt(0),
-            rowAccesses(0), bytesAccessed(0)
+            rowAccesses(0), bytesAccessed(0), rowOwner(InvalidThreadID)
         { }
     };
 
@@ -425,6 +428,9 @@ class DRAMCtrl : public AbstractMemory
 
         const bool isRead;
 
+        /** The hardware thread the request originates from */
+        const ThreadID threadId;
+
         /** Will be populated by address decoder */
         const uint8_t rank;
         const uint8_t bank;
@@ -463,7 +469,10 @@ class DRAMCtrl : public AbstractMemory
                    uint32_t _row, uint16_t bank_id, Addr _addr,
                    unsigned int _size, Bank& bank_ref, Rank& rank_ref)
             : entryTime(curTick()), readyTime(curTick()),
-              pkt(_pkt), isRead(is_read), rank(_rank), bank(_bank), row(_row),
+              pkt(_pkt), isRead(is_read),
+              threadId(_pkt->req->hasThreadId() ?
+                       _pkt->req->threadId() : InvalidThreadID),
+              rank(_rank), bank(_bank), row(_row),
               bankId(bank_id), addr(_addr), size(_size), burstHelper(NULL),
               bankRef(bank_ref), rankRef(rank_ref)
         { }
@@ -811,6 +820,7 @@ class DRAMCtrl : public AbstractMemory
     // Row hit count and rate
     Stats::Scalar readRowHits;
     Stats::Scalar writeRowHits;
+    Stats::Scalar crossThreadRowConflicts;
     Stats::Formula readRowHitRate;
     Stats::Formula writeRowHitRate;
     Stats::Formula avgGap;
@@ -62,6 +62,7 @@
 #include "base/misc.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
+#include "mem/block_data.hh"
 #include "mem/request.hh"
 #include "sim/core.hh"
 
@@ -258,6 +259,10 @@ class Packet : public Printable
     /// the packet is destroyed. The pointer is assumed to be pointing
     /// to an array, and delete [] is consequently called
     static const FlagsType DYNAMIC_DATA           = 0x00002000;
+    /// The data pointer points into a reference counted block buffer
+    /// that may also be held by cache blocks and other packets. It is
+    /// released, not freed, when the packet is destroyed.
+    static const FlagsType SHARED_DATA            = 0x00004000;
     /// suppress the error if this packet encounters a functional
     /// access failure.
     static const FlagsType SUPPRESS_FUNC_ERROR    = 0x00008000;
@@ -286,6 +291,9 @@ class Packet : public Printable
     */
     PacketDataPtr data;
 
+    /// Keeps the buffer behind data alive when SHARED_DATA is set.
+    BlockDataPtr blockData;
+
     /// The address of the request.  This address could be virtual or
     /// physical, depending on the system configuration.
     Addr addr;
@@ -637,6 +645,11 @@ class Packet : public Printable
             if (pkt->flags.isSet(STATIC_DATA)) {
                 data = pkt->data;
                 flags.set(STATIC_DATA);
+            } else if (pkt->flags.isSet(SHARED_DATA) &&
+                       pkt->isResponse()) {
+                // responses are never written again on their way
+                // back, so the copy can refer to the same buffer
+                dataShared(pkt->blockData);
             } else {
                 allocate();
             }
@@ -773,7 +786,7 @@ class Packet : public Printable
     void
     dataStatic(T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         data = (PacketDataPtr)p;
         flags.set(STATIC_DATA);
     }
@@ -790,7 +803,7 @@ class Packet : public Printable
     void
     dataStaticConst(const T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         data = const_cast<PacketDataPtr>(p);
         flags.set(STATIC_DATA);
     }
@@ -811,11 +824,51 @@ class Packet : public Printable
     void
     dataDynamic(T *p)
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         data = (PacketDataPtr)p;
         flags.set(DYNAMIC_DATA);
     }
 
+    /**
+     * Refer to a reference counted block buffer rather than owning a
+     * copy of the data. The buffer may be shared with cache blocks
+     * and other packets, so whoever writes into the packet afterwards
+     * must be the one that allocated the buffer for it (e.g. the
+     * memory filling a read response).
+     */
+    void
+    dataShared(const BlockDataPtr &buf)
+    {
+        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
+        assert(buf && buf->size() >= getSize());
+        blockData = buf;
+        data = blockData->data();
+        flags.set(SHARED_DATA);
+    }
+
+    /** Allocate a fresh, not yet shared block buffer for the packet. */
+    void
+    allocateShared()
+    {
+        dataShared(BlockData::create(getSize()));
+    }
+
+    /**
+     * Does the packet carry its data? Packets between caches running
+     * without data (no_data) have a data command but no payload.
+     */
+    bool
+    hasPayload() const
+    {
+        return flags.isSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA);
+    }
+
+    /** Does the packet refer to a reference counted block buffer? */
+    bool hasSharedData() const { return flags.isSet(SHARED_DATA); }
+
+    /** The block buffer behind the data, only valid if hasSharedData(). */
+    const BlockDataPtr &sharedData() const { return blockData; }
+
     /**
      * get a pointer to the data ptr.
      */
@@ -823,7 +876,7 @@ class Packet : public Printable
     T*
     getPtr()
     {
-        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         return (T*)data;
     }
 
@@ -831,7 +884,7 @@ class Packet : public Printable
     const T*
     getConstPtr() const
     {
-        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         return (const T*)data;
     }
 
@@ -874,6 +927,22 @@ class Packet : public Printable
         setData(blk_data + getOffset(blkSize));
     }
 
+    /**
+     * Fill a whole-block packet from a block buffer. Unless the
+     * requester supplied its own (static) storage, the packet simply
+     * takes a reference to the buffer instead of copying it.
+     */
+    void
+    setDataFromSharedBlock(const BlockDataPtr &buf, int blkSize)
+    {
+        if (getSize() == blkSize && flags.noneSet(STATIC_DATA)) {
+            deleteData();
+            dataShared(buf);
+        } else {
+            setDataFromBlock(buf->data(), blkSize);
+        }
+    }
+
     /**
      * Copy data from the packet to the provided block pointer, which
      * is aligned to the given block size.
@@ -902,8 +971,10 @@ class Packet : public Printable
     {
         if (flags.isSet(DYNAMIC_DATA))
             delete [] data;
+        else if (flags.isSet(SHARED_DATA))
+            blockData = NULL;
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA);
         data = NULL;
     }
 
@@ -911,7 +982,7 @@ class Packet : public Printable
     void
     allocate()
     {
-        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
+        assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
         flags.set(DYNAMIC_DATA);
         data = new uint8_t[getSize()];
     }
@@ -932,7 +1003,7 @@ class Packet : public Printable
         // data pointer
         return checkFunctional(other, other->getAddr(), other->isSecure(),
                                other->getSize(),
-                               other->hasData() ?
+                               other->hasData() && other->hasPayload() ?
                                other->getPtr<uint8_t>() : NULL);
     }
 
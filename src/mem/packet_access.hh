@@ -47,7 +47,7 @@ template <typename T>
 inline T
 Packet::get() const
 {
-    assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
+    assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
     assert(sizeof(T) <= size);
     return TheISA::gtoh(*(T*)data);
 }
@@ -57,7 +57,7 @@ template <typename T>
 inline void
 Packet::set(T v)
 {
-    assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA));
+    assert(flags.isSet(STATIC_DATA|DYNAMIC_DATA|SHARED_DATA));
     assert(sizeof(T) <= size);
     *(T*)data = TheISA::htog(v);
 }
@@ -201,6 +201,16 @@ PhysicalMemory::~PhysicalMemory()
         munmap((char*)s.second, s.first.size());
 }
 
+uint8_t *
+PhysicalMemory::toHostAddr(Addr addr) const
+{
+    for (const auto& s : backingStore) {
+        if (s.first.contains(addr))
+            return s.second + (addr - s.first.start());
+    }
+    return NULL;
+}
+
 bool
 PhysicalMemory::isMemAddr(Addr addr) const
 {
@@ -170,6 +170,16 @@ class PhysicalMemory : public Serializable
     std::vector<std::pair<AddrRange, uint8_t*>> getBackingStore() const
     { return backingStore; }
 
+    /**
+     * Get the host address of a guest physical address in the backing
+     * store.
+     *
+     * @param addr Physical address to look up
+     * @return Pointer into the backing store, or NULL if the address
+     *         is not backed by host memory
+     */
+    uint8_t *toHostAddr(Addr addr) const;
+
     /**
      * Perform an untimed memory access and update all the state
      * (e.g. locked addresses) and statistics accordingly. The packet
@@ -26,6 +26,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "base/intmath.hh"
 #include "mem/ruby/common/Consumer.hh"
 
 using namespace std;
@@ -39,6 +40,19 @@ Consumer::scheduleEvent(Cycles timeDelta)
 void
 Consumer::scheduleEventAbsolute(Tick evt_time)
 {
+    // Wake up on our own clock edge, so that messages arriving from
+    // senders in other clock domains within the same cycle share one
+    // wakeup.
+    Tick now_edge = em->clockEdge();
+    Tick period = em->clockPeriod();
+    evt_time = evt_time <= now_edge ? now_edge :
+        now_edge + divCeil(evt_time - now_edge, period) * period;
+
+    // Most messages of a cycle arrive together
+    if (evt_time == m_last_wakeup)
+        return;
+    m_last_wakeup = evt_time;
+
     if (!alreadyScheduled(evt_time)) {
         // This wakeup is not redundant
         ConsumerEvent *evt = new ConsumerEvent(this);
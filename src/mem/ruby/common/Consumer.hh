@@ -44,7 +44,7 @@ class Consumer
 {
   public:
     Consumer(ClockedObject *_em)
-        : em(_em)
+        : m_last_wakeup(MaxTick), em(_em)
     {
     }
 
@@ -75,6 +75,8 @@ class Consumer
 
   private:
     std::set<Tick> m_scheduled_wakeups;
+    //! Most recent wakeup scheduled, to skip the set on repeats
+    Tick m_last_wakeup;
     ClockedObject *em;
 
     class ConsumerEvent : public Event
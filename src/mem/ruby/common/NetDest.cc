@@ -45,8 +45,7 @@ NetDest::add(MachineID newElement)
 void
 NetDest::addNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].addSet(netDest.m_bits[i]);
     }
 }
@@ -69,8 +68,7 @@ NetDest::remove(MachineID oldElement)
 void
 NetDest::removeNetDest(const NetDest& netDest)
 {
-    assert(m_bits.size() == netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].removeSet(netDest.m_bits[i]);
     }
 }
@@ -78,7 +76,7 @@ NetDest::removeNetDest(const NetDest& netDest)
 void
 NetDest::clear()
 {
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].clear();
     }
 }
@@ -107,12 +105,11 @@ NetDest::getAllDest()
 {
     std::vector<NodeID> dest;
     dest.clear();
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (int j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                int id = MachineType_base_number((MachineType)i) + j;
-                dest.push_back((NodeID)id);
-            }
+    for (int i = 0; i < MachineType_NUM; i++) {
+        int base = MachineType_base_number((MachineType)i);
+        for (NodeID j = m_bits[i].nextElement(0); j < m_bits[i].getSize();
+             j = m_bits[i].nextElement(j + 1)) {
+            dest.push_back((NodeID)(base + j));
         }
     }
     return dest;
@@ -122,7 +119,7 @@ int
 NetDest::count() const
 {
     int counter = 0;
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         counter += m_bits[i].count();
     }
     return counter;
@@ -138,12 +135,11 @@ MachineID
 NetDest::smallestElement() const
 {
     assert(count() > 0);
-    for (int i = 0; i < m_bits.size(); i++) {
-        for (NodeID j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                MachineID mach = {MachineType_from_base_level(i), j};
-                return mach;
-            }
+    for (int i = 0; i < MachineType_NUM; i++) {
+        NodeID j = m_bits[i].nextElement(0);
+        if (j < m_bits[i].getSize()) {
+            MachineID mach = {MachineType_from_base_level(i), j};
+            return mach;
         }
     }
     panic("No smallest element of an empty set.");
@@ -152,12 +148,11 @@ NetDest::smallestElement() const
 MachineID
 NetDest::smallestElement(MachineType machine) const
 {
-    int size = m_bits[MachineType_base_level(machine)].getSize();
-    for (NodeID j = 0; j < size; j++) {
-        if (m_bits[MachineType_base_level(machine)].isElement(j)) {
-            MachineID mach = {machine, j};
-            return mach;
-        }
+    const Set& bits = m_bits[MachineType_base_level(machine)];
+    NodeID j = bits.nextElement(0);
+    if (j < bits.getSize()) {
+        MachineID mach = {machine, j};
+        return mach;
     }
 
     panic("No smallest element of given MachineType.");
@@ -167,7 +162,7 @@ NetDest::smallestElement(MachineType machine) const
 bool
 NetDest::isBroadcast() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].isBroadcast()) {
             return false;
         }
@@ -179,7 +174,7 @@ NetDest::isBroadcast() const
 bool
 NetDest::isEmpty() const
 {
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].isEmpty()) {
             return false;
         }
@@ -191,9 +186,8 @@ NetDest::isEmpty() const
 NetDest
 NetDest::OR(const NetDest& orNetDest) const
 {
-    assert(m_bits.size() == orNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         result.m_bits[i] = m_bits[i].OR(orNetDest.m_bits[i]);
     }
     return result;
@@ -203,9 +197,8 @@ NetDest::OR(const NetDest& orNetDest) const
 NetDest
 NetDest::AND(const NetDest& andNetDest) const
 {
-    assert(m_bits.size() == andNetDest.getSize());
     NetDest result;
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         result.m_bits[i] = m_bits[i].AND(andNetDest.m_bits[i]);
     }
     return result;
@@ -215,8 +208,7 @@ NetDest::AND(const NetDest& andNetDest) const
 bool
 NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 {
-    assert(m_bits.size() == other_netDest.getSize());
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].intersectionIsEmpty(other_netDest.m_bits[i])) {
             return true;
         }
@@ -227,9 +219,7 @@ NetDest::intersectionIsNotEmpty(const NetDest& other_netDest) const
 bool
 NetDest::isSuperset(const NetDest& test) const
 {
-    assert(m_bits.size() == test.getSize());
-
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         if (!m_bits[i].isSuperset(test.m_bits[i])) {
             return false;
         }
@@ -246,10 +236,9 @@ NetDest::isElement(MachineID element) const
 void
 NetDest::resize()
 {
-    m_bits.resize(MachineType_base_level(MachineType_NUM));
-    assert(m_bits.size() == MachineType_NUM);
+    assert(MachineType_base_level(MachineType_NUM) == MachineType_NUM);
 
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         m_bits[i].setSize(MachineType_base_count((MachineType)i));
     }
 }
@@ -257,9 +246,9 @@ NetDest::resize()
 void
 NetDest::print(std::ostream& out) const
 {
-    out << "[NetDest (" << m_bits.size() << ") ";
+    out << "[NetDest (" << MachineType_NUM << ") ";
 
-    for (int i = 0; i < m_bits.size(); i++) {
+    for (int i = 0; i < MachineType_NUM; i++) {
         for (int j = 0; j < m_bits[i].getSize(); j++) {
             out << (bool) m_bits[i].isElement(j) << " ";
         }
@@ -271,8 +260,7 @@ NetDest::print(std::ostream& out) const
 bool
 NetDest::isEqual(const NetDest& n) const
 {
-    assert(m_bits.size() == n.m_bits.size());
-    for (unsigned int i = 0; i < m_bits.size(); ++i) {
+    for (unsigned int i = 0; i < MachineType_NUM; ++i) {
         if (!m_bits[i].isEqual(n.m_bits[i]))
             return false;
     }
@@ -89,7 +89,7 @@ class NetDest
     MachineID smallestElement(MachineType machine) const;
 
     void resize();
-    int getSize() const { return m_bits.size(); }
+    int getSize() const { return MachineType_NUM; }
 
     // get element for a index
     NodeID elementAt(MachineID index);
@@ -103,13 +103,15 @@ class NetDest
     vecIndex(MachineID m) const
     {
         int vec_index = MachineType_base_level(m.type);
-        assert(vec_index < m_bits.size());
+        assert(vec_index < MachineType_NUM);
         return vec_index;
     }
 
     NodeID bitIndex(NodeID index) const { return index; }
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    // one fixed-size bit vector per machine type, so copying a NetDest
+    // is a plain copy of the array
+    Set m_bits[MachineType_NUM];
 };
 
 inline std::ostream&
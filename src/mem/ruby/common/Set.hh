@@ -32,112 +32,180 @@
 #ifndef __MEM_RUBY_COMMON_SET_HH__
 #define __MEM_RUBY_COMMON_SET_HH__
 
+#include <cassert>
+#include <cstdint>
 #include <iostream>
-#include <limits>
 
 #include "mem/ruby/common/TypeDefines.hh"
 
 /*
- * This defines the number of longs (32-bits on 32 bit machines,
- * 64-bit on 64-bit AMD machines) to use to hold the set...
- * the default is 4, allowing 128 or 256 different members
- * of the set.
- *
- * This should never need to be changed for correctness reasons,
- * though increasing it will increase performance for larger
- * set sizes at the cost of a (much) larger memory footprint
- *
+ * The largest number of machines of one type a Set can hold. A Set
+ * keeps its bits in a fixed array of this size, so creating, copying
+ * and combining sets (and the NetDests built from them) never touches
+ * the heap, and every word-wise loop below has a constant trip count
+ * the compiler can unroll and vectorize.
  */
-const int NUMBER_WORDS_PER_SET = 1;
+const int MAX_MACHINES_PER_TYPE = 256;
 
-class Set
+template <int MaxBits>
+class BitSet
 {
   private:
-    int m_nSize;              // the number of bits in this set
-    int m_nArrayLen;          // the number of 32-bit words that are
-                              // held in the array
+    static const int WORD_BITS = 64;
+    static const int INDEX_SHIFT = 6;
+    static const int INDEX_MASK = WORD_BITS - 1;
+    static const int NUM_WORDS = (MaxBits + WORD_BITS - 1) / WORD_BITS;
 
-    // Changed 5/24/05 for static allocation of array
-    // note that "long" corresponds to 32 bits on a 32-bit machine,
-    // 64 bits if the -m64 parameter is passed to g++, which it is
-    // for an AMD opteron under our configuration
-
-    // an word array to hold the bits in the set
-    unsigned long *m_p_nArray;
-    unsigned long m_p_nArray_Static[NUMBER_WORDS_PER_SET];
+    int m_nSize;              // the number of bits in this set
 
-    static const int LONG_BITS =
-        std::numeric_limits<unsigned long>::digits + 1;
-    static const int INDEX_SHIFT = LONG_BITS == 64 ? 6 : 5;
-    static const int INDEX_MASK = (1 << INDEX_SHIFT) - 1;
+    // Bits at or above m_nSize are always zero, so the operations can
+    // run over all NUM_WORDS words regardless of the set size.
+    uint64_t m_words[NUM_WORDS];
 
-    void clearExcess();
+    int usedWords() const { return (m_nSize + INDEX_MASK) >> INDEX_SHIFT; }
 
   public:
-    Set();
-    Set(int size);
-    Set(const Set& obj);
-    ~Set();
-
-    Set& operator=(const Set& obj);
+    BitSet() : m_nSize(0) { clear(); }
+    explicit BitSet(int size) : m_nSize(0) { setSize(size); }
 
     void
     add(NodeID index)
     {
-        m_p_nArray[index >> INDEX_SHIFT] |=
-            (((unsigned long) 1) << (index & INDEX_MASK));
+        assert(index < (NodeID)m_nSize);
+        m_words[index >> INDEX_SHIFT] |= uint64_t(1) << (index & INDEX_MASK);
     }
 
-    void addSet(const Set& set);
+    void
+    addSet(const BitSet& set)
+    {
+        assert(m_nSize == set.m_nSize);
+        for (int i = 0; i < NUM_WORDS; i++)
+            m_words[i] |= set.m_words[i];
+    }
 
     void
     remove(NodeID index)
     {
-        m_p_nArray[index >> INDEX_SHIFT] &=
-            ~(((unsigned long)1) << (index & INDEX_MASK));
+        m_words[index >> INDEX_SHIFT] &=
+            ~(uint64_t(1) << (index & INDEX_MASK));
     }
 
-    void removeSet(const Set& set);
+    void
+    removeSet(const BitSet& set)
+    {
+        assert(m_nSize == set.m_nSize);
+        for (int i = 0; i < NUM_WORDS; i++)
+            m_words[i] &= ~set.m_words[i];
+    }
 
     void
     clear()
     {
-        for (int i = 0; i < m_nArrayLen; i++)
-            m_p_nArray[i] = 0;
+        for (int i = 0; i < NUM_WORDS; i++)
+            m_words[i] = 0;
     }
 
     void broadcast();
-    int count() const;
-    bool isEqual(const Set& set) const;
+
+    int
+    count() const
+    {
+        int counter = 0;
+        for (int i = 0; i < NUM_WORDS; i++)
+            counter += __builtin_popcountll(m_words[i]);
+        return counter;
+    }
+
+    bool
+    isEqual(const BitSet& set) const
+    {
+        assert(m_nSize == set.m_nSize);
+        uint64_t diff = 0;
+        for (int i = 0; i < NUM_WORDS; i++)
+            diff |= m_words[i] ^ set.m_words[i];
+        return diff == 0;
+    }
 
     // return the logical OR of this set and orSet
-    Set OR(const Set& orSet) const;
+    BitSet
+    OR(const BitSet& orSet) const
+    {
+        BitSet result(*this);
+        result.addSet(orSet);
+        return result;
+    }
 
     // return the logical AND of this set and andSet
-    Set AND(const Set& andSet) const;
+    BitSet
+    AND(const BitSet& andSet) const
+    {
+        assert(m_nSize == andSet.m_nSize);
+        BitSet result(*this);
+        for (int i = 0; i < NUM_WORDS; i++)
+            result.m_words[i] &= andSet.m_words[i];
+        return result;
+    }
 
     // Returns true if the intersection of the two sets is empty
     bool
-    intersectionIsEmpty(const Set& other_set) const
+    intersectionIsEmpty(const BitSet& other_set) const
+    {
+        uint64_t common = 0;
+        for (int i = 0; i < NUM_WORDS; i++)
+            common |= m_words[i] & other_set.m_words[i];
+        return common == 0;
+    }
+
+    // Returns false if a bit is set in test that is not set in this set
+    bool
+    isSuperset(const BitSet& test) const
     {
-        for (int i = 0; i < m_nArrayLen; i++)
-            if (m_p_nArray[i] & other_set.m_p_nArray[i])
-                return false;
-        return true;
+        assert(m_nSize == test.m_nSize);
+        uint64_t missing = 0;
+        for (int i = 0; i < NUM_WORDS; i++)
+            missing |= test.m_words[i] & ~m_words[i];
+        return missing == 0;
     }
 
-    bool isSuperset(const Set& test) const;
-    bool isSubset(const Set& test) const { return test.isSuperset(*this); }
+    bool
+    isSubset(const BitSet& test) const
+    {
+        return test.isSuperset(*this);
+    }
 
     bool
     isElement(NodeID element) const
     {
-        return (m_p_nArray[element>>INDEX_SHIFT] &
-            (((unsigned long)1) << (element & INDEX_MASK))) != 0;
+        return (m_words[element >> INDEX_SHIFT] &
+                (uint64_t(1) << (element & INDEX_MASK))) != 0;
     }
 
-    bool isBroadcast() const;
-    bool isEmpty() const;
+    // all bits below the size are set
+    bool isBroadcast() const { return count() == m_nSize; }
+
+    bool
+    isEmpty() const
+    {
+        uint64_t any = 0;
+        for (int i = 0; i < NUM_WORDS; i++)
+            any |= m_words[i];
+        return any == 0;
+    }
+
+    // Returns the first element at or after start, or getSize() if
+    // there is none, skipping a whole word of absent elements at a time.
+    NodeID
+    nextElement(NodeID start) const
+    {
+        for (int i = start >> INDEX_SHIFT; i < usedWords(); i++) {
+            uint64_t word = m_words[i];
+            if (i == (start >> INDEX_SHIFT))
+                word &= ~uint64_t(0) << (start & INDEX_MASK);
+            if (word)
+                return (i << INDEX_SHIFT) + __builtin_ctzll(word);
+        }
+        return m_nSize;
+    }
 
     NodeID smallestElement() const;
 
@@ -157,8 +225,11 @@ class Set
     void print(std::ostream& out) const;
 };
 
+typedef BitSet<MAX_MACHINES_PER_TYPE> Set;
+
+template <int MaxBits>
 inline std::ostream&
-operator<<(std::ostream& out, const Set& obj)
+operator<<(std::ostream& out, const BitSet<MaxBits>& obj)
 {
     obj.print(out);
     out << std::flush;
@@ -40,7 +40,9 @@ using namespace std;
 using m5::stl_helpers::operator<<;
 
 MessageBuffer::MessageBuffer(const string &name)
-    : m_time_last_time_size_checked(0), m_time_last_time_enqueue(0),
+    : m_wheel(wheelSize), m_slot_ticks(0), m_wheel_count(0),
+    m_head_slot(0), m_max_slot(0),
+    m_time_last_time_size_checked(0), m_time_last_time_enqueue(0),
     m_time_last_time_pop(0), m_last_arrival_time(0)
 {
     m_msg_counter = 0;
@@ -69,7 +71,7 @@ MessageBuffer::getSize()
 {
     if (m_time_last_time_size_checked != m_receiver->curCycle()) {
         m_time_last_time_size_checked = m_receiver->curCycle();
-        m_size_last_time_size_checked = m_prio_heap.size();
+        m_size_last_time_size_checked = numMessages();
     }
 
     return m_size_last_time_size_checked;
@@ -91,8 +93,8 @@ MessageBuffer::areNSlotsAvailable(unsigned int n)
     unsigned int current_size = 0;
 
     if (m_time_last_time_pop < m_sender->clockEdge()) {
-        // no pops this cycle - heap size is correct
-        current_size = m_prio_heap.size();
+        // no pops this cycle - buffer size is correct
+        current_size = numMessages();
     } else {
         if (m_time_last_time_enqueue < m_sender->curCycle()) {
             // no enqueues this cycle - m_size_at_cycle_start is correct
@@ -110,7 +112,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n)
     } else {
         DPRINTF(RubyQueue, "n: %d, current_size: %d, heap size: %d, "
                 "m_max_size: %d\n",
-                n, current_size, m_prio_heap.size(), m_max_size);
+                n, current_size, numMessages(), m_max_size);
         m_not_avail_count++;
         return false;
     }
@@ -122,13 +124,119 @@ MessageBuffer::peek() const
     DPRINTF(RubyQueue, "Peeking at head of queue.\n");
     assert(isReady());
 
-    const Message* msg_ptr = m_prio_heap.front().m_msgptr.get();
+    const Message* msg_ptr = head().m_msgptr.get();
     assert(msg_ptr);
 
     DPRINTF(RubyQueue, "Message: %s\n", (*msg_ptr));
     return msg_ptr;
 }
 
+void
+MessageBuffer::insert(const MessageBufferNode &node)
+{
+    if (m_slot_ticks == 0) {
+        ClockedObject *clocked = m_sender ? m_sender : m_receiver;
+        assert(clocked != NULL);
+        m_slot_ticks = clocked->clockPeriod();
+    }
+
+    uint64 slot = node.m_time / m_slot_ticks;
+    if (m_wheel_count == 0) {
+        m_head_slot = slot;
+        m_max_slot = slot;
+    } else if (slot >= m_head_slot ? slot - m_head_slot < wheelSize :
+               m_max_slot - slot < wheelSize) {
+        m_head_slot = std::min(m_head_slot, slot);
+        m_max_slot = std::max(m_max_slot, slot);
+    } else {
+        m_prio_heap.push_back(node);
+        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
+                  greater<MessageBufferNode>());
+        return;
+    }
+
+    // Nodes almost always arrive in order, so search from the back
+    vector<MessageBufferNode> &nodes = m_wheel[slot % wheelSize].nodes;
+    vector<MessageBufferNode>::iterator pos = nodes.end();
+    vector<MessageBufferNode>::iterator first =
+        nodes.begin() + m_wheel[slot % wheelSize].first;
+    while (pos != first && *(pos - 1) > node)
+        --pos;
+    nodes.insert(pos, node);
+    m_wheel_count++;
+}
+
+bool
+MessageBuffer::headInHeap() const
+{
+    if (m_prio_heap.empty())
+        return false;
+    if (m_wheel_count == 0)
+        return true;
+
+    const WheelBucket &bucket = m_wheel[m_head_slot % wheelSize];
+    return bucket.nodes[bucket.first] > m_prio_heap.front();
+}
+
+const MessageBufferNode &
+MessageBuffer::head() const
+{
+    assert(!isEmpty());
+    if (headInHeap())
+        return m_prio_heap.front();
+
+    const WheelBucket &bucket = m_wheel[m_head_slot % wheelSize];
+    return bucket.nodes[bucket.first];
+}
+
+MessageBufferNode
+MessageBuffer::popHead()
+{
+    assert(!isEmpty());
+    MessageBufferNode node;
+
+    if (headInHeap()) {
+        node = m_prio_heap.front();
+        pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
+                 greater<MessageBufferNode>());
+        m_prio_heap.pop_back();
+        return node;
+    }
+
+    WheelBucket &bucket = m_wheel[m_head_slot % wheelSize];
+    node = bucket.nodes[bucket.first];
+    // drop the buffer's reference now rather than when the bucket drains
+    bucket.nodes[bucket.first].m_msgptr.reset();
+    bucket.first++;
+    m_wheel_count--;
+
+    if (bucket.empty()) {
+        bucket.nodes.clear();
+        bucket.first = 0;
+        if (m_wheel_count > 0) {
+            do {
+                m_head_slot++;
+            } while (m_wheel[m_head_slot % wheelSize].empty());
+        }
+    }
+    return node;
+}
+
+template <class F>
+void
+MessageBuffer::forEachNode(F f) const
+{
+    if (m_wheel_count > 0) {
+        for (uint64 slot = m_head_slot; slot <= m_max_slot; ++slot) {
+            const WheelBucket &bucket = m_wheel[slot % wheelSize];
+            for (unsigned int i = bucket.first; i < bucket.nodes.size(); ++i)
+                f(bucket.nodes[i]);
+        }
+    }
+    for (unsigned int i = 0; i < m_prio_heap.size(); ++i)
+        f(m_prio_heap[i]);
+}
+
 // FIXME - move me somewhere else
 Cycles
 random_time()
@@ -205,11 +313,9 @@ MessageBuffer::enqueue(MsgPtr message, Cycles delta)
     msg_ptr->updateDelayedTicks(m_sender->clockEdge());
     msg_ptr->setLastEnqueueTime(arrival_time);
 
-    // Insert the message into the priority heap
+    // Insert the message into the timing wheel
     MessageBufferNode thisNode(arrival_time, m_msg_counter, message);
-    m_prio_heap.push_back(thisNode);
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-        greater<MessageBufferNode>());
+    insert(thisNode);
 
     DPRINTF(RubyQueue, "Enqueue arrival_time: %lld, Message: %s\n",
             arrival_time, *(message.get()));
@@ -227,7 +333,7 @@ MessageBuffer::dequeue()
     assert(isReady());
 
     // get MsgPtr of the message about to be dequeued
-    MsgPtr message = m_prio_heap.front().m_msgptr;
+    MsgPtr message = head().m_msgptr;
 
     // get the delay cycles
     message->updateDelayedTicks(m_receiver->clockEdge());
@@ -237,13 +343,11 @@ MessageBuffer::dequeue()
     // record previous size and time so the current buffer size isn't
     // adjusted until next cycle
     if (m_time_last_time_pop < m_receiver->clockEdge()) {
-        m_size_at_cycle_start = m_prio_heap.size();
+        m_size_at_cycle_start = numMessages();
         m_time_last_time_pop = m_receiver->clockEdge();
     }
 
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-        greater<MessageBufferNode>());
-    m_prio_heap.pop_back();
+    popHead();
 
     return delayCycles;
 }
@@ -251,6 +355,11 @@ MessageBuffer::dequeue()
 void
 MessageBuffer::clear()
 {
+    for (unsigned int i = 0; i < wheelSize; ++i) {
+        m_wheel[i].nodes.clear();
+        m_wheel[i].first = 0;
+    }
+    m_wheel_count = 0;
     m_prio_heap.clear();
 
     m_msg_counter = 0;
@@ -265,14 +374,10 @@ MessageBuffer::recycle()
 {
     DPRINTF(RubyQueue, "Recycling.\n");
     assert(isReady());
-    MessageBufferNode node = m_prio_heap.front();
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-        greater<MessageBufferNode>());
+    MessageBufferNode node = popHead();
 
     node.m_time = m_receiver->clockEdge(m_recycle_latency);
-    m_prio_heap.back() = node;
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-        greater<MessageBufferNode>());
+    insert(node);
     m_consumer->
         scheduleEventAbsolute(m_receiver->clockEdge(m_recycle_latency));
 }
@@ -283,10 +388,7 @@ MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick nextTick)
     while(!lt.empty()) {
         m_msg_counter++;
         MessageBufferNode msgNode(nextTick, m_msg_counter, lt.front());
-
-        m_prio_heap.push_back(msgNode);
-        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                  greater<MessageBufferNode>());
+        insert(msgNode);
 
         m_consumer->scheduleEventAbsolute(nextTick);
         lt.pop_front();
@@ -302,7 +404,7 @@ MessageBuffer::reanalyzeMessages(const Address& addr)
 
     //
     // Put all stalled messages associated with this address back on the
-    // prio heap
+    // timing wheel
     //
     reanalyzeList(m_stall_msg_map[addr], nextTick);
     m_stall_msg_map.erase(addr);
@@ -316,7 +418,7 @@ MessageBuffer::reanalyzeAllMessages()
 
     //
     // Put all stalled messages associated with this address back on the
-    // prio heap
+    // timing wheel
     //
     for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
          map_iter != m_stall_msg_map.end(); ++map_iter) {
@@ -331,7 +433,7 @@ MessageBuffer::stallMessage(const Address& addr)
     DPRINTF(RubyQueue, "Stalling due to %s\n", addr);
     assert(isReady());
     assert(addr.getOffset() == 0);
-    MsgPtr message = m_prio_heap.front().m_msgptr;
+    MsgPtr message = head().m_msgptr;
 
     dequeue();
 
@@ -351,27 +453,32 @@ MessageBuffer::print(ostream& out) const
         ccprintf(out, " consumer-yes ");
     }
 
-    vector<MessageBufferNode> copy(m_prio_heap);
-    sort_heap(copy.begin(), copy.end(), greater<MessageBufferNode>());
+    vector<MessageBufferNode> copy;
+    forEachNode([&copy](const MessageBufferNode &node) {
+        copy.push_back(node);
+    });
+    // latest message first
+    sort(copy.begin(), copy.end(), greater<MessageBufferNode>());
     ccprintf(out, "%s] %s", copy, m_name);
 }
 
 bool
 MessageBuffer::isReady() const
 {
-    return ((m_prio_heap.size() > 0) &&
-            (m_prio_heap.front().m_time <= m_receiver->clockEdge()));
+    return !isEmpty() && head().m_time <= m_receiver->clockEdge();
 }
 
 bool
 MessageBuffer::functionalRead(Packet *pkt)
 {
-    // Check the priority heap and read any messages that may
+    // Check the queued messages and read any messages that may
     // correspond to the address in the packet.
-    for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
-        Message *msg = m_prio_heap[i].m_msgptr.get();
-        if (msg->functionalRead(pkt)) return true;
-    }
+    bool read = false;
+    forEachNode([pkt, &read](const MessageBufferNode &node) {
+        if (!read)
+            read = node.m_msgptr->functionalRead(pkt);
+    });
+    if (read) return true;
 
     // Read the messages in the stall queue that correspond
     // to the address in the packet.
@@ -394,14 +501,13 @@ MessageBuffer::functionalWrite(Packet *pkt)
 {
     uint32_t num_functional_writes = 0;
 
-    // Check the priority heap and write any messages that may
+    // Check the queued messages and write any messages that may
     // correspond to the address in the packet.
-    for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
-        Message *msg = m_prio_heap[i].m_msgptr.get();
-        if (msg->functionalWrite(pkt)) {
+    forEachNode([pkt, &num_functional_writes](const MessageBufferNode &node) {
+        if (node.m_msgptr->functionalWrite(pkt)) {
             num_functional_writes++;
         }
-    }
+    });
 
     // Check the stall queue and write any messages that may
     // correspond to the address in the packet.
@@ -29,6 +29,11 @@
 /*
  * Unordered buffer of messages that can be inserted such
  * that they can be dequeued after a given delta time has expired.
+ *
+ * Messages are kept on a timing wheel with one bucket per sender cycle
+ * for the next wheelSize cycles; each bucket is ordered by arrival time
+ * and then enqueue order, which is FIFO in practice. Messages further
+ * out than the wheel reaches go to a heap.
  */
 
 #ifndef __MEM_RUBY_BUFFERS_MESSAGEBUFFER_HH__
@@ -67,10 +72,7 @@ class MessageBuffer
     void
     delayHead()
     {
-        MessageBufferNode node = m_prio_heap.front();
-        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                      std::greater<MessageBufferNode>());
-        m_prio_heap.pop_back();
+        MessageBufferNode node = popHead();
         enqueue(node.m_msgptr, Cycles(1));
     }
 
@@ -112,7 +114,7 @@ class MessageBuffer
     peekMsgPtr() const
     {
         assert(isReady());
-        return m_prio_heap.front().m_msgptr;
+        return head().m_msgptr;
     }
 
     void enqueue(MsgPtr message) { enqueue(message, Cycles(1)); }
@@ -123,7 +125,7 @@ class MessageBuffer
     Cycles dequeue();
 
     void recycle();
-    bool isEmpty() const { return m_prio_heap.size() == 0; }
+    bool isEmpty() const { return numMessages() == 0; }
 
     void
     setOrdering(bool order)
@@ -157,6 +159,30 @@ class MessageBuffer
   private:
     void reanalyzeList(std::list<MsgPtr> &, Tick);
 
+    unsigned int numMessages() const
+    { return m_wheel_count + m_prio_heap.size(); }
+
+    //! Inserts a node on the wheel or, if too far out, in the heap.
+    void insert(const MessageBufferNode &node);
+    //! Earliest node, the buffer must not be empty.
+    const MessageBufferNode &head() const;
+    MessageBufferNode popHead();
+    bool headInHeap() const;
+
+    //! All messages in the buffer, for debugging and functional accesses.
+    template <class F> void forEachNode(F f) const;
+
+    static const unsigned wheelSize = 256;
+
+    struct WheelBucket
+    {
+        std::vector<MessageBufferNode> nodes;
+        //! First node not yet popped
+        unsigned int first;
+        WheelBucket() : first(0) {}
+        bool empty() const { return first == nodes.size(); }
+    };
+
   private:
     //added by SS
     Cycles m_recycle_latency;
@@ -168,6 +194,18 @@ class MessageBuffer
 
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
+
+    //! Bucket i holds the messages of every slot s with s % wheelSize
+    //! == i; all slots on the wheel lie within wheelSize of each other,
+    //! so a bucket only ever holds one slot. A slot is a sender cycle.
+    std::vector<WheelBucket> m_wheel;
+    Tick m_slot_ticks;
+    unsigned int m_wheel_count;
+    uint64 m_head_slot;
+    //! Upper bound on the slots on the wheel
+    uint64 m_max_slot;
+
+    //! Messages that did not fit on the wheel
     std::vector<MessageBufferNode> m_prio_heap;
 
     // use a std::map for the stalled messages as this container is
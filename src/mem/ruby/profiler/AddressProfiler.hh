@@ -37,10 +37,9 @@
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/Global.hh"
 #include "mem/ruby/common/Histogram.hh"
+#include "mem/ruby/common/Set.hh"
 #include "mem/ruby/profiler/AccessTraceForAddress.hh"
 
-class Set;
-
 class AddressProfiler
 {
   public:
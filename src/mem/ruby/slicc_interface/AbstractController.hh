@@ -47,6 +47,7 @@
 #include "params/RubyController.hh"
 #include "mem/mem_object.hh"
 
+class CacheSnapshot;
 class Network;
 
 class AbstractController : public MemObject, public Consumer
@@ -75,6 +76,17 @@ class AbstractController : public MemObject, public Consumer
     virtual void regStats();
 
     virtual void recordCacheTrace(int cntrl, CacheRecorder* tr) = 0;
+
+    // Write the contents of the controller's caches and directory to a
+    // cache snapshot, or install them from one on checkpoint restore
+    virtual void snapshotCaches(CacheSnapshot& snap) const = 0;
+    virtual void restoreCaches(CacheSnapshot& snap) = 0;
+
+    // Whether the controller has TBEs allocated or messages queued, in
+    // which case its caches may hold transient state that a snapshot
+    // cannot record
+    virtual bool hasPendingState() const = 0;
+
     virtual Sequencer* getSequencer() const = 0;
 
     //! These functions are used by ruby system to read/write the data blocks
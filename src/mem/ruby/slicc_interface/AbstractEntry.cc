@@ -26,6 +26,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "base/misc.hh"
 #include "mem/ruby/slicc_interface/AbstractEntry.hh"
 
 AbstractEntry::AbstractEntry()
@@ -48,3 +49,15 @@ AbstractEntry::changePermission(AccessPermission new_perm)
 {
     m_Permission = new_perm;
 }
+
+void
+AbstractEntry::snapshotFields(CacheSnapshot& snap) const
+{
+    panic("snapshotFields() not implemented!");
+}
+
+void
+AbstractEntry::restoreFields(CacheSnapshot& snap)
+{
+    panic("restoreFields() not implemented!");
+}
@@ -33,6 +33,8 @@
 
 #include "mem/protocol/AccessPermission.hh"
 
+class CacheSnapshot;
+
 class AbstractEntry
 {
   public:
@@ -45,6 +47,11 @@ class AbstractEntry
 
     virtual void print(std::ostream& out) const = 0;
 
+    // Write or read back the protocol fields of the entry, generated by
+    // SLICC for the protocol's cache and directory entries
+    virtual void snapshotFields(CacheSnapshot& snap) const;
+    virtual void restoreFields(CacheSnapshot& snap);
+
     AccessPermission m_Permission; // Access permission for this
                                    // block, required by CacheMemory
 };
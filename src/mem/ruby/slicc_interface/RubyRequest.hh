@@ -50,11 +50,12 @@ class RubyRequest : public Message
     uint8_t* data;
     PacketPtr pkt;
     unsigned m_contextId;
+    ThreadID m_ThreadId;
 
     RubyRequest(Tick curTime, uint64_t _paddr, uint8_t* _data, int _len,
         uint64_t _pc, RubyRequestType _type, RubyAccessMode _access_mode,
         PacketPtr _pkt, PrefetchBit _pb = PrefetchBit_No,
-        unsigned _proc_id = 100)
+        unsigned _proc_id = 100, ThreadID _thread_id = InvalidThreadID)
         : Message(curTime),
           m_PhysicalAddress(_paddr),
           m_Type(_type),
@@ -64,13 +65,16 @@ class RubyRequest : public Message
           m_Prefetch(_pb),
           data(_data),
           pkt(_pkt),
-          m_contextId(_proc_id)
+          m_contextId(_proc_id),
+          m_ThreadId(_thread_id)
     {
       m_LineAddress = m_PhysicalAddress;
       m_LineAddress.makeLineAddress();
     }
 
-    RubyRequest(Tick curTime) : Message(curTime) {}
+    RubyRequest(Tick curTime)
+        : Message(curTime), m_ThreadId(InvalidThreadID)
+    {}
     MsgPtr clone() const
     { return std::shared_ptr<Message>(new RubyRequest(*this)); }
 
@@ -81,6 +85,7 @@ class RubyRequest : public Message
     const RubyAccessMode& getAccessMode() const { return m_AccessMode; }
     const int& getSize() const { return m_Size; }
     const PrefetchBit& getPrefetch() const { return m_Prefetch; }
+    const ThreadID& getThreadId() const { return m_ThreadId; }
 
     void print(std::ostream& out) const;
     bool functionalRead(Packet *pkt);
@@ -43,6 +43,9 @@ class AbstractReplacementPolicy
     /* returns the way to replace */
     virtual int64 getVictim(int64 set) const = 0;
 
+    /* returns the way to replace among the ways set in way_mask */
+    virtual int64 getVictim(int64 set, uint64 way_mask) const = 0;
+
     /* get the time of the last access */
     Tick getLastAccess(int64 set, int64 way);
 
@@ -46,3 +46,16 @@ class RubyCache(SimObject):
     dataAccessLatency = Param.Cycles(1, "cycles for a data array access")
     tagAccessLatency = Param.Cycles(1, "cycles for a tag array access")
     resourceStalls = Param.Bool(False, "stall if there is a resource failure")
+
+    way_partition = Param.Bool(False, "partition ways between the two "
+                               "SMT threads, rations set by the core")
+    cache_level = Param.Int(1, "cache level, selects the way ration "
+                            "config of the control panel")
+    thread_0_assoc = Param.Int(0, "initial ways for thread 0, "
+                               "0 for half of assoc")
+    shadow_tag_assoc = Param.Int(0, "assoc of the thread 0 shadow tags, "
+                                 "0 to disable")
+    core_id = Param.Int(-1, "core of a private cache, -1 if shared")
+    qos_core = Param.Int(0, "core whose QoS controller sets the rations; "
+                         "a shared cache gives thread 0 of this core "
+                         "the thread 0 ways and all others the rest")
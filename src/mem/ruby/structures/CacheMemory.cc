@@ -26,6 +26,8 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+
 #include "base/intmath.hh"
 #include "debug/RubyCache.hh"
 #include "debug/RubyCacheTrace.hh"
@@ -33,10 +35,14 @@
 #include "debug/RubyStats.hh"
 #include "mem/protocol/AccessPermission.hh"
 #include "mem/ruby/structures/CacheMemory.hh"
+#include "mem/ruby/system/CacheSnapshot.hh"
 #include "mem/ruby/system/System.hh"
 
 using namespace std;
 
+// Tag of an empty way; line addresses never have their low bits set
+static const Addr invalidTag = MaxAddr;
+
 ostream&
 operator<<(ostream& out, const CacheMemory& obj)
 {
@@ -63,6 +69,15 @@ CacheMemory::CacheMemory(const Params *p)
     m_start_index_bit = p->start_index_bit;
     m_is_instruction_only_cache = p->is_icache;
     m_resource_stalls = p->resourceStalls;
+    m_way_partition = p->way_partition;
+    m_cache_level = p->cache_level;
+    m_thread_0_assoc = p->thread_0_assoc;
+    m_shadow_tag_assoc = p->shadow_tag_assoc;
+    m_core_id = p->core_id;
+    m_qos_core = p->qos_core;
+    m_cur_thread = InvalidThreadID;
+    m_way_ration_config = NULL;
+    m_ration_version = 0;
 }
 
 void
@@ -83,24 +98,64 @@ CacheMemory::init()
     else
         assert(false);
 
-    m_cache.resize(m_cache_num_sets);
-    for (int i = 0; i < m_cache_num_sets; i++) {
-        m_cache[i].resize(m_cache_assoc);
-        for (int j = 0; j < m_cache_assoc; j++) {
-            m_cache[i][j] = NULL;
+    m_cache.assign(m_cache_num_sets * m_cache_assoc, NULL);
+    m_tags.assign(m_cache_num_sets * m_cache_assoc, invalidTag);
+
+    if (m_way_partition) {
+        if (m_cache_assoc < 2 || m_cache_assoc > 64)
+            fatal("%s: cannot partition %d ways between two threads\n",
+                  name(), m_cache_assoc);
+
+        int ration_first = m_thread_0_assoc ? m_thread_0_assoc :
+            m_cache_assoc / 2;
+        if (ration_first < 1 || ration_first >= m_cache_assoc)
+            fatal("%s: thread 0 assoc %d out of range\n", name(),
+                  ration_first);
+        m_way_ration[0] = ration_first;
+        m_way_ration[1] = m_cache_assoc - ration_first;
+
+        // The private caches of other cores keep their own rations
+        if (m_core_id < 0 || m_core_id == m_qos_core) {
+            if (m_cache_level == 2) {
+                m_way_ration_config = &controlPanel.l2CacheWayConfig;
+            } else if (m_cache_level == 1) {
+                if (m_is_instruction_only_cache) {
+                    m_way_ration_config = &controlPanel.l1ICacheWayConfig;
+                } else {
+                    m_way_ration_config = &controlPanel.l1DCacheWayConfig;
+                }
+            } else {
+                fatal("%s: unknown cache level %d\n", name(),
+                      m_cache_level);
+            }
+
+            // The controller starts from the configured rations unless
+            // it already set its own
+            m_way_ration_config->assoc = m_cache_assoc;
+            if (!m_way_ration_config->version) {
+                m_way_ration_config->threadWayRations[0] = m_way_ration[0];
+                m_way_ration_config->threadWayRations[1] = m_way_ration[1];
+            }
+            m_ration_version = m_way_ration_config->version;
         }
+
+        m_way_owner.assign(m_cache_num_sets * m_cache_assoc,
+                           InvalidThreadID);
+        m_way_count.resize(m_cache_num_sets);
+        for (int i = 0; i < m_cache_num_sets; i++)
+            m_way_count[i].fill(0);
     }
+
+    if (m_shadow_tag_assoc)
+        m_shadow_tags.resize(m_cache_num_sets);
 }
 
 CacheMemory::~CacheMemory()
 {
     if (m_replacementPolicy_ptr != NULL)
         delete m_replacementPolicy_ptr;
-    for (int i = 0; i < m_cache_num_sets; i++) {
-        for (int j = 0; j < m_cache_assoc; j++) {
-            delete m_cache[i][j];
-        }
-    }
+    for (int i = 0; i < m_cache.size(); i++)
+        delete m_cache[i];
 }
 
 // convert a Address to its location in the cache
@@ -112,18 +167,29 @@ CacheMemory::addressToCacheSet(const Address& address) const
                              m_start_index_bit + m_cache_num_set_bits - 1);
 }
 
+// Compares the tag against every way of the set without branching, so
+// the loop vectorizes on hosts with 64-bit vector compares (SSE4.1 and
+// later). A tag is held by at most one way.
+int
+CacheMemory::matchTag(int64 cacheSet, Addr tag) const
+{
+    const Addr *tags = &m_tags[wayIndex(cacheSet, 0)];
+    int way = -1;
+    for (int i = 0; i < m_cache_assoc; i++)
+        way = tags[i] == tag ? i : way;
+    return way;
+}
+
 // Given a cache index: returns the index of the tag in a set.
 // returns -1 if the tag is not found.
 int
 CacheMemory::findTagInSet(int64 cacheSet, const Address& tag) const
 {
     assert(tag == line_address(tag));
-    // search the set for the tags
-    m5::hash_map<Address, int>::const_iterator it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        if (m_cache[cacheSet][it->second]->m_Permission !=
-            AccessPermission_NotPresent)
-            return it->second;
+    int way = matchTag(cacheSet, tag.getAddress());
+    if (way != -1 && m_cache[wayIndex(cacheSet, way)]->m_Permission !=
+        AccessPermission_NotPresent)
+        return way;
     return -1; // Not found
 }
 
@@ -134,11 +200,121 @@ CacheMemory::findTagInSetIgnorePermissions(int64 cacheSet,
                                            const Address& tag) const
 {
     assert(tag == line_address(tag));
-    // search the set for the tags
-    m5::hash_map<Address, int>::const_iterator it = m_tag_index.find(tag);
-    if (it != m_tag_index.end())
-        return it->second;
-    return -1; // Not found
+    return matchTag(cacheSet, tag.getAddress());
+}
+
+bool
+CacheMemory::isEmptyWay(int64 cacheSet, int way) const
+{
+    AbstractCacheEntry* entry = m_cache[wayIndex(cacheSet, way)];
+    return entry == NULL ||
+        entry->m_Permission == AccessPermission_NotPresent;
+}
+
+void
+CacheMemory::setThread(int tid)
+{
+    checkRationUpdate();
+    m_cur_thread = tid < 0 ? InvalidThreadID : (tid == 0 ? 0 : 1);
+}
+
+void
+CacheMemory::setCoreThread(int core, int tid)
+{
+    checkRationUpdate();
+    if (tid < 0)
+        m_cur_thread = InvalidThreadID;
+    else
+        m_cur_thread = core == m_qos_core && tid == 0 ? 0 : 1;
+}
+
+void
+CacheMemory::checkRationUpdate()
+{
+    if (!m_way_ration_config ||
+        m_way_ration_config->version == m_ration_version)
+        return;
+
+    const int *rations = m_way_ration_config->threadWayRations;
+    if (rations[0] + rations[1] != m_cache_assoc) {
+        DPRINTF(RubyCache, "way ration[0]: %i, way ration[1]: %i\n",
+                rations[0], rations[1]);
+        panic("Associativity exceeds\n");
+    }
+
+    m_way_ration[0] = rations[0];
+    m_way_ration[1] = rations[1];
+    m_ration_version = m_way_ration_config->version;
+}
+
+// Below its ration a thread takes an empty way or one of the other
+// thread's; at its ration it has to replace one of its own.
+uint64
+CacheMemory::allocCandidates(int64 cacheSet) const
+{
+    uint64 all = m_cache_assoc == 64 ? ~0ULL : (1ULL << m_cache_assoc) - 1;
+    if (!m_way_partition || m_cur_thread < 0)
+        return all;
+
+    uint64 own = 0;
+    for (int i = 0; i < m_cache_assoc; i++) {
+        if (m_way_owner[wayIndex(cacheSet, i)] == m_cur_thread)
+            own |= 1ULL << i;
+    }
+
+    uint64 candidates =
+        m_way_count[cacheSet][m_cur_thread] < m_way_ration[m_cur_thread] ?
+        all & ~own : own;
+    return candidates ? candidates : all;
+}
+
+void
+CacheMemory::setWayOwner(int64 cacheSet, int way, ThreadID tid)
+{
+    ThreadID &owner = m_way_owner[wayIndex(cacheSet, way)];
+    if (owner != InvalidThreadID)
+        m_way_count[cacheSet][owner]--;
+    owner = tid;
+    if (owner != InvalidThreadID)
+        m_way_count[cacheSet][owner]++;
+    assert(m_way_count[cacheSet][0] >= 0 && m_way_count[cacheSet][1] >= 0);
+}
+
+void
+CacheMemory::touchShadowTag(int64 cacheSet, const Address& address)
+{
+    if (!m_shadow_tag_assoc || m_cur_thread != 0)
+        return;
+
+    std::vector<Address> &tags = m_shadow_tags[cacheSet];
+    std::vector<Address>::iterator it =
+        std::find(tags.begin(), tags.end(), address);
+    if (it != tags.end())
+        std::rotate(tags.begin(), it, it + 1);
+}
+
+void
+CacheMemory::allocateShadowTag(int64 cacheSet, const Address& address)
+{
+    if (!m_shadow_tag_assoc || m_cur_thread != 0)
+        return;
+
+    std::vector<Address> &tags = m_shadow_tags[cacheSet];
+    std::vector<Address>::iterator it =
+        std::find(tags.begin(), tags.end(), address);
+    if (it != tags.end()) {
+        // Thread 0 alone would still hold the line
+        DPRINTF(RubyCache, "Shadow tag hit for addr: %s\n", address);
+        m_shadow_hits++;
+        if (m_way_ration_config)
+            m_way_ration_config->recentShadowHits++;
+        std::rotate(tags.begin(), it, it + 1);
+        return;
+    }
+
+    if (tags.size() == m_shadow_tag_assoc)
+        tags.pop_back();
+    tags.insert(tags.begin(), address);
 }
 
 bool
@@ -151,8 +327,9 @@ CacheMemory::tryCacheAccess(const Address& address, RubyRequestType type,
     int loc = findTagInSet(cacheSet, address);
     if (loc != -1) {
         // Do we even have a tag match?
-        AbstractCacheEntry* entry = m_cache[cacheSet][loc];
+        AbstractCacheEntry* entry = m_cache[wayIndex(cacheSet, loc)];
         m_replacementPolicy_ptr->touch(cacheSet, loc, curTick());
+        touchShadowTag(cacheSet, address);
         data_ptr = &(entry->getDataBlk());
 
         if (entry->m_Permission == AccessPermission_Read_Write) {
@@ -179,11 +356,12 @@ CacheMemory::testCacheAccess(const Address& address, RubyRequestType type,
 
     if (loc != -1) {
         // Do we even have a tag match?
-        AbstractCacheEntry* entry = m_cache[cacheSet][loc];
+        AbstractCacheEntry* entry = m_cache[wayIndex(cacheSet, loc)];
         m_replacementPolicy_ptr->touch(cacheSet, loc, curTick());
+        touchShadowTag(cacheSet, address);
         data_ptr = &(entry->getDataBlk());
 
-        return m_cache[cacheSet][loc]->m_Permission !=
+        return m_cache[wayIndex(cacheSet, loc)]->m_Permission !=
             AccessPermission_NotPresent;
     }
 
@@ -217,16 +395,16 @@ CacheMemory::cacheAvail(const Address& address) const
     assert(address == line_address(address));
 
     int64 cacheSet = addressToCacheSet(address);
+    uint64 candidates = allocCandidates(cacheSet);
 
     for (int i = 0; i < m_cache_assoc; i++) {
-        AbstractCacheEntry* entry = m_cache[cacheSet][i];
-        if (entry != NULL) {
-            if (entry->m_Address == address ||
-                entry->m_Permission == AccessPermission_NotPresent) {
-                // Already in the cache or we found an empty entry
-                return true;
-            }
-        } else {
+        AbstractCacheEntry* entry = m_cache[wayIndex(cacheSet, i)];
+        if (entry != NULL && entry->m_Address == address) {
+            // Already in the cache
+            return true;
+        }
+        if (((candidates >> i) & 1) && isEmptyWay(cacheSet, i)) {
+            // We found an empty entry this thread may use
             return true;
         }
     }
@@ -243,18 +421,22 @@ CacheMemory::allocate(const Address& address, AbstractCacheEntry* entry)
 
     // Find the first open slot
     int64 cacheSet = addressToCacheSet(address);
-    std::vector<AbstractCacheEntry*> &set = m_cache[cacheSet];
+    uint64 candidates = allocCandidates(cacheSet);
+    AbstractCacheEntry **set = &m_cache[wayIndex(cacheSet, 0)];
     for (int i = 0; i < m_cache_assoc; i++) {
-        if (!set[i] || set[i]->m_Permission == AccessPermission_NotPresent) {
+        if (((candidates >> i) & 1) && isEmptyWay(cacheSet, i)) {
             set[i] = entry;  // Init entry
             set[i]->m_Address = address;
             set[i]->m_Permission = AccessPermission_Invalid;
             DPRINTF(RubyCache, "Allocate clearing lock for addr: %x\n",
                     address);
             set[i]->m_locked = -1;
-            m_tag_index[address] = i;
+            m_tags[wayIndex(cacheSet, i)] = address.getAddress();
 
             m_replacementPolicy_ptr->touch(cacheSet, i, curTick());
+            if (m_way_partition)
+                setWayOwner(cacheSet, i, m_cur_thread);
+            allocateShadowTag(cacheSet, address);
 
             return entry;
         }
@@ -271,9 +453,11 @@ CacheMemory::deallocate(const Address& address)
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     if (loc != -1) {
-        delete m_cache[cacheSet][loc];
-        m_cache[cacheSet][loc] = NULL;
-        m_tag_index.erase(address);
+        delete m_cache[wayIndex(cacheSet, loc)];
+        m_cache[wayIndex(cacheSet, loc)] = NULL;
+        m_tags[wayIndex(cacheSet, loc)] = invalidTag;
+        if (m_way_partition)
+            setWayOwner(cacheSet, loc, InvalidThreadID);
     }
 }
 
@@ -285,8 +469,11 @@ CacheMemory::cacheProbe(const Address& address) const
     assert(!cacheAvail(address));
 
     int64 cacheSet = addressToCacheSet(address);
-    return m_cache[cacheSet][m_replacementPolicy_ptr->getVictim(cacheSet)]->
-        m_Address;
+    int64 way = m_way_partition ?
+        m_replacementPolicy_ptr->getVictim(cacheSet,
+                                           allocCandidates(cacheSet)) :
+        m_replacementPolicy_ptr->getVictim(cacheSet);
+    return m_cache[wayIndex(cacheSet, way)]->m_Address;
 }
 
 // looks an address up in the cache
@@ -297,7 +484,7 @@ CacheMemory::lookup(const Address& address)
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     if(loc == -1) return NULL;
-    return m_cache[cacheSet][loc];
+    return m_cache[wayIndex(cacheSet, loc)];
 }
 
 // looks an address up in the cache
@@ -308,7 +495,7 @@ CacheMemory::lookup(const Address& address) const
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     if(loc == -1) return NULL;
-    return m_cache[cacheSet][loc];
+    return m_cache[wayIndex(cacheSet, loc)];
 }
 
 // Sets the most recently used bit for a cache block
@@ -318,8 +505,10 @@ CacheMemory::setMRU(const Address& address)
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
 
-    if(loc != -1)
+    if(loc != -1) {
         m_replacementPolicy_ptr->touch(cacheSet, loc, curTick());
+        touchShadowTag(cacheSet, address);
+    }
 }
 
 void
@@ -331,8 +520,9 @@ CacheMemory::recordCacheContents(int cntrl, CacheRecorder* tr) const
 
     for (int i = 0; i < m_cache_num_sets; i++) {
         for (int j = 0; j < m_cache_assoc; j++) {
-            if (m_cache[i][j] != NULL) {
-                AccessPermission perm = m_cache[i][j]->m_Permission;
+            AbstractCacheEntry *entry = m_cache[wayIndex(i, j)];
+            if (entry != NULL) {
+                AccessPermission perm = entry->m_Permission;
                 RubyRequestType request_type = RubyRequestType_NULL;
                 if (perm == AccessPermission_Read_Only) {
                     if (m_is_instruction_only_cache) {
@@ -345,10 +535,10 @@ CacheMemory::recordCacheContents(int cntrl, CacheRecorder* tr) const
                 }
 
                 if (request_type != RubyRequestType_NULL) {
-                    tr->addRecord(cntrl, m_cache[i][j]->m_Address.getAddress(),
+                    tr->addRecord(cntrl, entry->m_Address.getAddress(),
                                   0, request_type,
                                   m_replacementPolicy_ptr->getLastAccess(i, j),
-                                  m_cache[i][j]->getDataBlk());
+                                  entry->getDataBlk());
                     warmedUpBlocks++;
                 }
             }
@@ -361,16 +551,94 @@ CacheMemory::recordCacheContents(int cntrl, CacheRecorder* tr) const
             (float(warmedUpBlocks)/float(totalBlocks))*100.0);
 }
 
+void
+CacheMemory::snapshotContents(CacheSnapshot& snap) const
+{
+    // Oldest access first, so that installing the entries in order also
+    // rebuilds replacement state that only follows the order of touches
+    vector<pair<Tick, int64> > valid;
+    for (int64 i = 0; i < m_cache_num_sets; i++) {
+        for (int j = 0; j < m_cache_assoc; j++) {
+            if (m_cache[wayIndex(i, j)] != NULL) {
+                Tick last = m_replacementPolicy_ptr->getLastAccess(i, j);
+                valid.push_back(make_pair(last, wayIndex(i, j)));
+            }
+        }
+    }
+    sort(valid.begin(), valid.end());
+
+    snap.putUint(m_cache_num_sets);
+    snap.putUint(m_cache_assoc);
+    snap.putUint(valid.size());
+    for (int i = 0; i < valid.size(); i++) {
+        int64 idx = valid[i].second;
+        const AbstractCacheEntry *entry = m_cache[idx];
+        snap.putLineAddress(entry->m_Address);
+        snap.putUint(idx % m_cache_assoc);
+        snap.putUint(entry->m_Permission);
+        snap.putUint(valid[i].first);
+        snap.putInt(m_way_partition ? m_way_owner[idx] : InvalidThreadID);
+        entry->snapshotFields(snap);
+    }
+
+    DPRINTF(RubyCacheTrace, "%s: %d blocks in the snapshot\n", name(),
+            valid.size());
+}
+
+void
+CacheMemory::restoreContents(CacheSnapshot& snap, EntryFactory new_entry)
+{
+    uint64_t num_sets = snap.getUint();
+    uint64_t assoc = snap.getUint();
+    if (num_sets != m_cache_num_sets || assoc != m_cache_assoc) {
+        snap.mismatch(name(), csprintf("taken with %d sets of %d ways, "
+                                       "configured with %d sets of %d ways",
+                                       num_sets, assoc, m_cache_num_sets,
+                                       m_cache_assoc));
+    }
+
+    uint64_t count = snap.getUint();
+    for (uint64_t i = 0; i < count; i++) {
+        Address address = snap.getLineAddress();
+        int way = snap.getUint();
+        AccessPermission perm = (AccessPermission)snap.getUint();
+        Tick last = snap.getUint();
+        ThreadID owner = snap.getInt();
+
+        int64 cacheSet = addressToCacheSet(address);
+        if (way >= m_cache_assoc || m_cache[wayIndex(cacheSet, way)]) {
+            snap.mismatch(name(), csprintf("no room for %s in way %d",
+                                           address, way));
+        }
+
+        AbstractCacheEntry *entry = new_entry();
+        entry->restoreFields(snap);
+        entry->m_Address = address;
+        entry->m_Permission = perm;
+        entry->m_locked = -1;
+        m_cache[wayIndex(cacheSet, way)] = entry;
+        m_tags[wayIndex(cacheSet, way)] = address.getAddress();
+
+        m_replacementPolicy_ptr->touch(cacheSet, way, last);
+        if (m_way_partition)
+            setWayOwner(cacheSet, way, owner);
+    }
+
+    DPRINTF(RubyCacheTrace, "%s: installed %d blocks from the snapshot\n",
+            name(), count);
+}
+
 void
 CacheMemory::print(ostream& out) const
 {
     out << "Cache dump: " << name() << endl;
     for (int i = 0; i < m_cache_num_sets; i++) {
         for (int j = 0; j < m_cache_assoc; j++) {
-            if (m_cache[i][j] != NULL) {
+            const AbstractCacheEntry *entry = m_cache[wayIndex(i, j)];
+            if (entry != NULL) {
                 out << "  Index: " << i
                     << " way: " << j
-                    << " entry: " << *m_cache[i][j] << endl;
+                    << " entry: " << *entry << endl;
             } else {
                 out << "  Index: " << i
                     << " way: " << j
@@ -394,7 +662,7 @@ CacheMemory::setLocked(const Address& address, int context)
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     assert(loc != -1);
-    m_cache[cacheSet][loc]->m_locked = context;
+    m_cache[wayIndex(cacheSet, loc)]->m_locked = context;
 }
 
 void
@@ -405,7 +673,7 @@ CacheMemory::clearLocked(const Address& address)
     int64 cacheSet = addressToCacheSet(address);
     int loc = findTagInSet(cacheSet, address);
     assert(loc != -1);
-    m_cache[cacheSet][loc]->m_locked = -1;
+    m_cache[wayIndex(cacheSet, loc)]->m_locked = -1;
 }
 
 bool
@@ -416,8 +684,8 @@ CacheMemory::isLocked(const Address& address, int context)
     int loc = findTagInSet(cacheSet, address);
     assert(loc != -1);
     DPRINTF(RubyCache, "Testing Lock for addr: %llx cur %d con %d\n",
-            address, m_cache[cacheSet][loc]->m_locked, context);
-    return m_cache[cacheSet][loc]->m_locked == context;
+            address, m_cache[wayIndex(cacheSet, loc)]->m_locked, context);
+    return m_cache[wayIndex(cacheSet, loc)]->m_locked == context;
 }
 
 void
@@ -507,6 +775,12 @@ CacheMemory::regStats()
         .desc("number of stalls caused by data array")
         .flags(Stats::nozero)
         ;
+
+    m_shadow_hits
+        .name(name() + ".shadow_tag_hits")
+        .desc("number of thread 0 misses that hit in the shadow tags")
+        .flags(Stats::nozero)
+        ;
 }
 
 void
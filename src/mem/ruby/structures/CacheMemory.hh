@@ -29,11 +29,12 @@
 #ifndef __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 #define __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 
+#include <array>
 #include <string>
 #include <vector>
 
-#include "base/hashmap.hh"
 #include "base/statistics.hh"
+#include "mem/cache/tags/control_panel.hh"
 #include "mem/protocol/CacheRequestType.hh"
 #include "mem/protocol/CacheResourceType.hh"
 #include "mem/protocol/RubyRequest.hh"
@@ -47,10 +48,15 @@
 #include "params/RubyCache.hh"
 #include "sim/sim_object.hh"
 
+class CacheSnapshot;
+
 class CacheMemory : public SimObject
 {
   public:
     typedef RubyCacheParams Params;
+    // Creates an empty entry of the protocol's cache entry type
+    typedef AbstractCacheEntry *(*EntryFactory)();
+
     CacheMemory(const Params *p);
     ~CacheMemory();
 
@@ -95,9 +101,23 @@ class CacheMemory : public SimObject
     // Hook for checkpointing the contents of the cache
     void recordCacheContents(int cntrl, CacheRecorder* tr) const;
 
+    // Write the valid entries to a cache snapshot, or install the
+    // entries of one back in the ways they were taken from
+    void snapshotContents(CacheSnapshot& snap) const;
+    void restoreContents(CacheSnapshot& snap, EntryFactory new_entry);
+
     // Set this address to most recently used
     void setMRU(const Address& address);
 
+    // Thread the following accesses and allocations are made for. Set
+    // by the controller before it handles a request; with an invalid
+    // thread the ways are not partitioned and the shadow tags are left
+    // alone. A private cache takes the thread of its core, a shared one
+    // the requesting core and its thread.
+    void setThread(int tid);
+    void setCoreThread(int core, int tid);
+    void clearThread() { m_cur_thread = InvalidThreadID; }
+
     void setLocked (const Address& addr, int context);
     void clearLocked (const Address& addr);
     bool isLocked (const Address& addr, int context);
@@ -129,16 +149,40 @@ class CacheMemory : public SimObject
     Stats::Scalar numTagArrayStalls;
     Stats::Scalar numDataArrayStalls;
 
+    // Thread 0 misses that would have hit had it run alone
+    Stats::Scalar m_shadow_hits;
+
   private:
     // convert a Address to its location in the cache
     int64 addressToCacheSet(const Address& address) const;
 
+    int64 wayIndex(int64 cacheSet, int way) const
+    { return cacheSet * m_cache_assoc + way; }
+
+    // Way of the set holding this line address, or -1
+    int matchTag(int64 cacheSet, Addr tag) const;
+
     // Given a cache tag: returns the index of the tag in a set.
     // returns -1 if the tag is not found.
     int findTagInSet(int64 line, const Address& tag) const;
     int findTagInSetIgnorePermissions(int64 cacheSet,
                                       const Address& tag) const;
 
+    bool isEmptyWay(int64 cacheSet, int way) const;
+
+    // Take the rations the QoS controller last set, if it drives this
+    // cache
+    void checkRationUpdate();
+
+    // Ways the current thread may allocate into or evict from
+    uint64 allocCandidates(int64 cacheSet) const;
+    void setWayOwner(int64 cacheSet, int way, ThreadID tid);
+
+    // Thread 0 shadow tags: touched on hits, and checked and updated
+    // on allocation to detect misses caused by the other thread
+    void touchShadowTag(int64 cacheSet, const Address& address);
+    void allocateShadowTag(int64 cacheSet, const Address& address);
+
     // Private copy constructor and assignment operator
     CacheMemory(const CacheMemory& obj);
     CacheMemory& operator=(const CacheMemory& obj);
@@ -149,10 +193,12 @@ class CacheMemory : public SimObject
     // Data Members (m_prefix)
     bool m_is_instruction_only_cache;
 
-    // The first index is the # of cache lines.
-    // The second index is the the amount associativity.
-    m5::hash_map<Address, int> m_tag_index;
-    std::vector<std::vector<AbstractCacheEntry*> > m_cache;
+    // Entries and their line addresses, set after set, indexed by
+    // wayIndex(). The tags are kept apart from the entries so a lookup
+    // scans one contiguous run of addresses and only touches the entry
+    // it hits.
+    std::vector<AbstractCacheEntry*> m_cache;
+    std::vector<Addr> m_tags;
 
     AbstractReplacementPolicy *m_replacementPolicy_ptr;
 
@@ -166,6 +212,30 @@ class CacheMemory : public SimObject
     int m_cache_assoc;
     int m_start_index_bit;
     bool m_resource_stalls;
+
+    bool m_way_partition;
+    int m_cache_level;
+    int m_thread_0_assoc;
+    unsigned m_shadow_tag_assoc;
+    int m_core_id;
+    int m_qos_core;
+    // Way class of the current request: 0 for thread 0 of the QoS core
+    // (of the own core in a private cache), 1 for any other thread
+    ThreadID m_cur_thread;
+
+    // Ways of each class. The cache keeps its own rations and only
+    // follows the O3 QoS controller if it serves the QoS core; NULL
+    // otherwise.
+    int m_way_ration[2];
+    WayRationConfig *m_way_ration_config;
+    uint64 m_ration_version;
+
+    // Owner of each way and number of ways each class owns, per set
+    std::vector<ThreadID> m_way_owner;
+    std::vector<std::array<int, 2> > m_way_count;
+
+    // Per set, most recently used first
+    std::vector<std::vector<Address> > m_shadow_tags;
 };
 
 std::ostream& operator<<(std::ostream& out, const CacheMemory& obj);
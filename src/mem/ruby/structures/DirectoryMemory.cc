@@ -26,11 +26,15 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <cstring>
+
 #include "base/intmath.hh"
 #include "debug/RubyCache.hh"
+#include "debug/RubyCacheTrace.hh"
 #include "debug/RubyStats.hh"
 #include "mem/ruby/slicc_interface/RubySlicc_Util.hh"
 #include "mem/ruby/structures/DirectoryMemory.hh"
+#include "mem/ruby/system/CacheSnapshot.hh"
 #include "mem/ruby/system/System.hh"
 
 using namespace std;
@@ -142,6 +146,77 @@ DirectoryMemory::print(ostream& out) const
 {
 }
 
+void
+DirectoryMemory::snapshotContents(CacheSnapshot& snap,
+                                  EntryFactory new_entry) const
+{
+    // Entries are allocated on first use, so most of them only hold the
+    // state they were created with and are left out
+    AbstractEntry *fresh = new_entry();
+    CacheSnapshot fresh_fields;
+    fresh->snapshotFields(fresh_fields);
+    delete fresh;
+
+    snap.putUint(m_num_entries);
+
+    // Entries follow as the distance from the previous index plus one,
+    // a zero ends the list
+    uint64 prev = 0;
+    uint64 count = 0;
+    CacheSnapshot fields;
+    for (uint64 i = 0; i < m_num_entries; i++) {
+        if (m_entries[i] == NULL)
+            continue;
+
+        fields.clear();
+        m_entries[i]->snapshotFields(fields);
+        if (m_entries[i]->m_Permission == AccessPermission_Read_Only &&
+            fields.size() == fresh_fields.size() &&
+            !memcmp(fields.data(), fresh_fields.data(), fields.size())) {
+            continue;
+        }
+
+        snap.putUint(i - prev + 1);
+        snap.putUint(m_entries[i]->m_Permission);
+        m_entries[i]->snapshotFields(snap);
+        prev = i;
+        count++;
+    }
+    snap.putUint(0);
+
+    DPRINTF(RubyCacheTrace, "%s: %d entries in the snapshot\n", name(),
+            count);
+}
+
+void
+DirectoryMemory::restoreContents(CacheSnapshot& snap, EntryFactory new_entry)
+{
+    uint64_t num_entries = snap.getUint();
+    if (num_entries != m_num_entries) {
+        snap.mismatch(name(), csprintf("taken with %d entries, configured "
+                                       "with %d", num_entries,
+                                       m_num_entries));
+    }
+
+    uint64 idx = 0;
+    uint64 count = 0;
+    for (uint64_t step = snap.getUint(); step; step = snap.getUint()) {
+        idx += step - 1;
+        if (idx >= m_num_entries)
+            snap.mismatch(name(), "entry index out of range");
+
+        AbstractEntry *entry = new_entry();
+        entry->m_Permission = (AccessPermission)snap.getUint();
+        entry->restoreFields(snap);
+        delete m_entries[idx];
+        m_entries[idx] = entry;
+        count++;
+    }
+
+    DPRINTF(RubyCacheTrace, "%s: installed %d entries from the snapshot\n",
+            name(), count);
+}
+
 void
 DirectoryMemory::recordRequestType(DirectoryRequestType requestType) {
     DPRINTF(RubyStats, "Recorded statistic: %s\n",
@@ -38,10 +38,15 @@
 #include "params/RubyDirectoryMemory.hh"
 #include "sim/sim_object.hh"
 
+class CacheSnapshot;
+
 class DirectoryMemory : public SimObject
 {
   public:
     typedef RubyDirectoryMemoryParams Params;
+    // Creates an empty entry of the protocol's directory entry type
+    typedef AbstractEntry *(*EntryFactory)();
+
     DirectoryMemory(const Params *p);
     ~DirectoryMemory();
 
@@ -60,6 +65,11 @@ class DirectoryMemory : public SimObject
     void print(std::ostream& out) const;
     void recordRequestType(DirectoryRequestType requestType);
 
+    // Write the entries that differ from a newly allocated one to a
+    // cache snapshot, or install the entries of one
+    void snapshotContents(CacheSnapshot& snap, EntryFactory new_entry) const;
+    void restoreContents(CacheSnapshot& snap, EntryFactory new_entry);
+
   private:
     // Private copy constructor and assignment operator
     DirectoryMemory(const DirectoryMemory& obj);
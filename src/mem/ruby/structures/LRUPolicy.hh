@@ -41,6 +41,7 @@ class LRUPolicy : public AbstractReplacementPolicy
 
     void touch(int64 set, int64 way, Tick time);
     int64 getVictim(int64 set) const;
+    int64 getVictim(int64 set, uint64 way_mask) const;
 };
 
 inline
@@ -92,4 +93,25 @@ LRUPolicy::getVictim(int64 set) const
     return smallest_index;
 }
 
+inline int64
+LRUPolicy::getVictim(int64 set, uint64 way_mask) const
+{
+    assert(way_mask != 0);
+    Tick smallest_time = MaxTick;
+    int64 smallest_index = -1;
+
+    for (unsigned i = 0; i < m_assoc; i++) {
+        if (!((way_mask >> i) & 1))
+            continue;
+        if (smallest_index == -1 ||
+            m_last_ref_ptr[set][i] < smallest_time) {
+            smallest_index = i;
+            smallest_time = m_last_ref_ptr[set][i];
+        }
+    }
+
+    assert(smallest_index != -1);
+    return smallest_index;
+}
+
 #endif // __MEM_RUBY_STRUCTURES_LRUPOLICY_HH__
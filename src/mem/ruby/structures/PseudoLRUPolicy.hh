@@ -52,6 +52,7 @@ class PseudoLRUPolicy : public AbstractReplacementPolicy
 
     void touch(int64 set, int64 way, Tick time);
     int64 getVictim(int64 set) const;
+    int64 getVictim(int64 set, uint64 way_mask) const;
 
   private:
     unsigned int m_effective_assoc;    /** nearest (to ceiling) power of 2 */
@@ -134,4 +135,33 @@ PseudoLRUPolicy::getVictim(int64 set) const
     return (index > (m_assoc - 1)) ? m_assoc - 1 : index;
 }
 
+/**
+ * Same tree walk as above, but a subtree holding none of the ways in
+ * way_mask is never entered: the walk takes the sibling instead.
+ */
+inline int64
+PseudoLRUPolicy::getVictim(int64 set, uint64 way_mask) const
+{
+    assert(way_mask != 0);
+    int64 index = 0;
+
+    int tree_index = 0;
+    int node_val;
+    for (unsigned i = 0; i < m_num_levels; i++){
+        unsigned half = m_effective_assoc >> (i + 1);
+        uint64 right_mask = ((1ULL << half) - 1) << (index + half);
+        node_val = (m_trees[set] >> tree_index) & 1;
+        if (node_val && !(way_mask & (right_mask >> half)))
+            node_val = 0;
+        else if (!node_val && !(way_mask & right_mask))
+            node_val = 1;
+        index += node_val ? 0 : half;
+        tree_index = node_val ? (tree_index * 2) + 1 : (tree_index * 2) + 2;
+    }
+    assert(index >= 0 && index < m_assoc);
+    assert((way_mask >> index) & 1);
+
+    return index;
+}
+
 #endif // __MEM_RUBY_STRUCTURES_PSEUDOLRUPOLICY_HH__
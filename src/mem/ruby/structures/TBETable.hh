@@ -52,6 +52,8 @@ class TBETable
         return (m_number_of_TBEs - m_map.size()) >= n;
     }
 
+    bool isEmpty() const { return m_map.empty(); }
+
     ENTRY* lookup(const Address& address);
 
     // Print cache contents
@@ -0,0 +1,205 @@
+#include <cstring>
+
+#include "base/misc.hh"
+#include "mem/ruby/common/DataBlock.hh"
+#include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/system/CacheSnapshot.hh"
+#include "mem/ruby/system/System.hh"
+
+using namespace std;
+
+static const char snapshotMagic[8] = {
+    'r', 'u', 'b', 'y', 's', 'n', 'a', 'p'
+};
+static const uint64_t snapshotVersion = 1;
+
+CacheSnapshot::CacheSnapshot()
+    : m_pos(0)
+{
+}
+
+CacheSnapshot::CacheSnapshot(const uint8_t *data, uint64 size)
+    : m_data(data, data + size), m_pos(0)
+{
+}
+
+void
+CacheSnapshot::putHeader(uint32_t block_size_bytes, int num_controllers)
+{
+    m_data.insert(m_data.end(), snapshotMagic,
+                  snapshotMagic + sizeof(snapshotMagic));
+    putUint(snapshotVersion);
+    putUint(block_size_bytes);
+    putUint(num_controllers);
+}
+
+void
+CacheSnapshot::checkHeader(uint32_t block_size_bytes, int num_controllers)
+{
+    if (m_data.size() < sizeof(snapshotMagic) ||
+        memcmp(m_data.data(), snapshotMagic, sizeof(snapshotMagic))) {
+        mismatch("RubySystem", "not a cache snapshot");
+    }
+    m_pos = sizeof(snapshotMagic);
+
+    uint64_t version = getUint();
+    if (version != snapshotVersion)
+        mismatch("RubySystem", csprintf("unsupported version %d", version));
+
+    uint64_t block_size = getUint();
+    if (block_size != block_size_bytes) {
+        mismatch("RubySystem", csprintf("block size %d, running with %d",
+                                        block_size, block_size_bytes));
+    }
+
+    uint64_t controllers = getUint();
+    if (controllers != num_controllers) {
+        mismatch("RubySystem", csprintf("%d controllers, running with %d",
+                                        controllers, num_controllers));
+    }
+}
+
+void
+CacheSnapshot::putUint(uint64_t value)
+{
+    while (value >= 0x80) {
+        m_data.push_back(uint8_t(value) | 0x80);
+        value >>= 7;
+    }
+    m_data.push_back(uint8_t(value));
+}
+
+void
+CacheSnapshot::putInt(int64_t value)
+{
+    putUint((uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+uint64_t
+CacheSnapshot::getUint()
+{
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (m_pos >= m_data.size())
+            mismatch("RubySystem", "truncated snapshot");
+        uint8_t byte = m_data[m_pos++];
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    mismatch("RubySystem", "malformed integer");
+    return 0;
+}
+
+int64_t
+CacheSnapshot::getInt()
+{
+    uint64_t zigzag = getUint();
+    return int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1);
+}
+
+void
+CacheSnapshot::putLineAddress(const Address& addr)
+{
+    putUint(addr.getAddress() >> RubySystem::getBlockSizeBits());
+}
+
+Address
+CacheSnapshot::getLineAddress()
+{
+    return Address(getUint() << RubySystem::getBlockSizeBits());
+}
+
+void
+CacheSnapshot::put(const MachineID& mach)
+{
+    putUint(mach.type);
+    putUint(mach.num);
+}
+
+void
+CacheSnapshot::get(MachineID& mach)
+{
+    mach.type = static_cast<MachineType>(getUint());
+    mach.num = getUint();
+    if (mach.type >= MachineType_NUM ||
+        mach.num >= MachineType_base_count(mach.type)) {
+        mismatch("RubySystem", "machine out of range");
+    }
+}
+
+// Sets are stored as their size and the list of members, sharer lists
+// being mostly empty or short.
+void
+CacheSnapshot::put(const Set& set)
+{
+    putUint(set.getSize());
+    putUint(set.count());
+    for (NodeID i = set.nextElement(0); i < set.getSize();
+         i = set.nextElement(i + 1)) {
+        putUint(i);
+    }
+}
+
+void
+CacheSnapshot::get(Set& set)
+{
+    set.setSize(getUint());
+    uint64_t count = getUint();
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t element = getUint();
+        if (element >= set.getSize())
+            mismatch("RubySystem", "set element out of range");
+        set.add(element);
+    }
+}
+
+void
+CacheSnapshot::put(const NetDest& dest)
+{
+    NetDest left = dest;
+    putUint(left.count());
+    while (!left.isEmpty()) {
+        MachineID mach = left.smallestElement();
+        put(mach);
+        left.remove(mach);
+    }
+}
+
+void
+CacheSnapshot::get(NetDest& dest)
+{
+    dest.clear();
+    uint64_t count = getUint();
+    for (uint64_t i = 0; i < count; i++) {
+        MachineID mach;
+        get(mach);
+        dest.add(mach);
+    }
+}
+
+void
+CacheSnapshot::put(const DataBlock& data)
+{
+    uint32_t size = RubySystem::getBlockSizeBytes();
+    const uint8_t *bytes = data.getData(0, size);
+    m_data.insert(m_data.end(), bytes, bytes + size);
+}
+
+void
+CacheSnapshot::get(DataBlock& data)
+{
+    uint32_t size = RubySystem::getBlockSizeBytes();
+    if (m_pos + size > m_data.size())
+        mismatch("RubySystem", "truncated snapshot");
+    data.setData(&m_data[m_pos], 0, size);
+    m_pos += size;
+}
+
+void
+CacheSnapshot::mismatch(const string& who, const string& what) const
+{
+    fatal("%s: cannot restore the cache snapshot: %s. Set "
+          "RubySystem.direct_warmup to False to warm the caches from the "
+          "cache trace instead.\n", who, what);
+}
@@ -0,0 +1,91 @@
+/*
+ * A compact binary image of the Ruby cache and directory contents,
+ * written when a checkpoint is taken. On restore the entries are
+ * installed straight into each CacheMemory and DirectoryMemory, so
+ * the caches are warm at startup without replaying the cache trace
+ * through the sequencers.
+ *
+ * Integers are stored as LEB128 varints, zigzag coded when signed,
+ * and line addresses are stored without their block offset bits.
+ * The whole image is gzipped like the cache trace.
+ */
+
+#ifndef __MEM_RUBY_SYSTEM_CACHESNAPSHOT_HH__
+#define __MEM_RUBY_SYSTEM_CACHESNAPSHOT_HH__
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/ruby/common/Address.hh"
+#include "mem/ruby/common/MachineID.hh"
+#include "mem/ruby/common/Set.hh"
+
+class DataBlock;
+class NetDest;
+
+class CacheSnapshot
+{
+  public:
+    // An empty snapshot to write to
+    CacheSnapshot();
+    // A snapshot to read back, copied from size bytes at data
+    CacheSnapshot(const uint8_t *data, uint64 size);
+
+    const uint8_t *data() const { return m_data.data(); }
+    uint64 size() const { return m_data.size(); }
+    bool atEnd() const { return m_pos == m_data.size(); }
+    void clear() { m_data.clear(); m_pos = 0; }
+
+    // File header: format version, block size and controller count
+    void putHeader(uint32_t block_size_bytes, int num_controllers);
+    void checkHeader(uint32_t block_size_bytes, int num_controllers);
+
+    void putUint(uint64_t value);
+    void putInt(int64_t value);
+    uint64_t getUint();
+    int64_t getInt();
+
+    // Block aligned addresses, stored as line numbers
+    void putLineAddress(const Address& addr);
+    Address getLineAddress();
+
+    void put(bool value) { putUint(value); }
+    void put(int value) { putInt(value); }
+    void put(const MachineID& mach);
+    void put(const Set& set);
+    void put(const NetDest& dest);
+    void put(const DataBlock& data);
+
+    template <typename E>
+    typename std::enable_if<std::is_enum<E>::value>::type
+    put(E value)
+    {
+        putInt(value);
+    }
+
+    void get(bool& value) { value = getUint() != 0; }
+    void get(int& value) { value = getInt(); }
+    void get(MachineID& mach);
+    void get(Set& set);
+    void get(NetDest& dest);
+    void get(DataBlock& data);
+
+    template <typename E>
+    typename std::enable_if<std::is_enum<E>::value>::type
+    get(E& value)
+    {
+        value = static_cast<E>(getInt());
+    }
+
+    // Reports a snapshot that does not match the configuration being
+    // restored, naming the object that found the mismatch
+    void mismatch(const std::string& who, const std::string& what) const;
+
+  private:
+    std::vector<uint8_t> m_data;
+    uint64 m_pos;
+};
+
+#endif // __MEM_RUBY_SYSTEM_CACHESNAPSHOT_HH__
@@ -50,3 +50,6 @@ class RubySystem(ClockedObject):
 
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
+
+    direct_warmup = Param.Bool(True, "Restore the caches from the cache \
+        snapshot in a checkpoint, instead of replaying its cache trace")
@@ -505,10 +505,16 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
     Cycles issued_time = srequest->issue_time;
 
     // Set this cache entry to the most recently used
+    ThreadID tid = pkt->req->hasThreadId() ? pkt->req->threadId() :
+        InvalidThreadID;
     if (type == RubyRequestType_IFETCH) {
+        m_instCache_ptr->setThread(tid);
         m_instCache_ptr->setMRU(request_line_address);
+        m_instCache_ptr->clearThread();
     } else {
+        m_dataCache_ptr->setThread(tid);
         m_dataCache_ptr->setMRU(request_line_address);
+        m_dataCache_ptr->clearThread();
     }
 
     assert(curCycle() >= issued_time);
@@ -666,9 +672,13 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
 {
     assert(pkt != NULL);
     int proc_id = -1;
+    ThreadID thread_id = InvalidThreadID;
     if (pkt->req->hasContextId()) {
         proc_id = pkt->req->contextId();
     }
+    if (pkt->req->hasThreadId()) {
+        thread_id = pkt->req->threadId();
+    }
 
     // If valid, copy the pc to the ruby request
     Addr pc = 0;
@@ -684,7 +694,7 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
                                       nullptr : pkt->getPtr<uint8_t>(),
                                       pkt->getSize(), pc, secondary_type,
                                       RubyAccessMode_Supervisor, pkt,
-                                      PrefetchBit_No, proc_id);
+                                      PrefetchBit_No, proc_id, thread_id);
 
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %s %s\n",
             curTick(), m_version, "Seq", "Begin", "", "",
@@ -30,6 +30,7 @@
 #include <zlib.h>
 
 #include <cstdio>
+#include <cstring>
 
 #include "base/intmath.hh"
 #include "base/statistics.hh"
@@ -37,6 +38,7 @@
 #include "debug/RubySystem.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/network/Network.hh"
+#include "mem/ruby/system/CacheSnapshot.hh"
 #include "mem/ruby/system/System.hh"
 #include "mem/simple_mem.hh"
 #include "sim/eventq.hh"
@@ -56,7 +58,9 @@ unsigned RubySystem::m_systems_to_warmup = 0;
 bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params *p)
-    : ClockedObject(p), m_access_backing_store(p->access_backing_store)
+    : ClockedObject(p), m_access_backing_store(p->access_backing_store),
+      m_direct_warmup(p->direct_warmup), m_cache_snapshot(NULL),
+      m_cache_recorder(NULL)
 {
     if (g_system_ptr != NULL)
         fatal("Only one RubySystem object currently allowed.\n");
@@ -171,6 +175,30 @@ RubySystem::serialize(std::ostream &os)
     }
 
     DPRINTF(RubyCacheTrace, "Cache Trace Complete\n");
+
+    // Taken before the flush below changes the cache contents. The
+    // snapshot records protocol state as is, so it is only written when
+    // no request is in flight; the restore replays the trace otherwise.
+    int busy_cntrl = -1;
+    for (int cntrl = 0; cntrl < m_abs_cntrl_vec.size(); cntrl++) {
+        if (m_abs_cntrl_vec[cntrl]->hasPendingState()) {
+            busy_cntrl = cntrl;
+            break;
+        }
+    }
+
+    if (busy_cntrl < 0) {
+        string cache_snapshot_file = name() + ".snapshot.gz";
+        uint64 cache_snapshot_size;
+        writeCacheSnapshot(cache_snapshot_file, cache_snapshot_size);
+        SERIALIZE_SCALAR(cache_snapshot_file);
+        SERIALIZE_SCALAR(cache_snapshot_size);
+    } else {
+        warn("%s has requests in flight, no cache snapshot taken; the "
+             "checkpoint restores the caches from the trace\n",
+             m_abs_cntrl_vec[busy_cntrl]->name());
+    }
+
     // save the current tick value
     Tick curtick_original = curTick();
     // save the event queue head
@@ -202,6 +230,47 @@ RubySystem::serialize(std::ostream &os)
     m_cooldown_enabled = false;
 }
 
+void
+RubySystem::writeCacheSnapshot(string file, uint64& size)
+{
+    CacheSnapshot snapshot;
+    snapshot.putHeader(getBlockSizeBytes(), m_abs_cntrl_vec.size());
+    for (int cntrl = 0; cntrl < m_abs_cntrl_vec.size(); cntrl++) {
+        snapshot.put(m_abs_cntrl_vec[cntrl]->getMachineID());
+        m_abs_cntrl_vec[cntrl]->snapshotCaches(snapshot);
+    }
+
+    size = snapshot.size();
+    DPRINTF(RubyCacheTrace, "Cache snapshot of %d bytes\n", size);
+
+    uint8_t *raw_data = new uint8_t[size];
+    memcpy(raw_data, snapshot.data(), size);
+    writeCompressedTrace(raw_data, file, size);
+}
+
+void
+RubySystem::restoreCacheSnapshot()
+{
+    m_cache_snapshot->checkHeader(getBlockSizeBytes(),
+                                  m_abs_cntrl_vec.size());
+    for (int cntrl = 0; cntrl < m_abs_cntrl_vec.size(); cntrl++) {
+        MachineID id = m_abs_cntrl_vec[cntrl]->getMachineID();
+        MachineID recorded;
+        m_cache_snapshot->get(recorded);
+        if (!(recorded == id)) {
+            m_cache_snapshot->mismatch(name(), csprintf(
+                "controller %d is %s, recorded as %s", cntrl,
+                MachineIDToString(id), MachineIDToString(recorded)));
+        }
+        m_abs_cntrl_vec[cntrl]->restoreCaches(*m_cache_snapshot);
+    }
+
+    if (!m_cache_snapshot->atEnd())
+        m_cache_snapshot->mismatch(name(), "trailing data");
+
+    DPRINTF(RubyCacheTrace, "Cache snapshot installed\n");
+}
+
 void
 RubySystem::readCompressedTrace(string filename, uint8_t *&raw_data,
                                 uint64& uncompressed_trace_size)
@@ -251,6 +320,21 @@ RubySystem::unserialize(Checkpoint *cp, const string &section)
     UNSERIALIZE_SCALAR(cache_trace_size);
     cache_trace_file = cp->cptDir + "/" + cache_trace_file;
 
+    // Checkpoints that have a cache snapshot taken with the same block
+    // size have their caches installed directly in startup()
+    string cache_snapshot_file;
+    uint64 cache_snapshot_size = 0;
+    if (m_direct_warmup && block_size_bytes == getBlockSizeBytes() &&
+        UNSERIALIZE_OPT_SCALAR(cache_snapshot_file) &&
+        UNSERIALIZE_OPT_SCALAR(cache_snapshot_size)) {
+        uint8_t *raw_data = NULL;
+        readCompressedTrace(cp->cptDir + "/" + cache_snapshot_file, raw_data,
+                            cache_snapshot_size);
+        m_cache_snapshot = new CacheSnapshot(raw_data, cache_snapshot_size);
+        delete [] raw_data;
+        return;
+    }
+
     readCompressedTrace(cache_trace_file, uncompressed_trace,
                         cache_trace_size);
     m_warmup_enabled = true;
@@ -294,8 +378,16 @@ RubySystem::startup()
     // simulation starts. And then one also needs to hope that the time
     // Ruby finishes restoring the state is less than the time when the
     // state was checkpointed.
-
-    if (m_warmup_enabled) {
+    //
+    // Checkpoints with a cache snapshot avoid all of this: the cache and
+    // directory entries are installed as they were recorded, without
+    // simulating any requests.
+
+    if (m_cache_snapshot) {
+        restoreCacheSnapshot();
+        delete m_cache_snapshot;
+        m_cache_snapshot = NULL;
+    } else if (m_warmup_enabled) {
         // save the current tick value
         Tick curtick_original = curTick();
         // save the event queue head
@@ -44,6 +44,7 @@
 #include "params/RubySystem.hh"
 #include "sim/clocked_object.hh"
 
+class CacheSnapshot;
 class Network;
 
 class RubySystem : public ClockedObject
@@ -120,6 +121,10 @@ class RubySystem : public ClockedObject
     void writeCompressedTrace(uint8_t *raw_data, std::string file,
                               uint64 uncompressed_trace_size);
 
+    // Snapshot of the cache and directory entries of all controllers
+    void writeCacheSnapshot(std::string file, uint64& size);
+    void restoreCacheSnapshot();
+
   private:
     // configuration parameters
     static int m_random_seed;
@@ -132,6 +137,9 @@ class RubySystem : public ClockedObject
     static bool m_cooldown_enabled;
     SimpleMemory *m_phys_mem;
     const bool m_access_backing_store;
+    const bool m_direct_warmup;
+    // Read on restore, and installed in startup()
+    CacheSnapshot* m_cache_snapshot;
 
     Network* m_network;
     std::vector<AbstractController *> m_abs_cntrl_vec;
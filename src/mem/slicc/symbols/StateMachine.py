@@ -86,6 +86,7 @@ class StateMachine(Symbol):
         self.objects = []
         self.TBEType   = None
         self.EntryType = None
+        self.DirectoryEntryType = None
 
     def __repr__(self):
         return "[StateMachine: %s]" % self.ident
@@ -149,6 +150,12 @@ class StateMachine(Symbol):
                            "single machine.");
             self.EntryType = type
 
+        elif "interface" in type and "AbstractEntry" == type["interface"]:
+            if self.DirectoryEntryType != None:
+                self.error("Multiple AbstractEntry types in a " \
+                           "single machine.");
+            self.DirectoryEntryType = type
+
     # Needs to be called before accessing the table
     def buildTable(self):
         assert self.table is None
@@ -283,6 +290,9 @@ class $c_ident : public AbstractController
     void collateStats();
 
     void recordCacheTrace(int cntrl, CacheRecorder* tr);
+    void snapshotCaches(CacheSnapshot& snap) const;
+    void restoreCaches(CacheSnapshot& snap);
+    bool hasPendingState() const;
     Sequencer* getSequencer() const;
 
     int functionalWriteBuffers(PacketPtr&);
@@ -921,6 +931,94 @@ $c_ident::recordCacheTrace(int cntrl, CacheRecorder* tr)
         code.dedent()
         code('''
 }
+''')
+
+        #
+        # Cache snapshot of all associated caches and directories. Their
+        # entries are created with the machine's entry types on restore.
+        #
+        caches = [ p.ident for p in self.config_parameters
+                   if p.type_ast.type.ident == "CacheMemory" ]
+        dirs = [ p.ident for p in self.config_parameters
+                 if p.type_ast.type.ident == "DirectoryMemory" ]
+
+        if caches:
+            if self.EntryType == None:
+                self.error("No AbstractCacheEntry type to restore %s from "
+                           "a cache snapshot", caches[0])
+            code('''
+
+static AbstractCacheEntry *
+newCacheEntry()
+{
+    return new ${{self.EntryType.c_ident}};
+}
+''')
+        if dirs:
+            if self.DirectoryEntryType == None:
+                self.error("No AbstractEntry type to restore %s from "
+                           "a cache snapshot", dirs[0])
+            code('''
+
+static AbstractEntry *
+newDirectoryEntry()
+{
+    return new ${{self.DirectoryEntryType.c_ident}};
+}
+''')
+
+        code('''
+
+void
+$c_ident::snapshotCaches(CacheSnapshot& snap) const
+{
+''')
+        code.indent()
+        for cache in caches:
+            code('m_${cache}_ptr->snapshotContents(snap);')
+        for directory in dirs:
+            code('m_${directory}_ptr->snapshotContents(snap, '
+                 'newDirectoryEntry);')
+        code.dedent()
+        code('''
+}
+
+void
+$c_ident::restoreCaches(CacheSnapshot& snap)
+{
+''')
+        code.indent()
+        for cache in caches:
+            code('m_${cache}_ptr->restoreContents(snap, newCacheEntry);')
+        for directory in dirs:
+            code('m_${directory}_ptr->restoreContents(snap, '
+                 'newDirectoryEntry);')
+        code.dedent()
+        code('''
+}
+
+bool
+$c_ident::hasPendingState() const
+{
+    if (!m_waiting_buffers.empty() || !m_responseFromMemory_ptr->isEmpty())
+        return true;
+''')
+        code.indent()
+        for var in self.objects:
+            if var.type.ident == "TBETable":
+                code('if (!m_${{var.ident}}_ptr->isEmpty())')
+                code('    return true;')
+        buffers = [ var.ident for var in self.objects if var.type.isBuffer ]
+        buffers += [ var.ident for var in self.config_parameters
+                     if var.type_ast.type.isBuffer ]
+        for buf in buffers:
+            code('if (m_${buf}_ptr && !m_${buf}_ptr->isEmpty())')
+            code('    return true;')
+        code('return false;')
+        code.dedent()
+        code('}')
+
+        code('''
 
 // Actions
 ''')
@@ -116,6 +116,10 @@ class Type(Symbol):
     def isEnumeration(self):
         return "enumeration" in self
     @property
+    def isSnapshotEntry(self):
+        return "interface" in self and \
+               self["interface"] in ("AbstractEntry", "AbstractCacheEntry")
+    @property
     def isExternal(self):
         return "external" in self
     @property
@@ -342,6 +346,9 @@ set${{dm.ident}}(const ${{dm.type.c_ident}}& local_${{dm.ident}})
 ''')
 
         code('void print(std::ostream& out) const;')
+        if self.isSnapshotEntry:
+            code('void snapshotFields(CacheSnapshot& snap) const;')
+            code('void restoreFields(CacheSnapshot& snap);')
         code.dedent()
         code('  //private:')
         code.indent()
@@ -404,6 +411,12 @@ operator<<(std::ostream& out, const ${{self.c_ident}}& obj)
 
 #include "mem/protocol/${{self.c_ident}}.hh"
 #include "mem/ruby/common/Global.hh"
+''')
+
+        if self.isSnapshotEntry:
+            code('#include "mem/ruby/system/CacheSnapshot.hh"')
+
+        code('''
 #include "mem/ruby/system/System.hh"
 
 using namespace std;
@@ -431,6 +444,30 @@ ${{self.c_ident}}::print(ostream& out) const
     out << "]";
 }''')
 
+        # Cache snapshot of the fields stored in the entry
+        if self.isSnapshotEntry:
+            fields = [ dm for dm in self.data_members.values()
+                       if "abstract" not in dm ]
+            code('''
+
+void
+${{self.c_ident}}::snapshotFields(CacheSnapshot& snap) const
+{''')
+            code.indent()
+            for dm in fields:
+                code('snap.put(m_${{dm.ident}});')
+            code.dedent()
+            code('''}
+
+void
+${{self.c_ident}}::restoreFields(CacheSnapshot& snap)
+{''')
+            code.indent()
+            for dm in fields:
+                code('snap.get(m_${{dm.ident}});')
+            code.dedent()
+            code('}')
+
         # print the code for the methods in the type
         for item in self.methods:
             code(self.methods[item].generateCode())
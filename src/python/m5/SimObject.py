@@ -1431,7 +1431,8 @@ class SimObject(object):
             self._ccObject = -1
             if not self.abstract:
                 params = self.getCCParams()
-                self._ccObject = params.create()
+                self._ccObject = m5.memreport.call('create', self,
+                                                   params.create)
         elif self._ccObject == -1:
             raise RuntimeError, "%s: Cycle found in configuration hierarchy." \
                   % self.path()
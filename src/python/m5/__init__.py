@@ -43,6 +43,7 @@ except ImportError:
 if internal:
     import SimObject
     import core
+    import memreport
     import objects
     import params
     import stats
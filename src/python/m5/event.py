@@ -66,4 +66,7 @@ def getEventQueue(index):
 def setEventQueue(eventq):
     internal.event.curEventQueue(eventq)
 
+def useCalendarQueues(enable=True):
+    internal.event.useCalendarEventQueues(enable)
+
 __all__ = [ 'create', 'Event', 'ProgressEvent', 'SimExit', 'mainq' ]
@@ -82,6 +82,12 @@ def parse_options():
     group("Statistics Options")
     option("--stats-file", metavar="FILE", default="stats.txt",
         help="Sets the output file for statistics [Default: %default]")
+    option("--stats-binary-file", metavar="FILE", default="",
+        help="Also write statistics to FILE in the columnar binary "
+        "format read by util/stats_binary.py")
+    option("--stats-filter", metavar="REGEX[,REGEX...]", default="",
+        help="Only dump statistics whose names match one of the given "
+        "regular expressions; a plain name selects its whole subtree")
 
     # Configuration Options
     group("Configuration Options")
@@ -92,6 +98,18 @@ def parse_options():
     option("--dot-config", metavar="FILE", default="config.dot",
         help="Create DOT & pdf outputs of the configuration [Default: %default]")
 
+    # Simulation options
+    group("Simulation Options")
+    option("--calendar-eventq", action="store_true", default=False,
+        help="Use calendar queues instead of sorted lists for the event "
+        "queues")
+    option("--host-profile", metavar="FILE", default="",
+        help="Time simulator hot paths on the host and write a report "
+        "to FILE at exit (disabled if empty)")
+    option("--mem-report", metavar="FILE", default="",
+        help="Write the host memory allocated by each SimObject at "
+        "startup and the process peak at exit to FILE (disabled if empty)")
+
     # Debugging options
     group("Debugging Options")
     option("--debug-break", metavar="TIME[,TIME]", action='append', split=',',
@@ -170,6 +188,7 @@ def main(*args):
     import defines
     import event
     import info
+    import memreport
     import stats
     import trace
 
@@ -193,6 +212,8 @@ def main(*args):
     # Set the main event queue for the main thread.
     event.mainq = event.getEventQueue(0)
     event.setEventQueue(event.mainq)
+    if options.calendar_eventq:
+        event.useCalendarQueues()
 
     if not os.path.isdir(options.outdir):
         os.makedirs(options.outdir)
@@ -308,11 +329,22 @@ def main(*args):
     # tell C++ about output directory
     core.setOutputDir(options.outdir)
 
+    if options.host_profile:
+        core.enableHostProfile(options.host_profile)
+
+    if options.mem_report:
+        memreport.enable(os.path.join(options.outdir, options.mem_report))
+
     # update the system path with elements from the -p option
     sys.path[0:0] = options.path
 
     # set stats options
-    stats.initText(options.stats_file)
+    if options.stats_file:
+        stats.initText(options.stats_file)
+    if options.stats_binary_file:
+        stats.initBinary(options.stats_binary_file)
+    if options.stats_filter:
+        stats.addFilter(*options.stats_filter.split(','))
 
     # set debugging options
     debug.setRemoteGDBPort(options.remote_gdb_port)
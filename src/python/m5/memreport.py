@@ -0,0 +1,91 @@
+# Host memory accounting for --mem-report.
+#
+# The C heap in use is sampled around the creation, init() and
+# regStats() of every SimObject, so each object is charged with the
+# memory its C++ constructor, initialisation and statistics allocate.
+# Memory allocated later while simulating (dynamic instructions,
+# packets, guest memory pages) is not attributed to objects and only
+# shows up in the process totals written at exit.
+
+import atexit
+
+import internal
+
+PHASES = ('create', 'init', 'regStats')
+
+class MemReport(object):
+    def __init__(self, filename):
+        self.filename = filename
+        self.objects = []
+        self.bytes = {}
+        self.startup = None
+
+    def measure(self, phase, obj, method):
+        before = internal.core.heapUsage()
+        result = method()
+        delta = internal.core.heapUsage() - before
+        if obj not in self.bytes:
+            self.objects.append(obj)
+            self.bytes[obj] = dict((p, 0) for p in PHASES)
+        self.bytes[obj][phase] += delta
+        return result
+
+    def started(self):
+        self.startup = (internal.core.heapUsage(),
+                        internal.core.memUsage() * 1024,
+                        internal.core.peakMemUsage() * 1024)
+        atexit.register(self.write)
+
+    def write(self):
+        def mb(b):
+            return '%.2f' % (b / (1024.0 * 1024.0))
+
+        def total(obj):
+            return sum(self.bytes[obj].values())
+
+        f = file(self.filename, 'w')
+        heap, vsize, rss = self.startup
+        print >>f, '# startup: heap %s MB, virtual %s MB, peak rss %s MB' % \
+            (mb(heap), mb(vsize), mb(rss))
+        print >>f, '# exit: heap %s MB, virtual %s MB, peak rss %s MB' % \
+            (mb(internal.core.heapUsage()),
+             mb(internal.core.memUsage() * 1024),
+             mb(internal.core.peakMemUsage() * 1024))
+
+        types = {}
+        for obj in self.objects:
+            name = type(obj).__name__
+            count, size = types.get(name, (0, 0))
+            types[name] = (count + 1, size + total(obj))
+
+        print >>f
+        print >>f, '# %-38s %8s %14s' % ('type', 'objects', 'MB')
+        for name, (count, size) in \
+                sorted(types.items(), key=lambda t: -t[1][1]):
+            print >>f, '%-40s %8d %14s' % (name, count, mb(size))
+
+        print >>f
+        print >>f, '# %-58s' % 'object' + \
+            ''.join(' %12s' % p for p in PHASES) + ' %12s' % 'MB'
+        for obj in sorted(self.objects, key=lambda o: -total(o)):
+            print >>f, '%-60s' % obj.path() + \
+                ''.join(' %12s' % mb(self.bytes[obj][p]) for p in PHASES) + \
+                ' %12s' % mb(total(obj))
+        f.close()
+
+report = None
+
+def enable(filename):
+    global report
+    report = MemReport(filename)
+
+def call(phase, obj, method):
+    '''Call method, charging the heap it allocates to obj if the
+    report is enabled.'''
+    if report is None:
+        return method()
+    return report.measure(phase, obj, method)
+
+def started():
+    if report is not None:
+        report.started()
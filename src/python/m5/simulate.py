@@ -47,6 +47,7 @@ import sys
 # import the SWIG-wrapped main C++ functions
 import internal
 import core
+import memreport
 import stats
 import SimObject
 import ticks
@@ -113,10 +114,11 @@ def instantiate(ckpt_dir=None):
     for obj in root.descendants(): obj.connectPorts()
 
     # Do a second pass to finish initializing the sim objects
-    for obj in root.descendants(): obj.init()
+    for obj in root.descendants(): memreport.call('init', obj, obj.init)
 
     # Do a third pass to initialize statistics
-    for obj in root.descendants(): obj.regStats()
+    for obj in root.descendants():
+        memreport.call('regStats', obj, obj.regStats)
 
     # Do a fourth pass to initialize probe points
     for obj in root.descendants(): obj.regProbePoints()
@@ -140,6 +142,8 @@ def instantiate(ckpt_dir=None):
     # a checkpoint, If so, this call will shift them to be at a valid time.
     updateStatEvents()
 
+    memreport.started()
+
 need_resume = []
 need_startup = True
 def simulate(*args, **kwargs):
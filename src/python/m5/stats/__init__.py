@@ -27,6 +27,8 @@
 #
 # Authors: Nathan Binkert
 
+import re
+
 import m5
 
 from m5 import internal
@@ -39,6 +41,10 @@ def initText(filename, desc=True):
     output = internal.stats.initText(filename, desc)
     outputList.append(output)
 
+def initBinary(filename):
+    output = internal.stats.initBinary(filename)
+    outputList.append(output)
+
 def initSimStats():
     internal.stats.initSimStats()
     internal.stats.registerPythonStatsHandlers()
@@ -47,6 +53,27 @@ names = []
 stats_dict = {}
 stats_list = []
 raw_stats_list = []
+dump_list = []
+dump_filter = []
+def addFilter(*patterns):
+    '''Restrict dumps to the statistics whose names match one of the
+    given regular expressions.  A pattern selects a statistic if it
+    matches the whole name or a prefix of it ending at a '.' or ':', so
+    a plain object path such as "system.cpu.iew" selects that subtree.
+    Unselected statistics are still updated and reset, but are neither
+    prepared nor evaluated when dumping.  Filters must be added before
+    the statistics package is enabled; with no filter, everything is
+    dumped.'''
+    if dump_list:
+        fatal("stats filters must be added before stats are enabled")
+
+    for pattern in patterns:
+        try:
+            re.compile(pattern)
+        except re.error, e:
+            fatal("invalid stats filter '%s': %s", pattern, e)
+        dump_filter.append(pattern)
+
 def enable():
     '''Enable the statistics package.  Before the statistics package is
     enabled, all statistics must be created and initialized and once
@@ -84,13 +111,24 @@ def enable():
         stats_dict[stat.name] = stat
         stat.enable()
 
+    if dump_filter:
+        selected = re.compile('|'.join([ '(?:%s)(?:$|[.:])' % pattern
+                                         for pattern in dump_filter ]))
+        dump_list[:] = [ stat for stat in stats_list
+                         if selected.match(stat.name) ]
+        if not dump_list:
+            fatal("stats filter %s selects no statistics",
+                  ', '.join(dump_filter))
+    else:
+        dump_list[:] = stats_list
+
     internal.stats.enable();
 
 def prepare():
-    '''Prepare all stats for data access.  This must be done before
+    '''Prepare the dumped stats for data access.  This must be done before
     dumping and serialization.'''
 
-    for stat in stats_list:
+    for stat in dump_list:
         stat.prepare()
 
 lastDump = 0
@@ -112,7 +150,7 @@ def dump():
     for output in outputList:
         if output.valid():
             output.begin()
-            for stat in stats_list:
+            for stat in dump_list:
                 output.visit(stat)
             output.end()
 
@@ -32,6 +32,8 @@
 %module(package="m5.internal") core
 
 %{
+#include "base/host_profile.hh"
+#include "base/hostinfo.hh"
 #include "base/misc.hh"
 #include "base/random.hh"
 #include "base/socket.hh"
@@ -55,6 +57,12 @@ const bool flag_TRACING_ON = TRACING_ON;
 
 inline void disableAllListeners() { ListenSocket::disableAll(); }
 
+inline void
+enableHostProfile(const std::string &filename)
+{
+    HostProfile::enable(filename);
+}
+
 inline void
 seedRandom(uint64_t seed)
 {
@@ -72,6 +80,10 @@ void setOutputDir(const std::string &dir);
 void doExitCleanup();
 void disableAllListeners();
 void seedRandom(uint64_t seed);
+void enableHostProfile(const std::string &filename);
+uint64_t memUsage();
+uint64_t peakMemUsage();
+uint64_t heapUsage();
 
 %immutable compileDate;
 char *compileDate;
@@ -36,6 +36,8 @@
 %include <stdint.i>
 
 %{
+#include "base/host_profile.hh"
+#include "base/stats/binary.hh"
 #include "base/stats/text.hh"
 #include "base/stats/types.hh"
 #include "base/callback.hh"
@@ -91,6 +93,7 @@ call_module_function(const char *module_name, const char *func_name)
 void
 pythonDump()
 {
+    HOST_PROFILE("stats.dump");
     call_module_function("m5.stats", "dump");
 }
 
@@ -136,6 +139,7 @@ template <class T> T cast_info(Info *info);
 
 void initSimStats();
 Output *initText(const std::string &filename, bool desc);
+Output *initBinary(const std::string &filename);
 
 void registerPythonStatsHandlers();
 
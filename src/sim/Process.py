@@ -42,6 +42,8 @@ class Process(SimObject):
                             table in an architecture-specific format')
     kvmInSE = Param.Bool('false', 'initialize the process for KvmCPU in SE')
     max_stack_size = Param.MemorySize('64MB', 'maximum size of the stack')
+    dram_partition = Param.Int(-1, 'DRAM bank partition this process is '
+                               'restricted to, -1 for no restriction')
 
     @classmethod
     def export_methods(cls, code):
@@ -73,6 +73,13 @@ class System(MemObject):
 
     cache_line_size = Param.Unsigned(64, "Cache line size in bytes")
 
+    # In SE mode the physical pages of a process can be restricted to
+    # a subset of the DRAM banks/ranks (page coloring). The colors are
+    # exported by the DRAM controllers and split evenly into this many
+    # partitions; a process picks one with its dram_partition param.
+    dram_partitions = Param.Unsigned(1, "Number of DRAM bank partitions "
+                                     "for page coloring (1 to disable)")
+
     work_item_id = Param.Int(-1, "specific work item id")
     num_work_ids = Param.Int(16, "Number of distinct work item types")
     work_begin_cpu_id_exit = Param.Int(-1,
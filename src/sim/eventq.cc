@@ -32,12 +32,14 @@
  *          Steve Raasch
  */
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
 #include <vector>
 
 #include "base/hashmap.hh"
+#include "base/intmath.hh"
 #include "base/misc.hh"
 #include "base/trace.hh"
 #include "cpu/smt.hh"
@@ -60,6 +62,14 @@ vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
 
+//! Backend used by newly created event queues.
+static bool calendarEventQueues = false;
+
+//! Smallest number of calendar buckets, and the number of bins used
+//! to estimate the day width when resizing.
+static const size_t minCalendarBuckets = 16;
+static const size_t calendarSamples = 64;
+
 EventQueue *
 getEventQueue(uint32_t index)
 {
@@ -72,6 +82,20 @@ getEventQueue(uint32_t index)
     return mainEventQueue[index];
 }
 
+void
+useCalendarEventQueues(bool enable)
+{
+    calendarEventQueues = enable;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->setCalendar(enable);
+}
+
+static bool
+binLess(const Event *l, const Event *r)
+{
+    return *l < *r;
+}
+
 #ifndef NDEBUG
 Counter Event::instanceCounter = 0;
 #endif
@@ -117,6 +141,11 @@ Event::insertBefore(Event *event, Event *curr)
 void
 EventQueue::insert(Event *event)
 {
+    if (calendar) {
+        calendarInsert(event);
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -176,6 +205,11 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    if (calendar) {
+        calendarRemove(event);
+        return;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -208,7 +242,11 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (calendar) {
+        // the head bin is the first one in its bucket, so this is
+        // constant time
+        calendarRemove(event);
+    } else if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -241,6 +279,211 @@ EventQueue::serviceOne()
     return NULL;
 }
 
+void
+EventQueue::calendarInsert(Event *event)
+{
+    Event **link = &buckets[bucketOf(event->when())];
+    while (*link && **link < *event)
+        link = &(*link)->nextBin;
+
+    // Same as the sorted list: either start a new bin or push the
+    // event on top of the existing one.
+    bool new_bin = !*link || *event != **link;
+    *link = Event::insertBefore(event, *link);
+
+    if (!head || *event <= *head)
+        head = event;
+
+    if (new_bin && ++numBins > 2 * buckets.size())
+        calendarResize(2 * buckets.size());
+}
+
+void
+EventQueue::calendarRemove(Event *event)
+{
+    Event **link = &buckets[bucketOf(event->when())];
+    while (*link && **link < *event)
+        link = &(*link)->nextBin;
+
+    Event *top = *link;
+    if (!top || *top != *event)
+        panic("event not found!");
+
+    bool bin_gone = event == top && !top->nextInBin;
+    *link = Event::removeItem(event, top);
+
+    if (!bin_gone) {
+        if (top == head)
+            head = *link;
+        return;
+    }
+
+    --numBins;
+    if (buckets.size() > minCalendarBuckets &&
+        numBins < buckets.size() / 4) {
+        calendarResize(buckets.size() / 2);
+    } else if (top == head) {
+        head = calendarFindHead(event->when());
+    }
+}
+
+void
+EventQueue::calendarInsertBin(Event *bin)
+{
+    Event **link = &buckets[bucketOf(bin->when())];
+    while (*link && **link < *bin)
+        link = &(*link)->nextBin;
+
+    bin->nextBin = *link;
+    *link = bin;
+    ++numBins;
+
+    if (!head || *bin < *head)
+        head = bin;
+}
+
+Event *
+EventQueue::calendarFindHead(Tick from)
+{
+    if (!numBins)
+        return NULL;
+
+    // Walk the days from 'from' on. Buckets are sorted, so the first
+    // bucket whose first bin falls on the day being looked at holds
+    // the earliest bin.
+    Tick day = from >> bucketShift;
+    for (size_t i = 0; i < buckets.size(); ++i, ++day) {
+        Event *first = buckets[day & (buckets.size() - 1)];
+        if (first && (first->when() >> bucketShift) == day)
+            return first;
+    }
+
+    // Nothing within a year: the days are too short for the current
+    // event spacing. Re-estimate them, which also finds the head.
+    calendarResize(buckets.size());
+    return head;
+}
+
+void
+EventQueue::calendarResize(size_t size)
+{
+    std::vector<Event *> bins;
+    bins.reserve(numBins);
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        for (Event *bin = buckets[i]; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+
+    calendarRehash(bins, size);
+}
+
+void
+EventQueue::calendarRehash(std::vector<Event *> &bins, size_t size)
+{
+    assert(isPowerOf2(size));
+
+    // Size the days from the spacing of the earliest bins, ignoring
+    // outliers, so that each day holds a few bins (Brown's calendar
+    // queue heuristic).
+    size_t samples = std::min(bins.size(), calendarSamples);
+    std::partial_sort(bins.begin(), bins.begin() + samples, bins.end(),
+                      binLess);
+    if (samples > 1) {
+        Tick span = bins[samples - 1]->when() - bins[0]->when();
+        Tick average = span / (samples - 1);
+        Tick total = 0;
+        size_t gaps = 0;
+        for (size_t i = 1; i < samples; ++i) {
+            Tick gap = bins[i]->when() - bins[i - 1]->when();
+            if (gap / 2 <= average) {
+                total += gap;
+                ++gaps;
+            }
+        }
+
+        Tick width = std::min(total / gaps, MaxTick / 4) * 3;
+        bucketShift = width ? floorLog2(width) : 0;
+    }
+
+    buckets.assign(size, NULL);
+    numBins = 0;
+    head = NULL;
+    for (size_t i = 0; i < bins.size(); ++i)
+        calendarInsertBin(bins[i]);
+}
+
+Event *
+EventQueue::calendarDrain()
+{
+    std::vector<Event *> bins;
+    sortedBins(bins);
+
+    Event *list = NULL;
+    for (size_t i = bins.size(); i > 0; --i) {
+        bins[i - 1]->nextBin = list;
+        list = bins[i - 1];
+    }
+
+    std::fill(buckets.begin(), buckets.end(), (Event *)NULL);
+    numBins = 0;
+    head = NULL;
+    return list;
+}
+
+void
+EventQueue::calendarFill(Event *list)
+{
+    assert(!numBins);
+
+    std::vector<Event *> bins;
+    for (Event *bin = list; bin; bin = bin->nextBin)
+        bins.push_back(bin);
+
+    size_t size = minCalendarBuckets;
+    while (size < bins.size())
+        size *= 2;
+    calendarRehash(bins, size);
+}
+
+void
+EventQueue::sortedBins(std::vector<Event *> &bins) const
+{
+    bins.clear();
+    if (!calendar) {
+        for (Event *bin = head; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+        return;
+    }
+
+    bins.reserve(numBins);
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        for (Event *bin = buckets[i]; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+    std::sort(bins.begin(), bins.end(), binLess);
+}
+
+void
+EventQueue::setCalendar(bool enable)
+{
+    if (enable == calendar)
+        return;
+
+    if (enable) {
+        Event *bins = head;
+        head = NULL;
+        buckets.assign(minCalendarBuckets, NULL);
+        bucketShift = 0;
+        numBins = 0;
+        calendar = true;
+        calendarFill(bins);
+    } else {
+        head = calendarDrain();
+        buckets.clear();
+        calendar = false;
+    }
+}
+
 void
 Event::serialize(std::ostream &os)
 {
@@ -294,10 +537,12 @@ EventQueue::serialize(ostream &os)
 {
     std::list<Event *> eventPtrs;
 
+    std::vector<Event *> bins;
+    sortedBins(bins);
+
     int numEvents = 0;
-    Event *nextBin = head;
-    while (nextBin) {
-        Event *nextInBin = nextBin;
+    for (size_t i = 0; i < bins.size(); ++i) {
+        Event *nextInBin = bins[i];
 
         while (nextInBin) {
             if (nextInBin->flags.isSet(Event::AutoSerialize)) {
@@ -307,8 +552,6 @@ EventQueue::serialize(ostream &os)
             }
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     SERIALIZE_SCALAR(numEvents);
@@ -346,15 +589,14 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
-            Event *nextInBin = nextBin;
+        std::vector<Event *> bins;
+        sortedBins(bins);
+        for (size_t i = 0; i < bins.size(); ++i) {
+            Event *nextInBin = bins[i];
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -369,9 +611,16 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
-    Event *nextBin = head;
-    while (nextBin) {
-        Event *nextInBin = nextBin;
+    std::vector<Event *> bins;
+    sortedBins(bins);
+    if (!bins.empty() && bins.front() != head) {
+        cprintf("head is not the earliest event!");
+        head->dump();
+        return false;
+    }
+
+    for (size_t i = 0; i < bins.size(); ++i) {
+        Event *nextInBin = bins[i];
         while (nextInBin) {
             if (nextInBin->when() < time) {
                 cprintf("time goes backwards!");
@@ -396,8 +645,6 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
@@ -406,6 +653,14 @@ EventQueue::debugVerify() const
 Event*
 EventQueue::replaceHead(Event* s)
 {
+    if (calendar) {
+        // Hand out and take back the events as a sorted bin list, so
+        // callers see the same thing with either backend.
+        Event* t = calendarDrain();
+        calendarFill(s);
+        return t;
+    }
+
     Event* t = head;
     head = s;
     return t;
@@ -460,8 +715,10 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), calendar(false),
+      bucketShift(0), numBins(0)
 {
+    setCalendar(calendarEventQueues);
 }
 
 void
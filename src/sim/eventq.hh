@@ -45,6 +45,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "base/flags.hh"
 #include "base/misc.hh"
@@ -85,6 +86,10 @@ extern bool inParallelMode;
 //! is with in bounds.
 EventQueue *getEventQueue(uint32_t index);
 
+//! Switch all current and future event queues to (or back from) the
+//! calendar queue backend. See EventQueue::setCalendar().
+void useCalendarEventQueues(bool enable);
+
 inline EventQueue *curEventQueue() { return _curEventQueue; }
 inline void curEventQueue(EventQueue *q) { _curEventQueue = q; }
 
@@ -448,6 +453,20 @@ class EventQueue : public Serializable
     Event *head;
     Tick _curTick;
 
+    /**
+     * Calendar queue state. When calendar is set, the bins described
+     * in Event are hashed on their tick into buckets ("days") of
+     * 2^bucketShift ticks, each holding a sorted nextBin list, and
+     * head caches the earliest bin. This makes inserting and
+     * servicing an event amortized O(1) rather than linear in the
+     * number of bins, while events come out in exactly the same order
+     * as with the single sorted list.
+     */
+    bool calendar;
+    std::vector<Event *> buckets;
+    unsigned bucketShift;
+    size_t numBins;
+
     //! Mutex to protect async queue.
     std::mutex async_queue_mutex;
 
@@ -481,6 +500,35 @@ class EventQueue : public Serializable
     void insert(Event *event);
     void remove(Event *event);
 
+    size_t
+    bucketOf(Tick when) const
+    {
+        return (when >> bucketShift) & (buckets.size() - 1);
+    }
+
+    //! Calendar queue counterparts of insert() and remove().
+    void calendarInsert(Event *event);
+    void calendarRemove(Event *event);
+
+    //! Link a whole bin into its bucket.
+    void calendarInsertBin(Event *bin);
+
+    //! Find the earliest bin, given that none is earlier than from.
+    Event *calendarFindHead(Tick from);
+
+    //! Rehash all bins into size buckets, re-estimating the day width.
+    void calendarResize(size_t size);
+    void calendarRehash(std::vector<Event *> &bins, size_t size);
+
+    //! Empty the calendar, returning its bins as a sorted nextBin list.
+    Event *calendarDrain();
+
+    //! Load the bins of a sorted nextBin list into an empty calendar.
+    void calendarFill(Event *list);
+
+    //! Collect the top event of every bin in service order.
+    void sortedBins(std::vector<Event *> &bins) const;
+
     //! Function for adding events to the async queue. The added events
     //! are added to main event queue later. Threads, other than the
     //! owning thread, should call this function instead of insert().
@@ -568,6 +616,14 @@ class EventQueue : public Serializable
     //! the owning thread.
     void reschedule(Event *event, Tick when, bool always = false);
 
+    /**
+     * Select the calendar queue (true) or the sorted bin list (false)
+     * as the backing store. Queued events are carried over, so this
+     * may be called at any time from the owning thread.
+     */
+    void setCalendar(bool enable);
+    bool isCalendar() const { return calendar; }
+
     Tick nextTick() const { return head->when(); }
     void setCurTick(Tick newVal) { _curTick = newVal; }
     Tick getCurTick() { return _curTick; }
@@ -107,6 +107,8 @@ Process::Process(ProcessParams * params)
     : SimObject(params), system(params->system),
       brk_point(0), stack_base(0), stack_size(0), stack_min(0),
       max_stack_size(params->max_stack_size),
+      dramPartition(params->dram_partition),
+      numColoredPages(0),
       next_thread_stack_base(0),
       M5_pid(system->allocatePID()),
       useArchPT(params->useArchPT),
@@ -257,6 +259,15 @@ Process::initState()
     tc->activate();
 
     pTable->initState(tc);
+
+    if (dramPartition >= 0) {
+        if (!system->pageColoringEnabled())
+            fatal("Process %s asks for DRAM partition %d, but no memory "
+                  "controller exports page colors\n", name(), dramPartition);
+        if ((unsigned)dramPartition >= system->numDRAMPartitions())
+            fatal("Process %s asks for DRAM partition %d out of %d\n",
+                  name(), dramPartition, system->numDRAMPartitions());
+    }
 }
 
 // map simulator fd sim_fd to target fd tgt_fd
@@ -341,6 +352,19 @@ void
 Process::allocateMem(Addr vaddr, int64_t size, bool clobber)
 {
     int npages = divCeil(size, (int64_t)PageBytes);
+
+    if (dramPartition >= 0 && system->pageColoringEnabled()) {
+        // the pages are not contiguous any more, map them one by one
+        for (int i = 0; i < npages; i++) {
+            unsigned color =
+                system->partitionColor(dramPartition, numColoredPages++);
+            Addr paddr = system->allocColoredPhysPage(color);
+            pTable->map(vaddr + i * PageBytes, paddr, PageBytes,
+                        clobber ? PageTableBase::Clobber : 0);
+        }
+        return;
+    }
+
     Addr paddr = system->allocPhysPages(npages);
     pTable->map(vaddr, paddr, size, clobber ? PageTableBase::Clobber : 0);
 }
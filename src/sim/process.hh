@@ -101,6 +101,13 @@ class Process : public SimObject
     // The maximum size allowed for the stack.
     Addr max_stack_size;
 
+    // DRAM partition the physical pages come from, -1 for any
+    const int dramPartition;
+
+    // number of pages allocated in the DRAM partition so far, used to
+    // rotate over the colors of the partition
+    unsigned numColoredPages;
+
     // addr to use for next stack region (for multithreaded apps)
     Addr next_thread_stack_base;
 
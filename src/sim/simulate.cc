@@ -34,6 +34,7 @@
 #include <mutex>
 #include <thread>
 
+#include "base/host_profile.hh"
 #include "base/misc.hh"
 #include "base/pollevent.hh"
 #include "base/types.hh"
@@ -215,7 +216,11 @@ doSimLoop(EventQueue *eventq)
             }
         }
 
-        Event *exit_event = eventq->serviceOne();
+        Event *exit_event;
+        {
+            HOST_PROFILE("eventq.service");
+            exit_event = eventq->serviceOne();
+        }
         if (exit_event != NULL) {
             return exit_event;
         }
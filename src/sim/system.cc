@@ -45,8 +45,11 @@
  *          Rick Strong
  */
 
+#include <algorithm>
+
 #include "arch/remote_gdb.hh"
 #include "arch/utility.hh"
+#include "base/intmath.hh"
 #include "base/loader/object_file.hh"
 #include "base/loader/symtab.hh"
 #include "base/str.hh"
@@ -81,6 +84,9 @@ System::System(Params *p)
     : MemObject(p), _systemPort("system_port", this),
       _numContexts(0),
       pagePtr(0),
+      dramPartitions(p->dram_partitions),
+      numPageColors(0),
+      pageColorShift(0),
       init_param(p->init_param),
       physProxy(_systemPort, p->cache_line_size),
       kernelSymtab(nullptr),
@@ -112,6 +118,9 @@ System::System(Params *p)
           _cacheLineSize == 64 || _cacheLineSize == 128))
         warn_once("Cache line size is neither 16, 32, 64 nor 128 bytes.\n");
 
+    if (dramPartitions == 0)
+        fatal("%s needs at least one DRAM partition\n", name());
+
     // Get the generic system master IDs
     MasterID tmp_id M5_VAR_USED;
     tmp_id = getMasterId("writebacks");
@@ -334,9 +343,72 @@ System::allocPhysPages(int npages)
 
     if ((pagePtr << PageShift) > physmem.totalSize())
         fatal("Out of memory, please increase size of physical memory.");
+
+    // colored pages are only handed out above the contiguous ones
+    for (auto &color_ptr : colorPagePtr)
+        color_ptr = std::max(color_ptr, pagePtr);
+
     return return_addr;
 }
 
+Addr
+System::allocColoredPhysPage(unsigned color)
+{
+    assert(color < numPageColors);
+
+    // the colors repeat every period pages, each of them owning a
+    // chunk of consecutive pages within the period
+    Addr pages_per_chunk = ULL(1) << (pageColorShift - PageShift);
+    Addr period = pages_per_chunk * numPageColors;
+
+    Addr page = colorPagePtr[color];
+    Addr chunk_start = page - page % period + color * pages_per_chunk;
+    if (page < chunk_start) {
+        page = chunk_start;
+    } else if (page >= chunk_start + pages_per_chunk) {
+        page = chunk_start + period;
+    }
+
+    colorPagePtr[color] = page + 1;
+    pagePtr = std::max(pagePtr, page + 1);
+
+    if ((pagePtr << PageShift) > physmem.totalSize())
+        fatal("Out of memory in page color %d, please increase size of "
+              "physical memory.", color);
+    return page << PageShift;
+}
+
+void
+System::setPageColoring(unsigned shift, unsigned num_colors)
+{
+    if (numPageColors != 0) {
+        // every channel has to agree on the bank/rank bits
+        if (shift != pageColorShift || num_colors != numPageColors)
+            fatal("Memory controllers of %s disagree on the page colors\n",
+                  name());
+        return;
+    }
+
+    if (shift < PageShift)
+        fatal("Bank bits of %s are below the page offset, page coloring "
+              "needs a row buffer of at least one page\n", name());
+    if (!isPowerOf2(num_colors) || num_colors % dramPartitions != 0)
+        fatal("%d page colors cannot be split into %d DRAM partitions\n",
+              num_colors, dramPartitions);
+
+    numPageColors = num_colors;
+    pageColorShift = shift;
+    colorPagePtr.assign(numPageColors, pagePtr);
+}
+
+unsigned
+System::partitionColor(int partition, unsigned idx) const
+{
+    assert(partition >= 0 && partition < dramPartitions);
+    unsigned colors_per_partition = numPageColors / dramPartitions;
+    return partition * colors_per_partition + idx % colors_per_partition;
+}
+
 Addr
 System::memSize() const
 {
@@ -391,6 +463,8 @@ System::unserialize(Checkpoint *cp, const string &section)
         kernelSymtab->unserialize("kernel_symtab", cp, section);
     UNSERIALIZE_SCALAR(pagePtr);
     UNSERIALIZE_SCALAR(nextPID);
+    // the restored pages may have any color
+    colorPagePtr.assign(colorPagePtr.size(), pagePtr);
     unserializeSymtab(cp, section);
 
     // also unserialize the memories in the system
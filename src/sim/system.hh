@@ -214,6 +214,21 @@ class System : public MemObject
 
     Addr pagePtr;
 
+  protected:
+    /// Number of DRAM partitions the page colors are split into
+    const unsigned dramPartitions;
+
+    /// Number of page colors, 0 if page coloring is disabled
+    unsigned numPageColors;
+
+    /// Lowest physical address bit of the page color
+    unsigned pageColorShift;
+
+    /// Next page number to try for each color
+    std::vector<Addr> colorPagePtr;
+
+  public:
+
     uint64_t init_param;
 
     /** Port to physical memory used for writing object files into ram at
@@ -514,6 +529,33 @@ class System : public MemObject
     /// @return Starting address of first page
     Addr allocPhysPages(int npages);
 
+    /// Allocate one unused physical page of the given page color
+    /// @return Starting address of the page
+    Addr allocColoredPhysPage(unsigned color);
+
+    /**
+     * Called by the memory controllers to export which physical
+     * address bits select the DRAM bank and rank. Every combination
+     * of these bits is a page color.
+     *
+     * @param shift Lowest address bit of the bank/rank field
+     * @param num_colors Number of banks times number of ranks
+     */
+    void setPageColoring(unsigned shift, unsigned num_colors);
+
+    /// Is the physical memory split into DRAM partitions?
+    bool pageColoringEnabled() const { return numPageColors != 0; }
+
+    /// Number of DRAM partitions processes can be restricted to
+    unsigned numDRAMPartitions() const { return dramPartitions; }
+
+    /**
+     * Map the idx-th page of a partition to a color of that partition,
+     * so that consecutive pages of a process are spread over all the
+     * banks it owns.
+     */
+    unsigned partitionColor(int partition, unsigned idx) const;
+
     int registerThreadContext(ThreadContext *tc, int assigned=-1);
     void replaceThreadContext(ThreadContext *tc, int context_id);
 
@@ -0,0 +1,167 @@
+/**
+ * @file Stress test and benchmark for the event queue backends.
+ *
+ * A fixed population of events keeps rescheduling itself with a mix
+ * of delays resembling a full-system run: cache responses a few
+ * cycles out, DRAM accesses, periodic refreshes and rare far-future
+ * timers. Some events are also moved early, or descheduled and
+ * scheduled again later. The same seeded workload is run on the
+ * sorted list and on the calendar queue; both must service the
+ * events in the same order, and the time each takes is reported.
+ *
+ * Usage: eventqtest [events] [population]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "sim/eventq_impl.hh"
+#include "unittest/unittest.hh"
+
+using namespace std;
+using UnitTest::setCase;
+
+class StressEvent : public Event
+{
+  private:
+    EventQueue *eq;
+    mt19937_64 &rng;
+    vector<int> &log;
+    int id;
+
+  public:
+    StressEvent(EventQueue *_eq, mt19937_64 &_rng, vector<int> &_log,
+                int _id, Priority p)
+        : Event(p), eq(_eq), rng(_rng), log(_log), id(_id)
+    {}
+
+    Tick
+    delay()
+    {
+        uint64_t r = rng();
+        switch (r % 16) {
+          case 0:
+            // far-future timer
+            return 1000000 + (r >> 8) % 100000000;
+          case 1:
+            // refresh-like periodic event
+            return 7800000;
+          case 2: case 3: case 4:
+            // DRAM access
+            return 20000 + (r >> 8) % 80000;
+          default:
+            // cache hit or response, on a 500 tick clock edge
+            return 500 * (1 + (r >> 8) % 40);
+        }
+    }
+
+    void
+    process()
+    {
+        log.push_back(id);
+        eq->schedule(this, eq->getCurTick() + delay());
+    }
+
+    void
+    perturb()
+    {
+        uint64_t r = rng();
+        if (r % 2) {
+            eq->reschedule(this, eq->getCurTick() + 500 * (r % 8), true);
+        } else {
+            if (scheduled())
+                eq->deschedule(this);
+            eq->schedule(this, eq->getCurTick() + delay());
+        }
+    }
+};
+
+struct Result
+{
+    vector<int> log;
+    double seconds;
+};
+
+static Result
+run(bool calendar, int events, int population)
+{
+    Result result;
+    result.log.reserve(events);
+
+    EventQueue eq(calendar ? "calendar" : "list");
+    eq.setCalendar(calendar);
+    curEventQueue(&eq);
+
+    mt19937_64 rng(1);
+    const Event::Priority priorities[] = {
+        Event::Default_Pri, Event::Default_Pri, Event::Delayed_Writeback_Pri,
+        Event::CPU_Tick_Pri, Event::Stat_Event_Pri,
+    };
+
+    vector<StressEvent *> pool;
+    for (int i = 0; i < population; ++i) {
+        Event::Priority pri = priorities[rng() % 5];
+        pool.push_back(new StressEvent(&eq, rng, result.log, i, pri));
+        eq.schedule(pool.back(), pool.back()->delay());
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (result.log.size() < (size_t)events && !eq.empty()) {
+        eq.serviceOne();
+        if (result.log.size() % 64 == 0)
+            pool[rng() % population]->perturb();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    result.seconds = elapsed.count();
+
+    EXPECT_TRUE(eq.debugVerify());
+
+    for (int i = 0; i < population; ++i) {
+        if (pool[i]->scheduled())
+            eq.deschedule(pool[i]);
+        delete pool[i];
+    }
+    EXPECT_TRUE(eq.empty());
+
+    return result;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int events = argc > 1 ? atoi(argv[1]) : 500000;
+    vector<int> populations;
+    if (argc > 2) {
+        populations.push_back(atoi(argv[2]));
+    } else {
+        populations.push_back(16);
+        populations.push_back(1024);
+        populations.push_back(16384);
+    }
+
+    // setCase() keeps the pointer, so the labels must outlive the run
+    vector<string> labels;
+    for (int i = 0; i < populations.size(); ++i)
+        labels.push_back(csprintf("%d queued events", populations[i]));
+
+    for (int i = 0; i < populations.size(); ++i) {
+        int population = populations[i];
+        setCase(labels[i].c_str());
+
+        Result list = run(false, events, population);
+        Result calendar = run(true, events, population);
+        EXPECT_EQ(list.log.size(), (size_t)events);
+        EXPECT_TRUE(list.log == calendar.log);
+
+        cprintf("%6d queued: list %.3fs (%.2f Mevents/s), "
+                "calendar %.3fs (%.2f Mevents/s)\n", population,
+                list.seconds, events / list.seconds / 1e6,
+                calendar.seconds, events / calendar.seconds / 1e6);
+    }
+
+    return UnitTest::printResults();
+}
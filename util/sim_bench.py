@@ -0,0 +1,254 @@
+#!/usr/bin/env python2.7
+
+# Simulator throughput benchmark for the QoS SMT core.
+#
+# Runs a fixed set of short configurations from configs/spec for a fixed
+# number of CPU cycles and reports, per configuration, the host
+# simulation rate (KIPS), peak resident set size and startup time as
+# JSON. Compare two reports with util/sim_bench_compare.py.
+#
+# Uses the same environment as run_smt_cpt.py: gem5_root, gem5_build and
+# cpu_2006_dir, plus checkpoint_dir when --checkpoint is given.
+#
+#   sim_bench.py -o base.json
+#   ... rebuild ...
+#   sim_bench.py -o new.json
+#   sim_bench_compare.py base.json new.json
+
+from __future__ import print_function
+
+import errno
+import json
+import os
+import platform
+import pty
+import re
+import subprocess
+import sys
+import time
+import tty
+from argparse import ArgumentParser
+from os.path import join as pjoin
+
+from common import merged_cpt_dir
+
+# name, script in configs/spec, extra script options
+CASES = [
+    ('st', 'sim_st.py', []),
+    ('static_part', 'static_part_core.py', []),
+    ('dyn', 'dyn.py', []),
+    ('dyn_cache', 'dyn.py', ['--dyn-cache']),
+    ('cazorla', 'cazorla.py', ['--cazorla-cache']),
+    ('ilp_ctrl', 'ilp_ctrl.py', []),
+]
+
+# Short, memory-bound and compute-bound pairs from selected_pairs.txt.
+PAIRS = [
+    ('libquantum', 'mcf'),
+    ('gromacs', 'sjeng'),
+]
+
+# CPU clock the cycle budget is counted in.
+CPU_CLOCK = '2GHz'
+TICKS_PER_CYCLE = 500
+
+SIM_START = b'**** REAL SIMULATION ****'
+
+
+def get_pairs(inf):
+    x = []
+    with open(inf) as f:
+        for line in f:
+            if line.strip():
+                a, b = line.split()
+                x.append((a, b))
+    return x
+
+
+def last_stat(stats_file, name):
+    value = None
+    pattern = re.compile(r'^{}\s+(\S+)'.format(re.escape(name)))
+    with open(stats_file) as f:
+        for line in f:
+            m = pattern.match(line)
+            if m:
+                value = float(m.group(1))
+    return value
+
+
+def run_once(opt, case, pair, outdir):
+    name, script, script_args = case
+
+    if not os.path.isdir(outdir):
+        os.makedirs(outdir)
+
+    # The single-thread baseline runs the first benchmark of the pair
+    # alone; sim_st.py would run both as SMT threads given --smt.
+    single = script == 'sim_st.py'
+    if single:
+        workload = ['--benchmark=' + pair[0]]
+    else:
+        workload = ['--smt', '--benchmark={};{}'.format(pair[0], pair[1])]
+
+    cmd = [
+        opt.gem5,
+        '--outdir=' + outdir,
+        pjoin(os.environ['gem5_root'], 'configs/spec', script),
+    ] + workload + [
+        '--benchmark_stdout=' + outdir,
+        '--benchmark_stderr=' + outdir,
+        '--cpu-type=detailed',
+        '--cpu-clock=' + CPU_CLOCK,
+        '--mem-size=8GB',
+        '--rel-max-tick={}'.format(opt.cycles * TICKS_PER_CYCLE),
+    ] + script_args
+
+    # merged checkpoints hold both threads of the pair
+    if opt.checkpoint and not single:
+        cmd += ['-r', '1', '--checkpoint-dir',
+                pjoin(merged_cpt_dir(), pair[0] + '_' + pair[1])]
+
+    if opt.gem5_args:
+        cmd = cmd[:1] + opt.gem5_args.split() + cmd[1:]
+
+    # gem5 block-buffers its stdout into a pipe, so the start marker
+    # would only show up at exit. On a terminal it is line buffered;
+    # the raw mode keeps the output as written.
+    master, slave = pty.openpty()
+    tty.setraw(slave)
+
+    start = time.time()
+    startup = None
+    tail = b''
+    with open(pjoin(outdir, 'gem5_err.txt'), 'w') as err, \
+            open(pjoin(outdir, 'gem5_out.txt'), 'wb') as out:
+        p = subprocess.Popen(cmd, stdout=slave, stderr=err)
+        os.close(slave)
+        while True:
+            try:
+                data = os.read(master, 65536)
+            except OSError as e:
+                # reading a pty whose other end is closed fails with EIO
+                if e.errno != errno.EIO:
+                    raise
+                break
+            if not data:
+                break
+            out.write(data)
+            if startup is None:
+                tail += data
+                if SIM_START in tail:
+                    startup = time.time() - start
+                tail = tail[-len(SIM_START):]
+        os.close(master)
+        _, status, usage = os.wait4(p.pid, 0)
+    wall = time.time() - start
+
+    if status != 0:
+        sys.exit('{} on {} failed, see {}'.format(name, pair, outdir))
+
+    stats_file = pjoin(outdir, 'stats.txt')
+    insts = last_stat(stats_file, 'sim_insts')
+    seconds = last_stat(stats_file, 'host_seconds')
+    if not insts or not seconds:
+        sys.exit('{} has no sim_insts or host_seconds'.format(stats_file))
+
+    return {
+        'kips': insts / seconds / 1000.0,
+        # ru_maxrss is in kilobytes on Linux
+        'peak_rss_mb': usage.ru_maxrss / 1024.0,
+        'startup_s': startup if startup is not None else wall - seconds,
+        'wall_s': wall,
+        'sim_insts': insts,
+    }
+
+
+def best_of(runs):
+    # The fastest run is the least disturbed by other host load.
+    best = max(runs, key=lambda r: r['kips'])
+    best = dict(best)
+    best['peak_rss_mb'] = min(r['peak_rss_mb'] for r in runs)
+    best['startup_s'] = min(r['startup_s'] for r in runs)
+    return best
+
+
+def git_revision():
+    try:
+        return subprocess.check_output(
+            ['git', 'rev-parse', 'HEAD'],
+            cwd=os.environ['gem5_root']).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def main():
+    parser = ArgumentParser(
+        description='Measure simulator throughput on fixed QoS SMT runs')
+    parser.add_argument('-o', '--output', action='store',
+                        help='JSON report file (default: stdout)')
+    parser.add_argument('--workdir', action='store',
+                        default=pjoin(os.getcwd(), 'sim_bench_out'),
+                        help='directory for the gem5 output of each run')
+    parser.add_argument('--gem5', action='store',
+                        help='gem5 binary (default: $gem5_build/gem5.fast)')
+    parser.add_argument('--gem5-args', action='store',
+                        help='space separated options passed to gem5')
+    parser.add_argument('--cycles', action='store', type=int,
+                        default=2000000,
+                        help='CPU cycles to simulate per run')
+    parser.add_argument('--repeat', action='store', type=int, default=1,
+                        help='runs per configuration, best one reported')
+    parser.add_argument('-i', '--input', action='store',
+                        help='benchmark pairs file (default: built-in)')
+    parser.add_argument('--cases', action='store',
+                        help='comma separated subset of: ' +
+                        ', '.join(c[0] for c in CASES))
+    parser.add_argument('--checkpoint', action='store_true',
+                        help='restore each pair from its merged checkpoint '
+                        '(the st case always starts from the beginning)')
+    opt = parser.parse_args()
+
+    if not opt.gem5:
+        opt.gem5 = pjoin(os.environ['gem5_build'], 'gem5.fast')
+
+    cases = CASES
+    if opt.cases:
+        wanted = opt.cases.split(',')
+        unknown = set(wanted) - set(c[0] for c in CASES)
+        if unknown:
+            sys.exit('unknown cases: ' + ', '.join(sorted(unknown)))
+        cases = [c for c in CASES if c[0] in wanted]
+
+    pairs = get_pairs(opt.input) if opt.input else PAIRS
+
+    results = {}
+    for case in cases:
+        for pair in pairs:
+            key = '{}/{}_{}'.format(case[0], pair[0], pair[1])
+            runs = []
+            for i in range(opt.repeat):
+                outdir = pjoin(opt.workdir, key, str(i))
+                print('running', key, 'pass', i, file=sys.stderr)
+                runs.append(run_once(opt, case, pair, outdir))
+            results[key] = best_of(runs)
+
+    report = {
+        'gem5': opt.gem5,
+        'revision': git_revision(),
+        'host': platform.node(),
+        'date': time.strftime('%Y-%m-%d %H:%M:%S'),
+        'cycles': opt.cycles,
+        'repeat': opt.repeat,
+        'results': results,
+    }
+
+    text = json.dumps(report, indent=2, sort_keys=True)
+    if opt.output:
+        with open(opt.output, 'w') as f:
+            f.write(text + '\n')
+    else:
+        print(text)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,92 @@
+#!/usr/bin/env python2.7
+
+# Compare two util/sim_bench.py reports and flag simulator performance
+# regressions. Exits with status 1 if any configuration got slower,
+# bigger or slower to start than the threshold allows, or is missing.
+#
+#   sim_bench_compare.py base.json new.json
+#   sim_bench_compare.py -t 3 --startup-threshold 25 base.json new.json
+
+from __future__ import print_function
+
+import json
+import sys
+from argparse import ArgumentParser
+
+# metric, higher is better
+METRICS = [
+    ('kips', True),
+    ('peak_rss_mb', False),
+    ('startup_s', False),
+]
+
+
+def change(base, new):
+    """Relative change from base to new in percent."""
+    if not base:
+        return 0.0
+    return (new - base) * 100.0 / base
+
+
+def main():
+    parser = ArgumentParser(
+        description='Flag regressions between two sim_bench.py reports')
+    parser.add_argument('baseline', help='saved baseline report')
+    parser.add_argument('current', help='report to check')
+    parser.add_argument('-t', '--threshold', action='store', type=float,
+                        default=5.0,
+                        help='allowed KIPS drop and RSS growth in percent')
+    parser.add_argument('--startup-threshold', action='store', type=float,
+                        default=20.0,
+                        help='allowed startup time growth in percent')
+    opt = parser.parse_args()
+
+    with open(opt.baseline) as f:
+        base = json.load(f)
+    with open(opt.current) as f:
+        cur = json.load(f)
+
+    if base.get('cycles') != cur.get('cycles'):
+        print('warning: reports simulate {} and {} cycles'.format(
+            base.get('cycles'), cur.get('cycles')))
+
+    header = '{:<32}'.format('configuration')
+    for metric, _ in METRICS:
+        header += '{:>24}'.format(metric)
+    print(header)
+
+    regressions = []
+    for key in sorted(base['results']):
+        if key not in cur['results']:
+            regressions.append('{}: missing'.format(key))
+            continue
+
+        row = '{:<32}'.format(key)
+        for metric, higher_better in METRICS:
+            b = base['results'][key][metric]
+            n = cur['results'][key][metric]
+            pct = change(b, n)
+            limit = opt.startup_threshold if metric == 'startup_s' \
+                    else opt.threshold
+            worse = -pct if higher_better else pct
+            flag = ' !' if worse > limit else '  '
+            row += '{:>12.2f} {:>+8.1f}%{}'.format(n, pct, flag)
+            if worse > limit:
+                regressions.append('{}: {} {:.2f} -> {:.2f} ({:+.1f}%)'.format(
+                    key, metric, b, n, pct))
+        print(row)
+
+    for key in sorted(set(cur['results']) - set(base['results'])):
+        print('{:<32} new configuration, no baseline'.format(key))
+
+    if regressions:
+        print('\n{} regression(s):'.format(len(regressions)))
+        for r in regressions:
+            print('  ' + r)
+        sys.exit(1)
+
+    print('\nno regressions')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,120 @@
+#!/usr/bin/env python2.7
+
+# Validate the solo-run window model of the O3 core against single-thread
+# runs. For each pair, the HPT's modelled solo occupancy of the ROB, IQ,
+# LQ and SQ in the SMT run is compared with the occupancy the same
+# benchmark really had running alone. The HPT's real occupancy in the SMT
+# run is shown as well: the model is useful where it is closer to the
+# single-thread run than that.
+#
+# The output directories are laid out as run_smt_cpt.py writes them:
+# <st-dir>/<hpt>/stats.txt for the single-thread runs (-s) and
+# <smt-dir>/<hpt>_<lpt>/stats.txt for the SMT runs. Both should simulate
+# the same instructions of the HPT, e.g. from the same checkpoint.
+#
+#   solo_window_check.py --st-dir st_out --smt-dir dyn_out -i pairs.txt
+#
+# Exits with status 1 if the mean relative error of the model exceeds the
+# threshold, or if a single-thread run shows any modelled backlog: alone,
+# the model has to match the real occupancy.
+
+from __future__ import print_function
+
+import re
+import sys
+from argparse import ArgumentParser
+from os.path import join as pjoin
+
+RESOURCES = ['ROB', 'IQ', 'LQ', 'SQ']
+
+STAT = re.compile(r'^\S+\.soloWindow\.(avgOccupancy|avgRealOccupancy)'
+                  r'(ROB|IQ|LQ|SQ)(::0)?\s+(\S+)')
+
+
+def get_pairs(inf):
+    x = []
+    with open(inf) as f:
+        for line in f:
+            if line.strip():
+                a, b = line.split()
+                x.append((a, b))
+    return x
+
+
+def occupancies(stats_file):
+    """Last dumped HPT occupancies, as {(kind, resource): value}."""
+    values = {}
+    with open(stats_file) as f:
+        for line in f:
+            m = STAT.match(line)
+            if m:
+                values[(m.group(1), m.group(2))] = float(m.group(4))
+    return values
+
+
+def rel_error(value, reference):
+    if not reference:
+        return 0.0
+    return abs(value - reference) * 100.0 / reference
+
+
+def main():
+    parser = ArgumentParser(
+        description='Compare the solo-run window model with ST runs')
+    parser.add_argument('--st-dir', action='store', required=True,
+                        help='output directory of the single-thread runs')
+    parser.add_argument('--smt-dir', action='store', required=True,
+                        help='output directory of the SMT runs')
+    parser.add_argument('-i', '--input', action='store', required=True,
+                        help='benchmark pairs file')
+    parser.add_argument('-t', '--threshold', action='store', type=float,
+                        default=15.0,
+                        help='allowed mean relative error in percent')
+    opt = parser.parse_args()
+
+    print('{:<28}{:>5}{:>10}{:>10}{:>10}{:>10}{:>10}'.format(
+        'pair', '', 'st', 'model', 'smt', 'err%', 'smt err%'))
+
+    model_errors = []
+    failures = []
+    for hpt, lpt in get_pairs(opt.input):
+        pair = hpt + '_' + lpt
+        st = occupancies(pjoin(opt.st_dir, hpt, 'stats.txt'))
+        smt = occupancies(pjoin(opt.smt_dir, pair, 'stats.txt'))
+
+        for r in RESOURCES:
+            key = ('avgRealOccupancy', r)
+            model_key = ('avgOccupancy', r)
+            if key not in st or model_key not in st or \
+                    key not in smt or model_key not in smt:
+                failures.append('{} {}: occupancy stats missing'.format(
+                    pair, r))
+                continue
+
+            reference = st[key]
+            # alone, the solo run is the real run
+            if rel_error(st[model_key], reference) > 1.0:
+                failures.append('{}: ST run models {:.2f} {} entries, '
+                                'real {:.2f}'.format(hpt, st[model_key], r,
+                                                     reference))
+
+            err = rel_error(smt[model_key], reference)
+            model_errors.append(err)
+            print('{:<28}{:>5}{:>10.2f}{:>10.2f}{:>10.2f}{:>10.1f}{:>10.1f}'
+                  .format(pair, r, reference, smt[model_key], smt[key],
+                          err, rel_error(smt[key], reference)))
+
+    if model_errors:
+        mean = sum(model_errors) / len(model_errors)
+        print('mean model error: {:.1f}%'.format(mean))
+        if mean > opt.threshold:
+            failures.append('mean model error {:.1f}% exceeds {:.1f}%'.format(
+                mean, opt.threshold))
+
+    if failures:
+        print('\n'.join(failures))
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,125 @@
+#!/usr/bin/env python
+
+# Reader for the columnar binary statistics written with
+# --stats-binary-file (see src/base/stats/binary.hh for the format).
+#
+# As a module:
+#   import stats_binary
+#   for tick, dump in stats_binary.load("m5out/stats.bin"):
+#       print(tick, dump["system.cpu.numCycles"])
+#
+# From the shell, dumps are printed one per line as CSV, optionally
+# restricted to the stats whose names contain one of the given strings:
+#   stats_binary.py m5out/stats.bin system.cpu.ipc system.cpu.committed
+
+from __future__ import print_function
+
+import struct
+import sys
+
+MAGIC = b"gem5stb\0"
+VERSION = 1
+
+def _varint(buf, pos):
+    result = 0
+    shift = 0
+    while True:
+        b = bytearray(buf[pos:pos + 1])[0]
+        pos += 1
+        result |= (b & 0x7f) << shift
+        if not b & 0x80:
+            return result, pos
+        shift += 7
+
+def _records(f):
+    header = f.read(12)
+    if len(header) != 12 or header[:8] != MAGIC:
+        raise ValueError("%s is not a binary stats file" % f.name)
+    version, = struct.unpack("<I", header[8:])
+    if version != VERSION:
+        raise ValueError("unsupported binary stats version %d" % version)
+
+    while True:
+        header = f.read(13)
+        if not header:
+            return
+        if len(header) != 13:
+            raise ValueError("truncated record header")
+        rtype, tick, length = struct.unpack("<cQI", header)
+        payload = f.read(length)
+        if len(payload) != length:
+            raise ValueError("truncated record")
+        yield rtype, tick, payload
+
+def _schema(payload):
+    count, pos = _varint(payload, 0)
+    names = []
+    for i in range(count):
+        length, pos = _varint(payload, pos)
+        names.append(payload[pos:pos + length].decode("utf-8"))
+        pos += length
+    return names
+
+def _dump(payload, last):
+    values = list(last)
+    col = 0
+    pos = 0
+    while pos < len(payload):
+        v, pos = _varint(payload, pos)
+        kind = v & 3
+        if kind == 0:
+            z = v >> 2
+            delta = (z >> 1) ^ -(z & 1)
+            values[col] = float(int(last[col]) + delta)
+            col += 1
+        elif kind == 1:
+            col += (v >> 2) + 1
+        elif kind == 2:
+            values[col], = struct.unpack("<d", payload[pos:pos + 8])
+            pos += 8
+            col += 1
+        else:
+            raise ValueError("bad column tag %d" % v)
+    if col != len(values):
+        raise ValueError("dump has %d columns, schema has %d" %
+                         (col, len(values)))
+    return values
+
+def columns(path):
+    """Yield (tick, names, values) per dump; names is shared between
+    dumps until the schema changes."""
+    names = []
+    last = []
+    with open(path, "rb") as f:
+        for rtype, tick, payload in _records(f):
+            if rtype == b"S":
+                names = _schema(payload)
+                last = [0.0] * len(names)
+            elif rtype == b"D":
+                last = _dump(payload, last)
+                yield tick, names, last
+            else:
+                raise ValueError("unknown record type %r" % rtype)
+
+def load(path):
+    """Yield (tick, {name: value}) per dump."""
+    for tick, names, values in columns(path):
+        yield tick, dict(zip(names, values))
+
+def main():
+    if len(sys.argv) < 2:
+        print("usage: %s <stats.bin> [stat-substring ...]" % sys.argv[0])
+        sys.exit(1)
+
+    wanted = sys.argv[2:]
+    header = None
+    for tick, names, values in columns(sys.argv[1]):
+        sel = [i for i, n in enumerate(names)
+               if not wanted or any(w in n for w in wanted)]
+        if header != names:
+            header = names
+            print(",".join(["tick"] + [names[i] for i in sel]))
+        print(",".join([str(tick)] + ["%.17g" % values[i] for i in sel]))
+
+if __name__ == "__main__":
+    main()